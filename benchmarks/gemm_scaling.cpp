@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <modularml>
+
+/**
+ * Times TensorOperations<float>::gemm of the backend the library was built
+ * with, on the GEMMs of the convolutions (after im2col) and of the fully
+ * connected layers of AlexNet, for 1, 2, 4, ... threads, and prints the
+ * speedup over a single thread.
+ *
+ * Usage: modularml_gemm_scaling [max threads]
+ *
+ * The maximum defaults to the number of hardware threads. For numbers that
+ * can be compared across runs, set MML_PIN_THREADS=1 or run under taskset,
+ * and give one socket worth of cores at most.
+ */
+
+namespace {
+
+struct Shape3 {
+  const char *name;
+  int M;
+  int N;
+  int K;
+};
+
+const Shape3 SHAPES[] = {
+    {"conv1", 96, 3025, 363},   {"conv2", 256, 729, 2400},
+    {"conv3", 384, 169, 2304},  {"conv4", 384, 169, 3456},
+    {"conv5", 256, 169, 3456},  {"fc6", 1, 4096, 9216},
+    {"fc7", 1, 4096, 4096},     {"deep", 4, 4, 1 << 20},
+};
+
+constexpr int REPEATS = 5;
+
+// Helper returning the fastest of a few runs in seconds, after a warm up
+double best_time(const Shape3 &s, std::shared_ptr<Tensor<float>> a,
+                 std::shared_ptr<Tensor<float>> b,
+                 std::shared_ptr<Tensor<float>> c) {
+  TensorOperations<float>::gemm(0, 0, s.M, s.N, s.K, 1, 0, a, s.K, b, s.N, c,
+                                s.N);
+  double best = 1e30;
+  for (int r = 0; r < REPEATS; r++) {
+    auto start = std::chrono::steady_clock::now();
+    TensorOperations<float>::gemm(0, 0, s.M, s.N, s.K, 1, 0, a, s.K, b, s.N,
+                                  c, s.N);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  size_t max_threads = argc > 1 ? std::stoul(argv[1])
+                                : std::thread::hardware_concurrency();
+  max_threads = std::max<size_t>(max_threads, 1);
+
+  std::vector<size_t> thread_counts;
+  for (size_t t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+  thread_counts.push_back(max_threads);
+
+  std::printf("%-6s %5s %5s %8s %8s %10s %10s %8s\n", "layer", "M", "N", "K",
+              "threads", "ms", "GFLOP/s", "speedup");
+  for (const Shape3 &s : SHAPES) {
+    auto a = std::make_shared<Tensor<float>>(
+        array_mml<size_t>{static_cast<size_t>(s.M), static_cast<size_t>(s.K)},
+        ArrayUtils::generate_random_array_mml_real<float>(
+            s.M * s.K, s.M * s.K, -1, 1));
+    auto b = std::make_shared<Tensor<float>>(
+        array_mml<size_t>{static_cast<size_t>(s.K), static_cast<size_t>(s.N)},
+        ArrayUtils::generate_random_array_mml_real<float>(
+            s.K * s.N, s.K * s.N, -1, 1));
+    auto c = std::make_shared<Tensor<float>>(
+        array_mml<size_t>{static_cast<size_t>(s.M), static_cast<size_t>(s.N)});
+
+    const double flops = 2.0 * s.M * s.N * s.K;
+    double single = 0;
+    for (size_t threads : thread_counts) {
+      Parallel::set_num_threads(threads);
+      double seconds = best_time(s, a, b, c);
+      if (threads == 1) single = seconds;
+      std::printf("%-6s %5d %5d %8d %8zu %10.3f %10.1f %7.2fx\n", s.name, s.M,
+                  s.N, s.K, threads, seconds * 1e3, flops / seconds * 1e-9,
+                  single / seconds);
+    }
+  }
+  return 0;
+}
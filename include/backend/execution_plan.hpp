@@ -0,0 +1,166 @@
+#pragma once
+
+#include "nodes/a_node.hpp"
+
+/**
+ * @class ExecutionPlan
+ * @brief A compiled, flat schedule of the nodes in a model graph.
+ *
+ * The plan is built once from the nodes of a model. It topologically sorts the
+ * graph and resolves every tensor name to a dense integer slot, so running
+ * inference only has to walk a flat list of steps without rebuilding any graph
+ * bookkeeping.
+ */
+class ExecutionPlan {
+ public:
+  /**
+   * @struct Step
+   * @brief A single node invocation together with its resolved tensor slots.
+   */
+  struct Step {
+    std::shared_ptr<Node> node;   // The node to run.
+    std::vector<size_t> inputs;   // Slots of the inputs of the node.
+    std::vector<size_t> outputs;  // Slots of the outputs of the node.
+  };
+
+  /**
+   * @struct Lifetime
+   * @brief The layers in which an intermediate tensor is alive.
+   *
+   * The tensor is produced in first_layer and last read in last_layer, so it
+   * can be released once last_layer has finished.
+   */
+  struct Lifetime {
+    size_t first_layer;
+    size_t last_layer;
+  };
+
+  /**
+   * @brief Default constructor for ExecutionPlan.
+   *
+   * Creates an empty plan without any steps.
+   */
+  ExecutionPlan() = default;
+
+  /**
+   * @brief Compiles an execution plan from the nodes of a graph.
+   *
+   * @param nodes The nodes of the graph, in any order.
+   * @param initializers The names of the tensors that are known before
+   * inference starts (weights and constants).
+   * @param inputs The names of the graph inputs.
+   * @param outputs The names of the graph outputs.
+   * @throws std::runtime_error If the graph has no nodes or contains a cycle.
+   */
+  ExecutionPlan(const std::vector<std::shared_ptr<Node>> &nodes,
+                const std::vector<std::string> &initializers,
+                const std::vector<std::string> &inputs,
+                const std::vector<std::string> &outputs);
+
+  /**
+   * @brief Get the steps of the plan in execution order.
+   *
+   * @return The steps of the plan.
+   */
+  const std::vector<Step> &getSteps() const;
+
+  /**
+   * @brief Get the topological layers of the plan.
+   *
+   * Layer i consists of the steps in the range [offsets[i], offsets[i + 1]).
+   * The nodes within a layer do not depend on each other.
+   *
+   * @return The offsets of the layers into the steps, with a trailing entry
+   * equal to the number of steps.
+   */
+  const std::vector<size_t> &getLayerOffsets() const;
+
+  /**
+   * @brief Get the number of tensor slots used by the plan.
+   *
+   * @return The number of slots.
+   */
+  size_t getNumSlots() const;
+
+  /**
+   * @brief Get the tensor name that a slot was resolved from.
+   *
+   * @param slot The slot index.
+   * @return The name of the tensor.
+   */
+  const std::string &getSlotName(size_t slot) const;
+
+  /**
+   * @brief Look up the slot of a tensor name.
+   *
+   * @param name The name of the tensor.
+   * @return The slot of the tensor, or std::nullopt if the plan does not use
+   * it.
+   */
+  std::optional<size_t> findSlot(const std::string &name) const;
+
+  /**
+   * @brief Get the slots of the graph inputs.
+   *
+   * @return The slots of the graph inputs.
+   */
+  const std::vector<size_t> &getInputSlots() const;
+
+  /**
+   * @brief Get the slots of the graph outputs.
+   *
+   * @return The slots of the graph outputs.
+   */
+  const std::vector<size_t> &getOutputSlots() const;
+
+  /**
+   * @brief Get the lifetime of a tensor.
+   *
+   * Only intermediates have a lifetime, graph inputs, initializers and graph
+   * outputs have to outlive the whole inference.
+   *
+   * @param slot The slot index.
+   * @return The lifetime of the tensor, or std::nullopt if it is not an
+   * intermediate.
+   */
+  const std::optional<Lifetime> &getLifetime(size_t slot) const;
+
+  /**
+   * @brief Get the intermediates that are no longer needed after a layer.
+   *
+   * @param layer The layer index.
+   * @return The slots of the intermediates last read in the layer.
+   */
+  const std::vector<size_t> &getReleases(size_t layer) const;
+
+ private:
+  // Steps in execution order
+  std::vector<Step> steps;
+
+  // Offsets of the topological layers into the steps
+  std::vector<size_t> layer_offsets;
+
+  // Tensor names indexed by slot and the reverse lookup
+  std::vector<std::string> slot_names;
+  std::unordered_map<std::string, size_t> slot_lookup;
+
+  // Slots of the graph inputs and outputs
+  std::vector<size_t> input_slots;
+  std::vector<size_t> output_slots;
+
+  // Lifetimes of the intermediates indexed by slot, and the intermediates
+  // released after each layer
+  std::vector<std::optional<Lifetime>> lifetimes;
+  std::vector<std::vector<size_t>> layer_releases;
+
+  // Helper std::function returning the slot of a name, adding it if missing
+  size_t resolveSlot(const std::string &name);
+
+  // Helper std::function computing the lifetimes of the intermediates
+  void computeLifetimes(const std::vector<std::string> &initializers);
+
+  // Helper std::function to do topological sort, returns layers of node
+  // indices
+  static std::vector<std::vector<size_t>> topologicalSort(
+      const std::vector<std::shared_ptr<Node>> &nodes);
+};
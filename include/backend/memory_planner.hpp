@@ -0,0 +1,82 @@
+#pragma once
+
+#include "backend/execution_plan.hpp"
+
+/**
+ * @class MemoryPlanner
+ * @brief Static placement of the intermediate tensors of a plan in one arena.
+ *
+ * Every intermediate tensor gets an offset into a single buffer. Two tensors
+ * only share memory if their lifetimes do not overlap, so the memory of a
+ * tensor is reused as soon as the layer of its last consumer has finished.
+ * Offsets are placed greedily, largest tensor first, into the smallest gap
+ * that fits.
+ */
+class MemoryPlanner {
+ public:
+  /**
+   * @struct Allocation
+   * @brief The placement of one intermediate tensor in the arena.
+   */
+  struct Allocation {
+    size_t slot;    // The slot of the tensor in the execution plan.
+    size_t offset;  // The byte offset of the tensor in the arena.
+    size_t bytes;   // The size of the tensor in bytes, padded to alignment.
+  };
+
+  /**
+   * @brief Default constructor for MemoryPlanner.
+   *
+   * Creates an empty memory plan.
+   */
+  MemoryPlanner() = default;
+
+  /**
+   * @brief Plans the arena of the intermediates of an execution plan.
+   *
+   * @param plan The execution plan providing the lifetimes of the tensors.
+   * @param slot_bytes The size in bytes of each slot of the plan. Slots with a
+   * size of zero or without a lifetime are left out of the arena.
+   */
+  MemoryPlanner(const ExecutionPlan &plan,
+                const std::vector<size_t> &slot_bytes);
+
+  /**
+   * @brief Get the placements of the planned tensors.
+   *
+   * @return The allocations, ordered by slot.
+   */
+  const std::vector<Allocation> &getAllocations() const;
+
+  /**
+   * @brief Get the size of the arena needed for the plan.
+   *
+   * @return The planned peak activation footprint in bytes.
+   */
+  size_t getPeakBytes() const;
+
+  /**
+   * @brief Get the memory the planned tensors would use without any reuse.
+   *
+   * @return The sum of the sizes of the planned tensors in bytes.
+   */
+  size_t getNaiveBytes() const;
+
+  /**
+   * @brief Get the alignment of the offsets in the arena.
+   *
+   * @return The alignment in bytes.
+   */
+  static constexpr size_t getAlignment() {
+#ifdef ALIGN_TENSORS
+    return MEMORY_ALIGNMENT;
+#else
+    return alignof(std::max_align_t);
+#endif
+  }
+
+ private:
+  std::vector<Allocation> allocations;
+  size_t peak_bytes = 0;
+  size_t naive_bytes = 0;
+};
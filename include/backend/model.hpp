@@ -1,8 +1,11 @@
 #pragma once
 
-#include <queue>
+#include <mutex>
 
+#include "backend/execution_plan.hpp"
+#include "backend/memory_planner.hpp"
 #include "nodes/a_node.hpp"
+#include "utility/thread_pool.hpp"
 
 /**
  * @class Model
@@ -41,11 +44,69 @@ class Model {
    *
    * @param node A shared pointer to a Node object to be added to the graph.
    */
-  void addNode(std::shared_ptr<Node> node) { nodes.push_back(std::move(node)); }
+  void addNode(std::shared_ptr<Node> node) {
+    nodes.push_back(std::move(node));
+    plan.reset();
+  }
+
+  /**
+   * @brief Compiles the execution plan of the graph.
+   *
+   * Sorts the graph and resolves the tensors used by every node to slots once,
+   * so that subsequent calls to infer do not have to do any graph work or look
+   * up any tensor by name. Called
+   * automatically by infer if the graph changed since the last compilation.
+   *
+   * @throws std::runtime_error If the graph has no nodes or contains a cycle.
+   */
+  void compile();
+
+  /**
+   * @brief Get the compiled execution plan of the graph.
+   *
+   * @return The execution plan, compiling it first if needed.
+   */
+  const ExecutionPlan &getPlan();
+
+  /**
+   * @brief Get the memory plan of the intermediate tensors.
+   *
+   * The plan is made from the tensors of the first inference, and redone
+   * whenever the shapes of the inputs change. Subsequent inferences place the
+   * intermediates in one preallocated arena.
+   *
+   * @return The memory plan, or std::nullopt if no inference has run yet.
+   */
+  const std::optional<MemoryPlanner> &getMemoryPlan() const;
+
+  /**
+   * @brief Sets the number of threads running independent nodes at once.
+   *
+   * The nodes of a topological layer do not depend on each other, so with
+   * more than one thread they are dispatched to a thread pool and the layer
+   * finishes when all of them have. One thread runs every node on the calling
+   * thread, which is the default.
+   *
+   * @param num_threads The number of inter-op threads, at least one.
+   */
+  void setInterOpThreads(size_t num_threads);
+
+  /**
+   * @brief Get the number of threads running independent nodes at once.
+   *
+   * @return The number of inter-op threads.
+   */
+  size_t getInterOpThreads() const;
 
   /**
    * @brief Runs inference on the graph.
    *
+   * Progress is reported through the Logger at the Trace level, and a node
+   * that throws is reported at the Error level before the error is rethrown.
+   * Every inference runs on its own tensor table and arena, so infer may be
+   * called from several threads at once. Changing the graph or the inter-op
+   * threads must not overlap with an inference.
+   *
    * @param tensor A reference to the input data for inference.
    * @return GeneralDataTypes The result of the inference.
    */
@@ -63,6 +124,59 @@ class Model {
   std::vector<std::string> inputs;
   std::vector<std::string> outputs;
 
-  // Helper std::function to do topological sort
-  std::vector<std::vector<std::shared_ptr<Node>>> topologicalSort();
+  // Compiled schedule of the nodes, empty until compile is called
+  std::optional<ExecutionPlan> plan;
+
+  // The initializers placed in their slots, copied into the tensor table at
+  // the start of every inference
+  TensorTable initializer_table;
+
+  // The shape and element type of an intermediate, the tensor in type holds
+  // no data and only selects the alternative of the variant
+  struct SlotLayout {
+    array_mml<size_t> shape;
+    GeneralDataTypes type;
+    size_t bytes = 0;
+  };
+
+  // Guards the plans and the idle arenas, which concurrent inferences share
+  std::mutex plan_mutex;
+
+  // Plan of the intermediates in an arena, made from the layouts recorded
+  // during the first inference for the given input shapes
+  std::optional<MemoryPlanner> memory_plan;
+  std::vector<SlotLayout> slot_layouts;
+  std::vector<array_mml<size_t>> planned_input_shapes;
+
+  // Arenas of the memory plan no inference is using, an inference takes one
+  // and gives it back when no tensor is left in it
+  std::vector<std::shared_ptr<std::byte[]>> idle_arenas;
+
+  // Counts the memory plans, so an arena of an older one is not given back
+  size_t memory_generation = 0;
+
+  // Pool running the nodes of a layer in parallel, empty when single threaded
+  std::shared_ptr<ThreadPool> inter_op_pool;
+
+  // Helper std::function running one node, reporting the node if it throws
+  static void runNode(size_t node_idx, const ExecutionPlan::Step &step,
+                      TensorTable &table);
+
+  // Helper std::function running the steps [begin, end) of a layer on the
+  // inter-op pool
+  void runLayerParallel(size_t begin, size_t end, TensorTable &table);
+
+  // Helper std::function taking an idle arena or allocating a new one, called
+  // with plan_mutex held
+  std::shared_ptr<std::byte[]> takeArena();
+
+  // Helper std::function placing the planned intermediates in the arena,
+  // called with plan_mutex held
+  void seedArena(TensorTable &table,
+                 const std::shared_ptr<std::byte[]> &arena) const;
+
+  // Helper std::function making the memory plan from the recorded layouts,
+  // called with plan_mutex held
+  void planMemory(std::vector<SlotLayout> layouts,
+                  const std::vector<array_mml<size_t>> &input_shapes);
 };
\ No newline at end of file
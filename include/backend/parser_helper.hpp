@@ -48,13 +48,22 @@ inline std::shared_ptr<Tensor<T>> handle_tensor(const nlohmann::json &init) {
       fieldName = "int8Data";
     else if constexpr (std::is_same_v<T, bool>)
       fieldName = "boolData";
+    else if constexpr (is_half_v<T>)
+      fieldName = "int32Data";
     else
       fieldName = "unknownData";
 
     if (init.contains(fieldName)) {
       std::vector<T> data;
       for (const auto &el : init[fieldName]) {
-        if (el.is_number()) {
+        if constexpr (is_half_v<T>) {
+          // ONNX keeps the bits of every 16-bit float in an int32
+          T value;
+          value.bits = static_cast<uint16_t>(
+              el.is_string() ? std::stoi(el.get<std::string>())
+                             : el.get<int>());
+          data.push_back(value);
+        } else if (el.is_number()) {
           data.push_back(el.get<T>());
         } else if (el.is_string()) {
           if constexpr (std::is_same_v<T, bool>) {
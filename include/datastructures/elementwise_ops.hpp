@@ -0,0 +1,212 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+
+/**
+ * @file elementwise_ops.hpp
+ * @brief Functors for TensorOperations::elementwise and
+ * TensorOperations::broadcast.
+ *
+ * A functor is applied per element through its call operator. A functor may
+ * also have an `apply(const T *in, T *out, size_t n)` member, which
+ * TensorOperations::elementwise calls on a whole contiguous chunk instead, so
+ * that it can use the vector instructions the library was built with. The
+ * float chunks of the transcendental functors go through SimdMath, and so
+ * follow its accuracy tier.
+ *
+ * The binary functors at the end of the file take two elements, and are
+ * simple enough for the compiler to vectorise the broadcast loops.
+ */
+
+/**
+ * @struct ReluOp
+ * @brief max(x, 0).
+ */
+struct ReluOp {
+  template <typename T>
+  T operator()(T x) const {
+    return x > 0 ? x : 0;
+  }
+
+  /**
+   * @brief Apply the functor to a contiguous chunk of floats.
+   *
+   * @param in The first input element.
+   * @param out The first output element, may be the same as in.
+   * @param n The number of elements.
+   */
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct LeakyReluOp
+ * @brief x for positive x, alpha * x otherwise.
+ */
+struct LeakyReluOp {
+  float alpha;
+
+  template <typename T>
+  T operator()(T x) const {
+    return x < 0 ? static_cast<T>(alpha * x) : x;
+  }
+
+  /**
+   * @brief Apply the functor to a contiguous chunk of floats.
+   *
+   * @param in The first input element.
+   * @param out The first output element, may be the same as in.
+   * @param n The number of elements.
+   */
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct SigmoidOp
+ * @brief 1 / (1 + e^-x).
+ */
+struct SigmoidOp {
+  template <typename T>
+  T operator()(T x) const {
+    return 1 / (1 + std::exp(-x));
+  }
+
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct TanhOp
+ * @brief tanh(x).
+ */
+struct TanhOp {
+  template <typename T>
+  T operator()(T x) const {
+    return std::tanh(x);
+  }
+
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct SwishOp
+ * @brief x * sigmoid(x).
+ */
+struct SwishOp {
+  template <typename T>
+  T operator()(T x) const {
+    return x * (static_cast<T>(1) / (static_cast<T>(1) + std::exp(-x)));
+  }
+
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct EluOp
+ * @brief x for positive x, alpha * (e^x - 1) otherwise.
+ */
+struct EluOp {
+  float alpha;
+
+  template <typename T>
+  T operator()(T x) const {
+    return x < 0 ? static_cast<T>(alpha * (std::exp(x) - 1)) : x;
+  }
+
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct GeluOp
+ * @brief 0.5 * x * (1 + erf(x / sqrt(2))).
+ */
+struct GeluOp {
+  template <typename T>
+  T operator()(T x) const {
+    return static_cast<T>(0.5f * x * (1.0f + std::erf(x / std::sqrt(2.0f))));
+  }
+
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct GeluTanhOp
+ * @brief The tanh approximation of GeluOp,
+ * 0.5 * x * (1 + tanh(sqrt(2 / pi) * (x + 0.044715 * x^3))).
+ */
+struct GeluTanhOp {
+  template <typename T>
+  T operator()(T x) const {
+    return static_cast<T>(
+        0.5f * x *
+        (1.0f + std::tanh(std::sqrt(2.0f / M_PI) *
+                          (x + 0.044715f * std::pow(x, 3.0f)))));
+  }
+
+  void apply(const float *in, float *out, size_t n) const;
+};
+
+/**
+ * @struct AddOp
+ * @brief a + b.
+ */
+struct AddOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return a + b;
+  }
+};
+
+/**
+ * @struct SubOp
+ * @brief a - b.
+ */
+struct SubOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return a - b;
+  }
+};
+
+/**
+ * @struct MulOp
+ * @brief a * b.
+ */
+struct MulOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return a * b;
+  }
+};
+
+/**
+ * @struct DivOp
+ * @brief a / b.
+ */
+struct DivOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return a / b;
+  }
+};
+
+/**
+ * @struct MaxOp
+ * @brief The larger of a and b.
+ */
+struct MaxOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return a < b ? b : a;
+  }
+};
+
+/**
+ * @struct MinOp
+ * @brief The smaller of a and b.
+ */
+struct MinOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return b < a ? b : a;
+  }
+};
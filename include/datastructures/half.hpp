@@ -0,0 +1,159 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * @file half.hpp
+ * @brief 16-bit floating point storage types.
+ *
+ * Neither type does arithmetic of its own. Every element converts to float
+ * when it is read and rounds to nearest even when it is written, so they are
+ * meant for storing weights and activations at half the size. The array
+ * conversions at the end use F16C or AVX-512 when the library is built with
+ * them.
+ */
+
+/**
+ * @struct fp16_t
+ * @brief IEEE 754 half precision, ONNX FLOAT16: 1 sign, 5 exponent and 10
+ * mantissa bits.
+ */
+struct fp16_t {
+  uint16_t bits = 0;
+
+  fp16_t() = default;
+
+  fp16_t(float value) : bits(from_float(value)) {}
+
+  operator float() const { return to_float(bits); }
+
+  /**
+   * @brief Round a float to the nearest half, the ties to even.
+   *
+   * Values too large for a half become infinity, NaN stays NaN.
+   */
+  static uint16_t from_float(float value) {
+    // Scaling by 2^112 and then 2^-110 lets the FPU do the rounding of the
+    // mantissa, including into the subnormal range and up to infinity
+    const float scale_to_inf = 0x1.0p+112f;
+    const float scale_to_zero = 0x1.0p-110f;
+    float base = (std::fabs(value) * scale_to_inf) * scale_to_zero;
+
+    const uint32_t w = std::bit_cast<uint32_t>(value);
+    const uint32_t shl1_w = w + w;
+    const uint32_t sign = w & 0x80000000u;
+    uint32_t bias = shl1_w & 0xFF000000u;
+    if (bias < 0x71000000u) bias = 0x71000000u;
+
+    base = std::bit_cast<float>((bias >> 1) + 0x07800000u) + base;
+    const uint32_t result = std::bit_cast<uint32_t>(base);
+    const uint32_t exp_bits = (result >> 13) & 0x00007C00u;
+    const uint32_t mantissa_bits = result & 0x00000FFFu;
+    const uint32_t nonsign = exp_bits + mantissa_bits;
+    return static_cast<uint16_t>((sign >> 16) |
+                                 (shl1_w > 0xFF000000u ? 0x7E00u : nonsign));
+  }
+
+  /**
+   * @brief Widen a half to a float, which is exact.
+   */
+  static float to_float(uint16_t half) {
+    const uint32_t w = static_cast<uint32_t>(half) << 16;
+    const uint32_t sign = w & 0x80000000u;
+    const uint32_t two_w = w + w;
+
+    // Normal halves move their exponent into place, subnormal ones are
+    // rebuilt from a float with the mantissa at the bottom
+    const float normalized =
+        std::bit_cast<float>((two_w >> 4) + (0xE0u << 23)) * 0x1.0p-112f;
+    const float denormalized =
+        std::bit_cast<float>((two_w >> 17) | (126u << 23)) - 0.5f;
+    const uint32_t result =
+        sign | (two_w < (1u << 27) ? std::bit_cast<uint32_t>(denormalized)
+                                   : std::bit_cast<uint32_t>(normalized));
+    return std::bit_cast<float>(result);
+  }
+
+  /**
+   * @brief Widen an array of halves.
+   *
+   * @param in The first half.
+   * @param out The first float.
+   * @param n The number of elements.
+   */
+  static void to_float(const fp16_t *in, float *out, size_t n);
+
+  /**
+   * @brief Round an array of floats to halves.
+   *
+   * @param in The first float.
+   * @param out The first half.
+   * @param n The number of elements.
+   */
+  static void from_float(const float *in, fp16_t *out, size_t n);
+};
+
+/**
+ * @struct bf16_t
+ * @brief bfloat16, ONNX BFLOAT16: the upper half of a float, with 8 exponent
+ * and 7 mantissa bits.
+ */
+struct bf16_t {
+  uint16_t bits = 0;
+
+  bf16_t() = default;
+
+  bf16_t(float value) : bits(from_float(value)) {}
+
+  operator float() const { return to_float(bits); }
+
+  /**
+   * @brief Round a float to the nearest bfloat16, the ties to even.
+   *
+   * NaN stays NaN instead of rounding up to infinity.
+   */
+  static uint16_t from_float(float value) {
+    const uint32_t w = std::bit_cast<uint32_t>(value);
+    if ((w & 0x7FFFFFFFu) > 0x7F800000u) {
+      return static_cast<uint16_t>((w >> 16) | 0x0040u);
+    }
+    return static_cast<uint16_t>((w + 0x7FFFu + ((w >> 16) & 1u)) >> 16);
+  }
+
+  /**
+   * @brief Widen a bfloat16 to a float, which is exact.
+   */
+  static float to_float(uint16_t bf16) {
+    return std::bit_cast<float>(static_cast<uint32_t>(bf16) << 16);
+  }
+
+  /**
+   * @brief Widen an array of bfloat16.
+   *
+   * @param in The first bfloat16.
+   * @param out The first float.
+   * @param n The number of elements.
+   */
+  static void to_float(const bf16_t *in, float *out, size_t n);
+
+  /**
+   * @brief Round an array of floats to bfloat16.
+   *
+   * @param in The first float.
+   * @param out The first bfloat16.
+   * @param n The number of elements.
+   */
+  static void from_float(const float *in, bf16_t *out, size_t n);
+};
+
+static_assert(sizeof(fp16_t) == 2 && sizeof(bf16_t) == 2,
+              "16-bit floats must pack into arrays without padding");
+
+// Helper trait for the 16-bit float storage types
+template <typename T>
+inline constexpr bool is_half_v =
+    std::is_same_v<T, fp16_t> || std::is_same_v<T, bf16_t>;
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "datastructures/mml_array.hpp"
+
+/**
+ * @class inline_array
+ * @brief A small array with a fixed capacity that is stored inline, without
+ * any heap allocation.
+ *
+ * It is meant for shapes, strides and index tuples, which are copied and
+ * built in inner loops where an array_mml would allocate every time. It
+ * converts to and from array_mml so it can be passed where one is expected.
+ *
+ * @tparam T The type of the elements.
+ * @tparam N The maximum number of elements.
+ */
+template <typename T, size_t N>
+class inline_array {
+ public:
+  using value_type = T;
+
+  /**
+   * @brief Default constructor, an empty array.
+   */
+  inline_array() = default;
+
+  /**
+   * @brief Constructor for an array of value initialized elements.
+   *
+   * @param size The number of elements.
+   * @throws std::invalid_argument If size exceeds the capacity.
+   */
+  explicit inline_array(size_t size) : d_size(checked_size(size)) {}
+
+  /**
+   * @brief Constructor from a list of elements.
+   *
+   * @param data The elements.
+   * @throws std::invalid_argument If there are more elements than the
+   * capacity.
+   */
+  inline_array(std::initializer_list<T> data)
+      : d_size(checked_size(data.size())) {
+    std::copy(data.begin(), data.end(), this->data);
+  }
+
+  /**
+   * @brief Constructor copying the elements of an array_mml.
+   *
+   * @param other The array to copy.
+   * @throws std::invalid_argument If there are more elements than the
+   * capacity.
+   */
+  inline_array(const array_mml<T> &other) : d_size(checked_size(other.size())) {
+    std::copy(other.begin(), other.end(), this->data);
+  }
+
+  /**
+   * @brief Constructor copying the elements of a vector.
+   *
+   * @param other The vector to copy.
+   * @throws std::invalid_argument If there are more elements than the
+   * capacity.
+   */
+  explicit inline_array(const std::vector<T> &other)
+      : d_size(checked_size(other.size())) {
+    std::copy(other.begin(), other.end(), this->data);
+  }
+
+  /**
+   * @brief Copy the elements into a new array_mml.
+   *
+   * @return The array_mml with the same elements.
+   */
+  operator array_mml<T>() const {
+    array_mml<T> array(d_size);
+    std::copy(begin(), end(), array.begin());
+    return array;
+  }
+
+  /**
+   * @brief Get the number of elements.
+   *
+   * @return The number of elements.
+   */
+  size_t size() const { return d_size; }
+
+  /**
+   * @brief Get the maximum number of elements.
+   *
+   * @return The capacity of the array.
+   */
+  static constexpr size_t capacity() { return N; }
+
+  /**
+   * @brief Access an element, without bounds checking.
+   *
+   * @param index The index of the element.
+   * @return A reference to the element.
+   */
+  T &operator[](size_t index) { return data[index]; }
+
+  /**
+   * @brief Access an element, without bounds checking.
+   *
+   * @param index The index of the element.
+   * @return A reference to the element.
+   */
+  const T &operator[](size_t index) const { return data[index]; }
+
+  /**
+   * @brief Access an element, for indices that come from the input.
+   *
+   * @param index The index of the element.
+   * @return A reference to the element.
+   * @throws std::out_of_range If the index is not below the size.
+   */
+  T &at(size_t index) { return data[checked_index(index)]; }
+
+  /**
+   * @brief Access an element, for indices that come from the input.
+   *
+   * @param index The index of the element.
+   * @return A reference to the element.
+   * @throws std::out_of_range If the index is not below the size.
+   */
+  const T &at(size_t index) const { return data[checked_index(index)]; }
+
+  /**
+   * @brief Append an element.
+   *
+   * @param value The element to append.
+   * @throws std::invalid_argument If the array is full.
+   */
+  void push_back(const T &value) {
+    checked_size(d_size + 1);
+    data[d_size++] = value;
+  }
+
+  /**
+   * @brief Set every element to a value.
+   *
+   * @param value The value to set.
+   */
+  void fill(const T &value) { std::fill(begin(), end(), value); }
+
+  T *begin() { return data; }
+  const T *begin() const { return data; }
+  T *end() { return data + d_size; }
+  const T *end() const { return data + d_size; }
+  T *get() { return data; }
+  const T *get() const { return data; }
+
+  bool operator==(const inline_array &other) const {
+    return std::equal(begin(), end(), other.begin(), other.end());
+  }
+
+  bool operator==(const array_mml<T> &other) const {
+    return std::equal(begin(), end(), other.begin(), other.end());
+  }
+
+  /**
+   * @brief Get the elements as a string, formatted like array_mml.
+   *
+   * @return The string representation of the array.
+   */
+  std::string to_string() const {
+    std::string result = "[";
+    for (size_t i = 0; i < d_size; i++) {
+      result += std::to_string(data[i]);
+      if (i < d_size - 1) result += ", ";
+    }
+    return result + "]";
+  }
+
+  friend std::ostream &operator<<(std::ostream &os, const inline_array &arr) {
+    os << arr.to_string();
+    return os;
+  }
+
+ private:
+  T data[N] = {};
+  size_t d_size = 0;
+
+  // Helper to reject sizes beyond the capacity
+  static size_t checked_size(size_t size) {
+    if (size > N) {
+      throw std::invalid_argument(
+          "inline_array: size exceeds the capacity of " + std::to_string(N));
+    }
+    return size;
+  }
+
+  // Helper to reject indices past the size
+  size_t checked_index(size_t index) const {
+    if (index >= d_size) {
+      throw std::out_of_range("Invalid inline_array index: " +
+                              std::to_string(index) +
+                              ". Array size: " + std::to_string(d_size));
+    }
+    return index;
+  }
+};
+
+/// The highest rank of a tensor.
+constexpr size_t MAX_TENSOR_RANK = 8;
+
+/// A shape, the strides or an index tuple of a tensor.
+using Shape = inline_array<size_t, MAX_TENSOR_RANK>;
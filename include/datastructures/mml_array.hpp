@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
 #include <functional>
@@ -24,6 +25,14 @@
 
 /// @brief Array class mimicking the std::array class but without the size being
 /// a template parameter.
+///
+/// Copies share the buffer until one of them is accessed through a non-const
+/// method, which first gives that array its own buffer, so copying is cheap
+/// when the copy is only read. Buffers that were passed in, or handed out as
+/// a pointer by a non-const begin, end, get or get_shared, may be written in
+/// place by others at any time, so they are never shared this way and copying
+/// them copies the data. As with any write, a non-const access must not race
+/// with other access to the same array.
 /// @tparam T the type of the array.
 template <typename T>
 class array_mml {
@@ -75,9 +84,10 @@ class array_mml {
   /// @brief Move assignment operator.
   /// @param other The array to std::move.
   /// @return The moved array.
-  array_mml &operator=(array_mml &&other) noexcept = default;
+  array_mml &operator=(array_mml &&other) noexcept;
 
-  /// @brief Copy assignment operator.
+  /// @brief Copy assignment operator, a buffer that others write to in place
+  /// is overwritten when the sizes match, otherwise the buffer is shared.
   /// @param other The array to std::copy.
   /// @return The copied array.
   array_mml &operator=(const array_mml &other);
@@ -106,7 +116,8 @@ class array_mml {
     return os;
   }
 
-  /// @brief Get an iterator to the beginning of the array.
+  /// @brief Get an iterator to the beginning of the array. Writes through it
+  /// are visible in this array, so copies made afterwards copy the data.
   /// @return An iterator to the beginning of the array.
   T *begin();
 
@@ -114,7 +125,7 @@ class array_mml {
   /// @return A const iterator to the beginning of the array.
   const T *begin() const;
 
-  /// @brief Get an iterator to the end of the array.
+  /// @brief Get an iterator to the end of the array, see begin.
   /// @return An iterator to the end of the array.
   T *end();
 
@@ -122,7 +133,7 @@ class array_mml {
   /// @return A const iterator to the end of the array.
   const T *end() const;
 
-  /// @brief Get a pointer to the underlying data.
+  /// @brief Get a pointer to the underlying data, see begin.
   /// @return A pointer to the underlying data.
   T *get();
 
@@ -130,6 +141,18 @@ class array_mml {
   /// @return A const pointer to the underlying data.
   const T *get() const;
 
+  /// @brief Get the shared pointer owning the underlying data, without
+  /// copying it. Writes through the pointer are visible in this array, so
+  /// copies of the array made afterwards copy the data.
+  /// @return The shared pointer to the underlying data.
+  std::shared_ptr<T[]> get_shared();
+
+  /// @brief Get the shared pointer owning the underlying data, without
+  /// copying it. The buffer might be shared with copies of this array, so the
+  /// data can only be read through it.
+  /// @return The shared pointer to the underlying data.
+  std::shared_ptr<const T[]> get_shared() const;
+
   /// @brief Fill the array with a given value.
   /// @param value The value to fill the array with.
   void fill(const T &value);
@@ -137,6 +160,17 @@ class array_mml {
  private:
   std::shared_ptr<T[]> data;
   size_t d_size;
+  // The buffer is written in place by others and is never shared with copies
+  bool aliased = false;
+  // The buffer might be shared with copies of this array
+  mutable std::atomic<bool> shared = false;
+
+  // Helper to give this array its own buffer before it is written to
+  void detach(bool keep_data = true);
+
+  // Helper handing out the buffer for writes in place, after which copies of
+  // this array copy the data
+  T *escape();
 };
 
 #define _ARRAY_MML(DT) template class array_mml<DT>;
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @class PackedGemm
+ * @brief A cache-blocked GEMM on packed panels, for row-major float and
+ * double matrices.
+ *
+ * The loops follow BLIS. B is packed NC columns and KC rows at a time into
+ * panels NR columns wide, and A is packed MC rows and KC columns at a time
+ * into panels MR rows high. A microkernel then keeps a whole MR x NR tile of
+ * C in vector registers while it streams one panel of each, so every element
+ * loaded is used MR or NR times. The panels are zero padded, so the kernel
+ * never branches on the edges of the matrices. Edge tiles go through a small
+ * buffer, and only their valid part is written back to C. A transposed A
+ * or B is transposed by the packing, so it is never copied as a whole.
+ *
+ * A C of fewer rows than a tile skips the packing: a K x N B is streamed
+ * once for all rows, and the rows of a transposed B, contiguous along K like
+ * the rows of A, are multiplied as dot products.
+ *
+ * The tile and block sizes depend on the vector instructions the library is
+ * built with, or in the dispatch build on the ones CpuFeatures selects:
+ *
+ * | Build    | float MR x NR | double MR x NR | KC (float, double) |
+ * |----------|---------------|----------------|--------------------|
+ * | AVX-512  | 12 x 32       | 12 x 16        | 256, 128           |
+ * | AVX2+FMA | 6 x 16        | 6 x 8          | 256, 128           |
+ * | other    | 4 x 4         | 4 x 4          | 256, 128           |
+ *
+ * MC is 12 panels of A and NC is 4096 columns.
+ *
+ * A call runs on the calling thread. TensorOperations::gemm splits C with
+ * GemmPartition and hands every block to its own call.
+ *
+ * @tparam T float or double.
+ */
+template <typename T>
+class PackedGemm {
+ public:
+  PackedGemm() = delete;  // Prevent instantiation of this class
+
+  /**
+   * @brief C = ALPHA * op(A) * op(B) + BETA * C.
+   *
+   * @param TA Whether A is stored transposed, as K x M.
+   * @param TB Whether B is stored transposed, as N x K.
+   * @param M The number of rows of op(A) and C.
+   * @param N The number of columns of op(B) and C.
+   * @param K The number of columns of op(A) and rows of op(B).
+   * @param ALPHA The factor of op(A) * op(B).
+   * @param A The matrix A, as stored.
+   * @param lda The row stride of A as stored.
+   * @param B The matrix B, as stored.
+   * @param ldb The row stride of B as stored.
+   * @param BETA The factor of C, which is not read when it is 0.
+   * @param C The M x N output.
+   * @param ldc The row stride of C.
+   */
+  static void gemm(int TA, int TB, int M, int N, int K, T ALPHA, const T *A,
+                   size_t lda, const T *B, size_t ldb, T BETA, T *C,
+                   size_t ldc);
+
+  /**
+   * @brief Get the rows of the register tile, MR.
+   *
+   * @return Blocks of C starting at a multiple of it only have edge tiles
+   * at the bottom of the matrix.
+   */
+  static int tile_rows();
+
+  /**
+   * @brief Get the columns of the register tile, NR.
+   *
+   * @return Blocks of C starting at a multiple of it only have edge tiles
+   * at the right of the matrix.
+   */
+  static int tile_cols();
+};
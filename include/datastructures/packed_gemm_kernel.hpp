@@ -0,0 +1,491 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include "utility/allocator.hpp"
+#include "utility/cpu_features.hpp"
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+/**
+ * @file packed_gemm_kernel.hpp
+ * @brief The kernel of PackedGemm, for the vector instructions the including
+ * translation unit is compiled with.
+ *
+ * Everything is in an anonymous namespace, so the dispatch build can link
+ * the kernel compiled for several instruction sets into one library. For the
+ * same reason the kernel instantiates no template of the standard library,
+ * such as std::min or std::shared_ptr: such an inline function has external
+ * linkage, and the linker could pick the copy compiled for AVX-512 for every
+ * caller. The allocator of the packing buffers is therefore passed in as a
+ * raw pointer. It is not part of <modularml>.
+ */
+
+/**
+ * @brief The packed GEMM of one instruction set with its tile size.
+ *
+ * @tparam T float or double.
+ */
+template <typename T>
+struct PackedGemmKernel {
+  void (*gemm)(int TA, int TB, int M, int N, int K, T ALPHA, const T *A,
+               size_t lda, const T *B, size_t ldb, T BETA, T *C, size_t ldc,
+               Allocator *allocator);
+  int tile_rows;
+  int tile_cols;
+};
+
+/**
+ * @brief Get the packed GEMM of an instruction set. Only the dispatch build
+ * defines it, in the translation unit compiled for that instruction set.
+ *
+ * @tparam T float or double.
+ * @tparam I The instruction set.
+ * @return The kernel.
+ */
+template <typename T, CpuFeatures::Isa I>
+PackedGemmKernel<T> packed_gemm_kernel();
+
+namespace {
+
+// Helpers for the block sizes, see the file comment for why not std::min
+constexpr int min_of(int a, int b) { return a < b ? a : b; }
+constexpr size_t max_of(size_t a, size_t b) { return a < b ? b : a; }
+
+
+// One vector register of T and the few operations the microkernel needs
+template <typename T>
+struct Vector;
+
+#if defined(__AVX512F__)
+// 12 x 2 accumulators leave 8 of the 32 registers for the panel of B and
+// the broadcasts of A
+constexpr CpuFeatures::Isa KERNEL_ISA = CpuFeatures::Isa::AVX512;
+constexpr int MR = 12;
+constexpr int NR_VECTORS = 2;
+
+template <>
+struct Vector<float> {
+  using type = __m512;
+  static constexpr int LANES = 16;
+  static type zero() { return _mm512_setzero_ps(); }
+  static type load(const float *p) { return _mm512_load_ps(p); }
+  static type splat(const float *p) { return _mm512_set1_ps(*p); }
+  static type fmadd(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+  static type loadu(const float *p) { return _mm512_loadu_ps(p); }
+  static type add(type a, type b) { return _mm512_add_ps(a, b); }
+  static void store(float *p, type a) { _mm512_storeu_ps(p, a); }
+};
+
+template <>
+struct Vector<double> {
+  using type = __m512d;
+  static constexpr int LANES = 8;
+  static type zero() { return _mm512_setzero_pd(); }
+  static type load(const double *p) { return _mm512_load_pd(p); }
+  static type splat(const double *p) { return _mm512_set1_pd(*p); }
+  static type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+  static type loadu(const double *p) { return _mm512_loadu_pd(p); }
+  static type add(type a, type b) { return _mm512_add_pd(a, b); }
+  static void store(double *p, type a) { _mm512_storeu_pd(p, a); }
+};
+#elif defined(__AVX2__) && defined(__FMA__)
+// 6 x 2 accumulators, 2 registers of B and a broadcast fill 15 of the 16
+constexpr CpuFeatures::Isa KERNEL_ISA = CpuFeatures::Isa::AVX2;
+constexpr int MR = 6;
+constexpr int NR_VECTORS = 2;
+
+template <>
+struct Vector<float> {
+  using type = __m256;
+  static constexpr int LANES = 8;
+  static type zero() { return _mm256_setzero_ps(); }
+  static type load(const float *p) { return _mm256_load_ps(p); }
+  static type splat(const float *p) { return _mm256_broadcast_ss(p); }
+  static type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+  static type loadu(const float *p) { return _mm256_loadu_ps(p); }
+  static type add(type a, type b) { return _mm256_add_ps(a, b); }
+  static void store(float *p, type a) { _mm256_storeu_ps(p, a); }
+};
+
+template <>
+struct Vector<double> {
+  using type = __m256d;
+  static constexpr int LANES = 4;
+  static type zero() { return _mm256_setzero_pd(); }
+  static type load(const double *p) { return _mm256_load_pd(p); }
+  static type splat(const double *p) { return _mm256_broadcast_sd(p); }
+  static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+  static type loadu(const double *p) { return _mm256_loadu_pd(p); }
+  static type add(type a, type b) { return _mm256_add_pd(a, b); }
+  static void store(double *p, type a) { _mm256_storeu_pd(p, a); }
+};
+#else
+constexpr CpuFeatures::Isa KERNEL_ISA = CpuFeatures::Isa::SCALAR;
+constexpr int MR = 4;
+constexpr int NR_VECTORS = 4;
+
+template <typename T>
+struct ScalarVector {
+  using type = T;
+  static constexpr int LANES = 1;
+  static type zero() { return 0; }
+  static type load(const T *p) { return *p; }
+  static type splat(const T *p) { return *p; }
+  static type fmadd(type a, type b, type c) { return a * b + c; }
+  static type loadu(const T *p) { return *p; }
+  static type add(type a, type b) { return a + b; }
+  static void store(T *p, type a) { *p = a; }
+};
+
+template <>
+struct Vector<float> : ScalarVector<float> {};
+template <>
+struct Vector<double> : ScalarVector<double> {};
+#endif
+
+// Columns of a panel of B, and so of the tile of C the microkernel holds
+template <typename T>
+constexpr int NR = NR_VECTORS * Vector<T>::LANES;
+
+// Depth of the packed panels, a panel of B stays in L1 for all of its uses
+template <typename T>
+constexpr int KC = 1024 / sizeof(T);
+
+// Rows of the packed block of A, which stays in L2 while B streams past it
+constexpr int MC = MR * 12;
+
+// Columns of the packed block of B, which is meant for L3
+constexpr int NC = 4096;
+
+// Panels are read with aligned loads
+constexpr size_t PANEL_ALIGNMENT = 64;
+
+// Helper owning a packing buffer from the given allocator, by default a pool
+// that keeps the blocks of earlier calls for reuse
+template <typename T>
+class PackBuffer {
+ public:
+  PackBuffer(Allocator *allocator, size_t size)
+      : allocator(allocator),
+        bytes(max_of(size, 1) * sizeof(T)),
+        data(static_cast<T *>(allocator->allocate(bytes, PANEL_ALIGNMENT))) {}
+  ~PackBuffer() { allocator->deallocate(data, bytes); }
+  PackBuffer(const PackBuffer &) = delete;
+  PackBuffer &operator=(const PackBuffer &) = delete;
+
+  T *get() const { return data; }
+
+ private:
+  Allocator *allocator;
+  size_t bytes;
+  T *data;
+};
+
+// Copies the rows [row, row + rows) and the columns [col, col + depth) of
+// op(A) into one panel of MR rows, interleaved by column and scaled by ALPHA.
+// The rows past the edge are zero. A transposed A is read along its rows.
+template <typename T>
+void pack_a(const T *A, size_t lda, bool transposed, int row, int rows,
+            int col, int depth, T alpha, T *panel) {
+  const size_t row_stride = transposed ? 1 : lda;
+  const size_t col_stride = transposed ? lda : 1;
+  for (int p = 0; p < depth; p++) {
+    const T *source = A + row * row_stride + (col + p) * col_stride;
+    T *target = panel + static_cast<size_t>(p) * MR;
+    for (int r = 0; r < rows; r++) target[r] = alpha * source[r * row_stride];
+    for (int r = rows; r < MR; r++) target[r] = 0;
+  }
+}
+
+// Copies the rows [row, row + depth) and the columns [col, col + cols) of
+// op(B) into one panel of NR columns, one row of the panel after the other.
+// The columns past the edge are zero.
+template <typename T>
+void pack_b(const T *B, size_t ldb, bool transposed, int row, int depth,
+            int col, int cols, T *panel) {
+  if (transposed) {
+    // A column of the panel is a run of a row of B, so B is read in order
+    for (int j = 0; j < cols; j++) {
+      const T *source = B + static_cast<size_t>(col + j) * ldb + row;
+      for (int p = 0; p < depth; p++) panel[p * NR<T> + j] = source[p];
+    }
+    for (int p = 0; p < depth; p++) {
+      for (int j = cols; j < NR<T>; j++) panel[p * NR<T> + j] = 0;
+    }
+    return;
+  }
+  for (int p = 0; p < depth; p++) {
+    const T *source = B + static_cast<size_t>(row + p) * ldb + col;
+    T *target = panel + static_cast<size_t>(p) * NR<T>;
+    for (int j = 0; j < cols; j++) target[j] = source[j];
+    for (int j = cols; j < NR<T>; j++) target[j] = 0;
+  }
+}
+
+// Adds the product of an MR x depth panel of A and a depth x NR panel of B
+// to BETA times the MR x NR tile of C at c
+template <typename T>
+void micro_kernel(int depth, const T *a, const T *b, T beta, T *c,
+                  size_t ldc) {
+  using V = Vector<T>;
+  typename V::type acc[MR][NR_VECTORS];
+#pragma GCC unroll 16
+  for (int r = 0; r < MR; r++) {
+#pragma GCC unroll 4
+    for (int v = 0; v < NR_VECTORS; v++) acc[r][v] = V::zero();
+  }
+
+  for (int p = 0; p < depth; p++) {
+    typename V::type columns[NR_VECTORS];
+#pragma GCC unroll 4
+    for (int v = 0; v < NR_VECTORS; v++) {
+      columns[v] = V::load(b + v * V::LANES);
+    }
+#pragma GCC unroll 16
+    for (int r = 0; r < MR; r++) {
+      typename V::type x = V::splat(a + r);
+#pragma GCC unroll 4
+      for (int v = 0; v < NR_VECTORS; v++) {
+        acc[r][v] = V::fmadd(x, columns[v], acc[r][v]);
+      }
+    }
+    a += MR;
+    b += NR<T>;
+  }
+
+  // C = acc + BETA * C, where C is not read for a BETA of 0 and the
+  // multiplication is skipped for the usual BETA of 1
+  const typename V::type scale = V::splat(&beta);
+#pragma GCC unroll 16
+  for (int r = 0; r < MR; r++) {
+#pragma GCC unroll 4
+    for (int v = 0; v < NR_VECTORS; v++) {
+      T *target = c + r * ldc + v * V::LANES;
+      if (beta == 1) {
+        acc[r][v] = V::add(acc[r][v], V::loadu(target));
+      } else if (beta != 0) {
+        acc[r][v] = V::fmadd(scale, V::loadu(target), acc[r][v]);
+      }
+      V::store(target, acc[r][v]);
+    }
+  }
+}
+
+// Writes the rows x cols corner of a tile the microkernel left in a buffer
+// to C, in the same way as the microkernel does for a whole tile
+template <typename T>
+void write_tile(const T *tile, int rows, int cols, T beta, T *C, size_t ldc) {
+  for (int r = 0; r < rows; r++) {
+    const T *source = tile + r * NR<T>;
+    T *target = C + r * ldc;
+    if (beta == 0) {
+      for (int j = 0; j < cols; j++) target[j] = source[j];
+    } else if (beta == 1) {
+      for (int j = 0; j < cols; j++) target[j] += source[j];
+    } else {
+      for (int j = 0; j < cols; j++) target[j] = source[j] + beta * target[j];
+    }
+  }
+}
+
+// C[i, j0:j0+NR] for a single row of A, whose elements are a_stride apart,
+// straight from the unpacked B. Too few rows to fill a panel of A are better
+// served by streaming B once.
+template <typename T>
+void row_kernel(int K, T alpha, const T *a, size_t a_stride, const T *B,
+                size_t ldb, int j0, T beta, T *c) {
+  using V = Vector<T>;
+  typename V::type acc[NR_VECTORS];
+#pragma GCC unroll 4
+  for (int v = 0; v < NR_VECTORS; v++) acc[v] = V::zero();
+  for (int k = 0; k < K; k++) {
+    const T x_value = alpha * a[k * a_stride];
+    typename V::type x = V::splat(&x_value);
+    const T *b = B + static_cast<size_t>(k) * ldb + j0;
+#pragma GCC unroll 4
+    for (int v = 0; v < NR_VECTORS; v++) {
+      acc[v] = V::fmadd(x, V::loadu(b + v * V::LANES), acc[v]);
+    }
+  }
+  const typename V::type scale = V::splat(&beta);
+#pragma GCC unroll 4
+  for (int v = 0; v < NR_VECTORS; v++) {
+    T *target = c + j0 + v * V::LANES;
+    if (beta != 0) acc[v] = V::fmadd(scale, V::loadu(target), acc[v]);
+    V::store(target, acc[v]);
+  }
+}
+
+
+
+// C[i, j0:j0+COLS] for a single row of A against COLS rows of a transposed
+// B, as dot products along K, where both are contiguous. The row of A is
+// already scaled by ALPHA.
+template <typename T, int COLS>
+void dot_kernel(int K, const T *a, const T *B, size_t ldb, int j0, T beta,
+                T *c) {
+  using V = Vector<T>;
+  typename V::type acc[COLS];
+#pragma GCC unroll 4
+  for (int j = 0; j < COLS; j++) acc[j] = V::zero();
+  const int k_end = K - K % V::LANES;
+  for (int k = 0; k < k_end; k += V::LANES) {
+    typename V::type x = V::loadu(a + k);
+#pragma GCC unroll 4
+    for (int j = 0; j < COLS; j++) {
+      const T *b = B + static_cast<size_t>(j0 + j) * ldb + k;
+      acc[j] = V::fmadd(x, V::loadu(b), acc[j]);
+    }
+  }
+  for (int j = 0; j < COLS; j++) {
+    alignas(PANEL_ALIGNMENT) T lanes[V::LANES];
+    V::store(lanes, acc[j]);
+    T sum = 0;
+    for (int l = 0; l < V::LANES; l++) sum += lanes[l];
+    const T *b = B + static_cast<size_t>(j0 + j) * ldb;
+    for (int k = k_end; k < K; k++) sum += a[k] * b[k];
+    c[j0 + j] = beta == 0 ? sum : sum + beta * c[j0 + j];
+  }
+}
+
+// Columns of C a dot_kernel computes at once, each one a row of B it streams
+constexpr int DOT_COLS = 4;
+
+// The whole GEMM, see PackedGemm::gemm, packing into blocks of allocator
+template <typename T>
+void packed_gemm(int TA, int TB, int M, int N, int K, T ALPHA, const T *A,
+                 size_t lda, const T *B, size_t ldb, T BETA, T *C, size_t ldc,
+                 Allocator *allocator) {
+  static_assert(std::is_floating_point_v<T>,
+                "The packed GEMM is for float and double");
+  if (M <= 0 || N <= 0) return;
+  if (K <= 0) {
+    // Nothing is accumulated, so C is only scaled
+    for (int i = 0; i < M; i++) {
+      T *row = C + static_cast<size_t>(i) * ldc;
+      for (int j = 0; j < N; j++) row[j] = BETA == 0 ? T(0) : BETA * row[j];
+    }
+    return;
+  }
+
+  // The elements of a row of op(A) are a_stride apart
+  const size_t a_row_stride = TA ? 1 : lda;
+  const size_t a_stride = TA ? lda : 1;
+
+  if (M < MR && TB) {
+    // Every column of C is a dot product of a row of A, gathered and scaled
+    // once, with a row of B
+    PackBuffer<T> row(allocator, K);
+    const int j_end = N - N % DOT_COLS;
+    for (int i = 0; i < M; i++) {
+      const T *a = A + i * a_row_stride;
+      for (int k = 0; k < K; k++) row.get()[k] = ALPHA * a[k * a_stride];
+      T *c = C + static_cast<size_t>(i) * ldc;
+      for (int j0 = 0; j0 < j_end; j0 += DOT_COLS) {
+        dot_kernel<T, DOT_COLS>(K, row.get(), B, ldb, j0, BETA, c);
+      }
+      for (int j0 = j_end; j0 < N; j0++) {
+        dot_kernel<T, 1>(K, row.get(), B, ldb, j0, BETA, c);
+      }
+    }
+    return;
+  }
+
+  if (M < MR) {
+    // The few columns past the last group of NR are summed row by row
+    const int j_end = N - N % NR<T>;
+    for (int i = 0; i < M; i++) {
+      const T *a = A + i * a_row_stride;
+      T *c = C + static_cast<size_t>(i) * ldc;
+      for (int j0 = 0; j0 < j_end; j0 += NR<T>) {
+        row_kernel(K, ALPHA, a, a_stride, B, ldb, j0, BETA, c);
+      }
+      if (j_end == N) continue;
+      T sums[NR<T>] = {};
+      for (int k = 0; k < K; k++) {
+        const T *b = B + static_cast<size_t>(k) * ldb + j_end;
+        const T x = a[k * a_stride];
+        for (int j = 0; j < N - j_end; j++) sums[j] += x * b[j];
+      }
+      for (int j = j_end; j < N; j++) {
+        const T sum = sums[j - j_end];
+        c[j] = BETA == 0 ? ALPHA * sum : ALPHA * sum + BETA * c[j];
+      }
+    }
+    return;
+  }
+
+  const int kc_max = min_of(K, KC<T>);
+  const int mc_max = min_of(M, MC);
+  const int nc_max = min_of(N, NC);
+  const int a_panels = (mc_max + MR - 1) / MR;
+  const int b_panels = (nc_max + NR<T> - 1) / NR<T>;
+  PackBuffer<T> packed_a(allocator,
+                         static_cast<size_t>(a_panels) * MR * kc_max);
+  PackBuffer<T> packed_b(allocator,
+                         static_cast<size_t>(b_panels) * NR<T> * kc_max);
+  alignas(PANEL_ALIGNMENT) T tile[MR * NR<T>];
+
+  for (int jc = 0; jc < N; jc += NC) {
+    const int nc = min_of(NC, N - jc);
+    const int nc_panels = (nc + NR<T> - 1) / NR<T>;
+
+    for (int pc = 0; pc < K; pc += KC<T>) {
+      const int kc = min_of(KC<T>, K - pc);
+      // C is scaled by BETA once, the later blocks of K add to it
+      const T beta = pc == 0 ? BETA : T(1);
+
+      for (int jr = 0; jr < nc_panels; jr++) {
+        const int col = jr * NR<T>;
+        pack_b(B, ldb, TB, pc, kc, jc + col, min_of(NR<T>, nc - col),
+               packed_b.get() + static_cast<size_t>(jr) * NR<T> * kc);
+      }
+
+      for (int ic = 0; ic < M; ic += MC) {
+        const int mc = min_of(MC, M - ic);
+        const int mc_panels = (mc + MR - 1) / MR;
+        for (int ir = 0; ir < mc_panels; ir++) {
+          const int row = ir * MR;
+          pack_a(A, lda, TA, ic + row, min_of(MR, mc - row), pc, kc, ALPHA,
+                 packed_a.get() + static_cast<size_t>(ir) * MR * kc);
+        }
+
+        // A panel of B is used for every panel of the block of A before
+        // the next one is loaded
+        for (int jr = 0; jr < nc_panels; jr++) {
+          const int col = jr * NR<T>;
+          const int cols = min_of(NR<T>, nc - col);
+          const T *b_panel =
+              packed_b.get() + static_cast<size_t>(jr) * NR<T> * kc;
+          for (int ir = 0; ir < mc_panels; ir++) {
+            const int row = ir * MR;
+            const int rows = min_of(MR, mc - row);
+            const T *a_panel =
+                packed_a.get() + static_cast<size_t>(ir) * MR * kc;
+            T *c = C + static_cast<size_t>(ic + row) * ldc + jc + col;
+            if (rows == MR && cols == NR<T>) {
+              micro_kernel(kc, a_panel, b_panel, beta, c, ldc);
+            } else {
+              // The edge tiles are computed whole into the buffer
+              micro_kernel(kc, a_panel, b_panel, T(0), tile,
+                           static_cast<size_t>(NR<T>));
+              write_tile(tile, rows, cols, beta, c, ldc);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+// The kernel of this translation unit for the dispatch build
+template <typename T>
+PackedGemmKernel<T> this_packed_gemm_kernel() {
+  return {&packed_gemm<T>, MR, NR<T>};
+}
+
+}  // namespace
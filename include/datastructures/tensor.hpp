@@ -1,13 +1,27 @@
 #pragma once
 
+#include "datastructures/half.hpp"
+#include "datastructures/inline_array.hpp"
 #include "datastructures/mml_array.hpp"
+#include "datastructures/tensor_span.hpp"
+#include "datastructures/tensor_view.hpp"
+
+/// @brief Tag selecting the Tensor constructor that leaves the elements
+/// uninitialised, for outputs that are fully overwritten right away.
+struct uninitialized_t {
+  explicit uninitialized_t() = default;
+};
+
+/// @brief The tag passed to the uninitialised Tensor constructor.
+inline constexpr uninitialized_t uninitialized{};
 
 /*!
  * @brief A Tensor<T> implementation using an underlying
  * fixed size 1D array with row-major offsets for
  * multi-dimensional indexing.
  * @tparam T The type of the data contained in the tensor.
- * Allows for arithmetic types.
+ * Allows for arithmetic types, and the 16-bit float storage types of
+ * half.hpp.
  */
 template <typename T>
 class Tensor {
@@ -48,7 +62,7 @@ class Tensor {
   /// @param jump_rows The number of elements to skip when moving to the next
   /// row.
   /// @param sliced Whether the tensor is sliced or not.
-  explicit Tensor(const array_mml<size_t> &shape, const size_t jump_indexes = 0,
+  explicit Tensor(const Shape &shape, const size_t jump_indexes = 0,
                   const size_t jump_columns = 0, const size_t jump_rows = 0,
                   const bool sliced = false);
 
@@ -61,10 +75,28 @@ class Tensor {
   /// @param jump_rows The number of elements to skip when moving to the next
   /// row.
   /// @param sliced Whether the tensor is sliced or not.
-  explicit Tensor(const array_mml<size_t> &shape, const array_mml<T> &data,
+  explicit Tensor(const Shape &shape, const array_mml<T> &data,
                   const size_t jump_indexes = 0, const size_t jump_columns = 0,
                   const size_t jump_rows = 0, const bool sliced = false);
 
+  /// @brief Constructor for Tensor class taking ownership of the data.
+  /// @param shape The shape of the tensor.
+  /// @param data The data to move into the tensor, it is not copied.
+  /// @param jump_indexes The number of elements to skip when moving to the next
+  /// @param jump_columns The number of elements to skip when moving to the next
+  /// column.
+  /// @param jump_rows The number of elements to skip when moving to the next
+  /// row.
+  /// @param sliced Whether the tensor is sliced or not.
+  explicit Tensor(const Shape &shape, array_mml<T> &&data,
+                  const size_t jump_indexes = 0, const size_t jump_columns = 0,
+                  const size_t jump_rows = 0, const bool sliced = false);
+
+  /// @brief Constructor for Tensor class that skips zero filling the data,
+  /// every element has to be written before it is read.
+  /// @param shape The shape of the tensor.
+  explicit Tensor(const Shape &shape, uninitialized_t);
+
   /// @brief Destructor for Tensor class.
   ~Tensor() = default;
 
@@ -91,16 +123,57 @@ class Tensor {
   std::shared_ptr<Tensor<T>> copy() const;
   void reverse_buffer();
   std::shared_ptr<Tensor<T>> slice(std::initializer_list<size_t> slice_indices);
-  std::shared_ptr<Tensor<T>> slice(array_mml<size_t> &slice_indices);
-  void reshape(const array_mml<size_t> &new_shape);
+  std::shared_ptr<Tensor<T>> slice(const Shape &slice_indices);
+  void reshape(const Shape &new_shape);
   void reshape(std::initializer_list<size_t> new_shape);
+
+  /// @brief Create a tensor with a new shape that shares the data of this
+  /// tensor, leaving this tensor untouched.
+  /// @param new_shape The shape of the new tensor, must have the same size.
+  /// @return The reshaped tensor, writes to it are visible in this tensor.
+  std::shared_ptr<Tensor<T>> reshaped(const Shape &new_shape);
+
+  /// @brief Create a tensor with a new shape that shares the data of this
+  /// tensor until either of them is written to, for reading a tensor that
+  /// others read as well, such as a weight.
+  /// @param new_shape The shape of the new tensor, must have the same size.
+  /// @return The reshaped tensor, writes to it are not visible in this tensor.
+  std::shared_ptr<Tensor<T>> reshaped(const Shape &new_shape) const;
+
+  /// @brief Get an unchecked view of the elements for the inner loops of
+  /// kernels, the bounds are only checked by the caller. A buffer shared with
+  /// a copy is made unique here, so a kernel takes its spans before its
+  /// threads start. Copies made while the span is in use copy the data.
+  /// @return A view of the data, shape and strides of this tensor.
+  /// @throws std::runtime_error If the tensor is sliced.
+  TensorSpan<T> get_span();
+
+  /// @brief Get an unchecked read only view of the elements for the inner
+  /// loops of kernels, the bounds are only checked by the caller.
+  /// @return A view of the data, shape and strides of this tensor.
+  /// @throws std::runtime_error If the tensor is sliced.
+  TensorSpan<const T> get_span() const;
+
+  /// @brief Get a strided view that shares the data of this tensor, to slice,
+  /// permute or broadcast it without copying.
+  /// @return A view of the whole tensor, writes to it are visible in this
+  /// tensor.
+  /// @throws std::runtime_error If the tensor is sliced.
+  TensorView<T> view();
+
+  /// @brief Get a strided view that shares the data of this tensor for
+  /// reading, the data might be shared with copies of this tensor.
+  /// @return A read only view of the whole tensor.
+  /// @throws std::runtime_error If the tensor is sliced.
+  TensorView<const T> view() const;
+
   bool is_matrix() const;
   bool operator==(const Tensor<T> &other) const;
-  const array_mml<size_t> &get_shape() const;
-  const array_mml<size_t> &get_offsets() const;
+  const Shape &get_shape() const;
+  const Shape &get_offsets() const;
   size_t get_size() const;
-  const T &operator[](array_mml<size_t> &indices) const;
-  T &operator[](array_mml<size_t> &indices);
+  const T &operator[](const Shape &indices) const;
+  T &operator[](const Shape &indices);
   const T &operator[](std::initializer_list<size_t> indices) const;
   T &operator[](std::initializer_list<size_t> indices);
   const T &operator[](size_t index) const;
@@ -113,12 +186,12 @@ class Tensor {
   std::shared_ptr<Tensor<T>> transpose(const std::vector<int> &perm) const;
 
   std::shared_ptr<Tensor<T>> broadcast_reshape(
-      const array_mml<size_t> &target_shape) const;
+      const Shape &target_shape) const;
 
  private:
   array_mml<T> data;
-  array_mml<size_t> shape;
-  array_mml<size_t> indices_offsets;
+  Shape shape;
+  Shape indices_offsets;
   bool sliced;
   size_t jump_indexes;
   size_t jump_rows;
@@ -127,14 +200,14 @@ class Tensor {
 
   // Helper methods
   size_t compute_size() const;
-  array_mml<size_t> compute_indices_offsets() const;
-  bool valid_shape(const array_mml<size_t> &new_shape) const;
-  bool valid_indices(const array_mml<size_t> &indices) const;
+  Shape compute_indices_offsets() const;
+  bool valid_shape(const Shape &new_shape) const;
+  bool valid_indices(const Shape &indices) const;
   bool valid_index(size_t index) const;
-  bool valid_slice_indices(const array_mml<size_t> &slice_indices) const;
+  bool valid_slice_indices(const Shape &slice_indices) const;
   bool valid_broadcast_reshape_size(
-      const array_mml<size_t> &target_shape) const;
-  size_t indices_to_1d_index(array_mml<size_t> indices) const;
+      const Shape &target_shape) const;
+  size_t indices_to_1d_index(const Shape &indices) const;
   size_t index_to_offset_1d_index(size_t index) const;
 };
 
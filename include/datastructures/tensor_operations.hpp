@@ -1,19 +1,141 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "datastructures/elementwise_ops.hpp"
 #include "datastructures/tensor.hpp"
+#include "utility/parallel.hpp"
+
+/**
+ * @struct Requantization
+ * @brief How the int32 accumulators of an int8 GEMM are mapped back to 8 bits,
+ * out = clamp(round((acc + bias) * scale) + zero_point).
+ */
+struct Requantization {
+  /// One scale for the whole output, or one for every column of C.
+  std::vector<float> scales;
+  /// Empty, or one int32 bias for every column of C.
+  std::vector<int32_t> bias;
+  /// The zero point of the output.
+  int32_t zero_point = 0;
+};
 
 template <typename T>
 class TensorOperations {
  public:
   TensorOperations() = delete;  // Prevent instantiation of this class
 
+  /**
+   * @brief General matrix multiplication, C = ALPHA * op(A) * op(B) + BETA * C.
+   *
+   * A transposed operand is read in place by every backend, so a layer with
+   * transposed weights does not copy them on every call.
+   *
+   * @param TA Whether A is stored transposed, as K x M.
+   * @param TB Whether B is stored transposed, as N x K.
+   * @param M The number of rows of op(A) and C.
+   * @param N The number of columns of op(B) and C.
+   * @param K The number of columns of op(A) and rows of op(B).
+   * @param ALPHA The factor of op(A) * op(B).
+   * @param BETA The factor of C, which is not read when it is 0.
+   * @param A The matrix A, as stored.
+   * @param lda The row stride of A as stored.
+   * @param B The matrix B, as stored.
+   * @param ldb The row stride of B as stored.
+   * @param C The M x N output.
+   * @param ldc The row stride of C.
+   * @throws std::invalid_argument If the tensors are too small for M, N and
+   * K.
+   */
   static void gemm(int TA, int TB, int M, int N, int K, T ALPHA, T BETA,
                    std::shared_ptr<Tensor<T>> A, int lda,
                    std::shared_ptr<Tensor<T>> B, int ldb,
                    std::shared_ptr<Tensor<T>> C, int ldc);
 
+  /**
+   * @brief GEMM with B stored as 16-bit floats,
+   * C = ALPHA * A * op(B) + BETA * C.
+   *
+   * B is widened to float in registers as it is read, so it is streamed from
+   * memory at half the size, which is what bounds a layer with a batch of
+   * one. The columns of C are split across the threads, and B is read once
+   * for every row of A.
+   *
+   * @param TB Whether B is stored transposed, as N x K, which is how the
+   * weights of a fully connected layer usually are.
+   * @param M The number of rows of A and C.
+   * @param N The number of columns of C.
+   * @param K The number of columns of A.
+   * @param ALPHA The factor of A * op(B).
+   * @param BETA The factor of C, which is not read when it is 0.
+   * @param A The M x K float matrix.
+   * @param lda The row stride of A.
+   * @param B The 16-bit float matrix.
+   * @param ldb The row stride of B.
+   * @param C The M x N float output.
+   * @param ldc The row stride of C.
+   * @throws std::invalid_argument If the tensors are too small for M, N and
+   * K.
+   */
+  template <typename W>
+    requires(std::is_same_v<T, float> && is_half_v<W>)
+  static void gemm_half(int TB, int M, int N, int K, T ALPHA, T BETA,
+                        std::shared_ptr<const Tensor<T>> A, int lda,
+                        std::shared_ptr<const Tensor<W>> B, int ldb,
+                        std::shared_ptr<Tensor<T>> C, int ldc);
+
+  /**
+   * @brief 8-bit integer GEMM with int32 accumulation, C = A * op(B).
+   *
+   * The products are summed exactly, with VNNI when the library is built
+   * with AVX-512 VNNI and with 16-bit multiplies on AVX2. Like every int32
+   * sum, the accumulators only wrap with K in the tens of thousands.
+   *
+   * @param TB Whether B is stored transposed, as N x K, which is how
+   * quantised weights usually are and is read in place. A K x N B is
+   * transposed into a temporary first.
+   * @param M The number of rows of A and C.
+   * @param N The number of columns of C.
+   * @param K The number of columns of A.
+   * @param A The M x K matrix, int8 or uint8.
+   * @param lda The row stride of A.
+   * @param B The int8 matrix.
+   * @param ldb The row stride of B.
+   * @param C The M x N int32 output, which is overwritten.
+   * @param ldc The row stride of C.
+   * @throws std::invalid_argument If the tensors are too small for M, N and
+   * K.
+   */
+  template <typename TA>
+    requires(std::is_same_v<T, int32_t> &&
+             (std::is_same_v<TA, int8_t> || std::is_same_v<TA, uint8_t>))
+  static void gemm_int8(int TB, int M, int N, int K,
+                        std::shared_ptr<const Tensor<TA>> A, int lda,
+                        std::shared_ptr<const Tensor<int8_t>> B, int ldb,
+                        std::shared_ptr<Tensor<T>> C, int ldc);
+
+  /**
+   * @brief 8-bit integer GEMM requantised to 8 bits, see the int32 overload
+   * for the arguments.
+   *
+   * @param requantization The scales, per tensor or per column of C, the
+   * bias and the zero point applied to the int32 accumulators.
+   * @throws std::invalid_argument If there is neither one scale nor one per
+   * column, or the bias is neither empty nor one per column.
+   */
+  template <typename TA>
+    requires((std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) &&
+             (std::is_same_v<TA, int8_t> || std::is_same_v<TA, uint8_t>))
+  static void gemm_int8(int TB, int M, int N, int K,
+                        std::shared_ptr<const Tensor<TA>> A, int lda,
+                        std::shared_ptr<const Tensor<int8_t>> B, int ldb,
+                        const Requantization &requantization,
+                        std::shared_ptr<Tensor<T>> C, int ldc);
+
   static void add(const std::shared_ptr<const Tensor<T>> a,
                   const std::shared_ptr<const Tensor<T>> b,
                   std::shared_ptr<Tensor<T>> c);
@@ -28,22 +150,357 @@ class TensorOperations {
   static bool equals(const std::shared_ptr<Tensor<T>> a,
                      const std::shared_ptr<Tensor<T>> b);
 
+  /**
+   * @brief Get the flat index of the largest element, the first one on ties.
+   * Like in ONNX and numpy, a NaN is larger than every number.
+   *
+   * @param a The tensor.
+   * @return The flat index of the largest element.
+   * @throws std::runtime_error If the tensor is empty.
+   */
   static int arg_max(const std::shared_ptr<const Tensor<T>> a);
 
+  /**
+   * @brief Sum the elements along some axes.
+   *
+   * Contiguous runs are summed in several independent lanes, and runs split
+   * across the thread pool in fixed blocks, so the result does not depend on
+   * the number of threads.
+   *
+   * @param a The input tensor.
+   * @param axes The axes to reduce, negative ones count from the last. All
+   * the axes are reduced when it is empty.
+   * @param keep_dims Whether the reduced axes are kept with size 1. Reducing
+   * every axis without keeping them gives the shape {1}.
+   * @return The reduced tensor.
+   * @throws std::invalid_argument If an axis is out of range.
+   */
+  static std::shared_ptr<Tensor<T>> sum(
+      const std::shared_ptr<const Tensor<T>> a,
+      const std::vector<int> &axes = {}, bool keep_dims = false);
+
+  /**
+   * @brief Average the elements along some axes, see sum for the arguments.
+   * Integer averages are truncated.
+   */
+  static std::shared_ptr<Tensor<T>> mean(
+      const std::shared_ptr<const Tensor<T>> a,
+      const std::vector<int> &axes = {}, bool keep_dims = false);
+
+  /**
+   * @brief Get the largest elements along some axes, see sum for the
+   * arguments.
+   */
+  static std::shared_ptr<Tensor<T>> max(
+      const std::shared_ptr<const Tensor<T>> a,
+      const std::vector<int> &axes = {}, bool keep_dims = false);
+
+  /**
+   * @brief Get the smallest elements along some axes, see sum for the
+   * arguments.
+   */
+  static std::shared_ptr<Tensor<T>> min(
+      const std::shared_ptr<const Tensor<T>> a,
+      const std::vector<int> &axes = {}, bool keep_dims = false);
+
+  /**
+   * @brief Get the index of the largest element along an axis, the first one
+   * on ties. A NaN is larger than every number.
+   *
+   * @param a The input tensor.
+   * @param axis The axis to reduce, negative counts from the last.
+   * @param keep_dims Whether the axis is kept with size 1.
+   * @return The indices along the axis.
+   * @throws std::invalid_argument If the axis is out of range or empty.
+   */
+  static std::shared_ptr<Tensor<int64_t>> arg_max(
+      const std::shared_ptr<const Tensor<T>> a, int axis,
+      bool keep_dims = false);
+
+  /**
+   * @brief Get the k largest elements along an axis, in descending order and
+   * the first one first on ties. NaNs come before every number.
+   *
+   * @param a The input tensor.
+   * @param k The number of elements to keep.
+   * @param axis The axis to search, negative counts from the last.
+   * @return The values and their indices along the axis, both with the axis
+   * resized to k.
+   * @throws std::invalid_argument If the axis is out of range or shorter
+   * than k.
+   */
+  static std::pair<std::shared_ptr<Tensor<T>>,
+                   std::shared_ptr<Tensor<int64_t>>>
+  top_k(const std::shared_ptr<const Tensor<T>> a, size_t k, int axis = -1);
+
+  /**
+   * @brief Check that two tensors have the same shape and that every pair of
+   * elements satisfies |a - b| <= atol + rtol * |b|.
+   *
+   * @param a The tensor to check.
+   * @param b The reference tensor.
+   * @param rtol The tolerance relative to b.
+   * @param atol The absolute tolerance.
+   * @return Whether the tensors are close, false if any element is NaN.
+   */
+  static bool all_close(const std::shared_ptr<const Tensor<T>> a,
+                        const std::shared_ptr<const Tensor<T>> b,
+                        double rtol = 1e-5, double atol = 1e-8);
+
+  /**
+   * @brief Apply a functor to every element of a tensor.
+   *
+   * The functor is taken by type so the call is inlined into a flat loop over
+   * the contiguous elements. A functor with an `apply(const T *, T *, size_t)`
+   * member gets whole chunks instead, see elementwise_ops.hpp.
+   *
+   * @param a The input tensor.
+   * @param f The functor, called as `T f(T)`.
+   * @param c The output tensor. It keeps its shape if it has as many
+   * elements as a, else it is replaced by a tensor of the shape of a.
+   */
+  template <typename F>
   static void elementwise(const std::shared_ptr<const Tensor<T>> a,
-                          const std::function<T(T)> &f,
-                          const std::shared_ptr<Tensor<T>> c);
+                          const F &f, const std::shared_ptr<Tensor<T>> c);
 
+  /**
+   * @brief Apply a functor to every element of a tensor, in place.
+   *
+   * @param a The tensor.
+   * @param f The functor, called as `T f(T)`.
+   */
+  template <typename F>
   static void elementwise_in_place(const std::shared_ptr<Tensor<T>> a,
-                                   const std::function<T(T)> &f);
+                                   const F &f);
+
+  /**
+   * @brief Get the shape two tensors broadcast to.
+   *
+   * The shapes are aligned from their last dimension, and each pair of
+   * dimensions must be equal or one of them must be 1.
+   *
+   * @param a_shape The shape of the first tensor.
+   * @param b_shape The shape of the second tensor.
+   * @return The broadcast shape.
+   * @throws std::invalid_argument If the shapes can not be broadcast.
+   */
+  static Shape broadcast_shape(const Shape &a_shape, const Shape &b_shape);
+
+  /**
+   * @brief Apply a binary functor to two tensors broadcast against each other.
+   *
+   * The strides of both inputs are worked out once, 0 along the dimensions
+   * they are repeated in, and dimensions that are contiguous in both inputs
+   * are merged. The functor then runs in flat inner loops, with separate
+   * paths for an input that is constant along the inner loop, which covers a
+   * scalar or a bias along the channels of an NCHW tensor.
+   *
+   * @param a The first input tensor.
+   * @param b The second input tensor.
+   * @param f The functor, called as `T f(T a, T b)`, see elementwise_ops.hpp.
+   * @param c The output tensor, reshaped to the broadcast shape if needed. It
+   * may be the same tensor as an input with the broadcast shape.
+   * @throws std::invalid_argument If the shapes can not be broadcast.
+   */
+  template <typename F>
+  static void broadcast(const std::shared_ptr<const Tensor<T>> a,
+                        const std::shared_ptr<const Tensor<T>> b, const F &f,
+                        const std::shared_ptr<Tensor<T>> c);
 
   static void sliding_window(
-      const array_mml<size_t> &in_shape, const array_mml<size_t> &out_shape,
+      const Shape &in_shape, const Shape &out_shape,
       const std::vector<int> &kernel_shape, const std::vector<int> &strides,
       const std::vector<int> &dilations,
       const std::vector<std::pair<int, int>> &pads,
-      const std::function<void(const std::vector<std::vector<size_t>> &,
-                               const std::vector<size_t> &)> &window_f);
+      const std::function<void(const std::vector<Shape> &, const Shape &)>
+          &window_f);
+
+ private:
+  // Rough number of operations of applying an element-wise functor once
+  static constexpr size_t ELEMENTWISE_COST = 16;
+
+  // Helper applying the functor to a contiguous range, in chunks when the
+  // functor supports it
+  template <typename F>
+  static void elementwise_range(const T *in, T *out, size_t n, const F &f);
+
+  // Rough number of operations of one element of a broadcast functor
+  static constexpr size_t BROADCAST_COST = 4;
+
+  // The output dimensions of a broadcast after merging, with the stride of
+  // each input along them, 0 where the input is repeated. The last dimension
+  // is the inner loop.
+  struct BroadcastLayout {
+    size_t rank = 0;
+    size_t extent[MAX_TENSOR_RANK];
+    size_t a_stride[MAX_TENSOR_RANK];
+    size_t b_stride[MAX_TENSOR_RANK];
+  };
+
+  static BroadcastLayout broadcast_layout(const Shape &a_shape,
+                                          const Shape &b_shape,
+                                          const Shape &out_shape);
+
+  // Elements per block a reduction over a contiguous run is split into
+  static constexpr size_t REDUCE_BLOCK = 1 << 14;
+
+  // Helper applying a reduction to the axes flagged in a tensor
+  template <typename F>
+  static std::shared_ptr<Tensor<T>> reduce(
+      const std::shared_ptr<const Tensor<T>> a, const std::vector<int> &axes,
+      bool keep_dims, const F &f, T identity);
+
+  // Helper reducing the middle dimension of an {outer, extent, inner} layout
+  template <typename F>
+  static void reduce_dimension(const T *in, T *out, size_t outer,
+                               size_t extent, size_t inner, const F &f,
+                               T identity);
+
+  // Helper running the functor along one row of the merged layout
+  template <typename F>
+  static void broadcast_row(const T *a, size_t a_stride, const T *b,
+                            size_t b_stride, T *c, size_t n, const F &f);
 };
 
+template <typename T>
+template <typename F>
+void TensorOperations<T>::elementwise_range(const T *in, T *out, size_t n,
+                                            const F &f) {
+  if constexpr (requires { f.apply(in, out, n); }) {
+    f.apply(in, out, n);
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = f(in[i]);
+    }
+  }
+}
+
+template <typename T>
+template <typename F>
+void TensorOperations<T>::elementwise(const std::shared_ptr<const Tensor<T>> a,
+                                      const F &f,
+                                      const std::shared_ptr<Tensor<T>> c) {
+  if (c->get_size() != a->get_size()) {
+    *c = Tensor<T>(a->get_shape(), uninitialized);
+  }
+
+  const T *in = a->get_span().get_data();
+  T *out = c->get_span().get_data();
+
+  // Both tensors are dense and row-major, so the flat index walks them in
+  // step and the elements can be split across the threads
+  Parallel::parallel_for(0, a->get_size(),
+                         Parallel::grain_for(ELEMENTWISE_COST),
+                         [&](size_t begin, size_t end) {
+                           elementwise_range(in + begin, out + begin,
+                                             end - begin, f);
+                         });
+}
+
+template <typename T>
+template <typename F>
+void TensorOperations<T>::elementwise_in_place(
+    const std::shared_ptr<Tensor<T>> a, const F &f) {
+  T *data = a->get_span().get_data();
+
+  Parallel::parallel_for(0, a->get_size(),
+                         Parallel::grain_for(ELEMENTWISE_COST),
+                         [&](size_t begin, size_t end) {
+                           elementwise_range(data + begin, data + begin,
+                                             end - begin, f);
+                         });
+}
+
+template <typename T>
+template <typename F>
+void TensorOperations<T>::broadcast_row(const T *a, size_t a_stride,
+                                        const T *b, size_t b_stride, T *c,
+                                        size_t n, const F &f) {
+  // Unit and zero strides get their own loops so the compiler can vectorise
+  // them, the constant operand is loaded once up front
+  if (a_stride == 1 && b_stride == 1) {
+    for (size_t i = 0; i < n; ++i) {
+      c[i] = f(a[i], b[i]);
+    }
+  } else if (a_stride == 1 && b_stride == 0) {
+    const T b_value = *b;
+    for (size_t i = 0; i < n; ++i) {
+      c[i] = f(a[i], b_value);
+    }
+  } else if (a_stride == 0 && b_stride == 1) {
+    const T a_value = *a;
+    for (size_t i = 0; i < n; ++i) {
+      c[i] = f(a_value, b[i]);
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      c[i] = f(a[i * a_stride], b[i * b_stride]);
+    }
+  }
+}
+
+template <typename T>
+template <typename F>
+void TensorOperations<T>::broadcast(const std::shared_ptr<const Tensor<T>> a,
+                                    const std::shared_ptr<const Tensor<T>> b,
+                                    const F &f,
+                                    const std::shared_ptr<Tensor<T>> c) {
+  const Shape out_shape = broadcast_shape(a->get_shape(), b->get_shape());
+  if (!(c->get_shape() == out_shape)) {
+    size_t out_size = 1;
+    for (size_t dim : out_shape) out_size *= dim;
+    if (c->get_size() == out_size) {
+      c->reshape(out_shape);
+    } else {
+      *c = Tensor<T>(out_shape, uninitialized);
+    }
+  }
+
+  const BroadcastLayout layout =
+      broadcast_layout(a->get_shape(), b->get_shape(), out_shape);
+  const size_t last = layout.rank - 1;
+  const size_t inner = layout.extent[last];
+
+  const T *a_data = a->get_span().get_data();
+  const T *b_data = b->get_span().get_data();
+  T *c_data = c->get_span().get_data();
+
+  Parallel::parallel_for(
+      0, c->get_size(), Parallel::grain_for(BROADCAST_COST),
+      [&](size_t begin, size_t end) {
+        // The coordinates of the first element are the only divisions, the
+        // rest of the chunk steps through the layout row by row
+        size_t coord[MAX_TENSOR_RANK];
+        size_t a_offset = 0;
+        size_t b_offset = 0;
+        size_t remaining = begin;
+        for (size_t d = layout.rank; d-- > 0;) {
+          coord[d] = remaining % layout.extent[d];
+          remaining /= layout.extent[d];
+          a_offset += coord[d] * layout.a_stride[d];
+          b_offset += coord[d] * layout.b_stride[d];
+        }
+
+        for (size_t i = begin; i < end;) {
+          const size_t n = std::min(inner - coord[last], end - i);
+          broadcast_row(a_data + a_offset, layout.a_stride[last],
+                        b_data + b_offset, layout.b_stride[last], c_data + i,
+                        n, f);
+          i += n;
+
+          coord[last] += n;
+          a_offset += n * layout.a_stride[last];
+          b_offset += n * layout.b_stride[last];
+          for (size_t d = last; d > 0 && coord[d] == layout.extent[d]; --d) {
+            coord[d] = 0;
+            a_offset -= layout.extent[d] * layout.a_stride[d];
+            b_offset -= layout.extent[d] * layout.b_stride[d];
+            coord[d - 1]++;
+            a_offset += layout.a_stride[d - 1];
+            b_offset += layout.b_stride[d - 1];
+          }
+        }
+      });
+}
+
 #define _TENSOR_OPERATIONS(DT) template class TensorOperations<DT>;
\ No newline at end of file
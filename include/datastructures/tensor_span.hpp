@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @class TensorSpan
+ * @brief An unchecked view of the elements of a contiguous tensor.
+ *
+ * A span holds a pointer to the first element and to the shape and strides of
+ * the tensor it was taken from, so element access is plain pointer arithmetic
+ * without any bounds check or allocation. It is meant for the inner loops of
+ * kernels, the checks are done once when the span is taken with
+ * Tensor::get_span. The span is invalidated when the tensor is reshaped or its
+ * data is reassigned.
+ *
+ * @tparam T The element type, const for a read only view.
+ */
+template <typename T>
+class TensorSpan {
+ public:
+  using value_type = T;
+
+  /**
+   * @brief Constructor for TensorSpan.
+   *
+   * @param data Pointer to the first element.
+   * @param shape Pointer to the size of every dimension.
+   * @param strides Pointer to the number of elements between two consecutive
+   * indices of every dimension.
+   * @param rank The number of dimensions.
+   */
+  TensorSpan(T *data, const size_t *shape, const size_t *strides, size_t rank)
+      : data(data), shape(shape), strides(strides), rank(rank) {}
+
+  /**
+   * @brief Access an element by its flat index, without bounds checking.
+   *
+   * @param index The flat index of the element.
+   * @return A reference to the element.
+   */
+  T &operator[](size_t index) const { return data[index]; }
+
+  /**
+   * @brief Access an element by one index per dimension, without bounds
+   * checking.
+   *
+   * @param indices The index along each leading dimension, missing trailing
+   * indices are taken as zero.
+   * @return A reference to the element.
+   */
+  template <typename... Indices>
+  T &operator()(Indices... indices) const {
+    size_t offset = 0;
+    size_t dim = 0;
+    ((offset += static_cast<size_t>(indices) * strides[dim++]), ...);
+    return data[offset];
+  }
+
+  /**
+   * @brief Get the pointer to the first element.
+   *
+   * @return The pointer to the first element.
+   */
+  T *get_data() const { return data; }
+
+  /**
+   * @brief Get the size of a dimension.
+   *
+   * @param dim The dimension.
+   * @return The number of indices along the dimension.
+   */
+  size_t get_shape(size_t dim) const { return shape[dim]; }
+
+  /**
+   * @brief Get the stride of a dimension.
+   *
+   * @param dim The dimension.
+   * @return The number of elements between two consecutive indices.
+   */
+  size_t get_stride(size_t dim) const { return strides[dim]; }
+
+  /**
+   * @brief Get the number of dimensions.
+   *
+   * @return The number of dimensions.
+   */
+  size_t get_rank() const { return rank; }
+
+  /**
+   * @brief Get the number of elements.
+   *
+   * @return The number of elements.
+   */
+  size_t get_size() const { return rank == 0 ? 1 : shape[0] * strides[0]; }
+
+ private:
+  T *data;
+  const size_t *shape;
+  const size_t *strides;
+  size_t rank;
+};
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <type_traits>
+
+#include "datastructures/half.hpp"
+#include "datastructures/inline_array.hpp"
+
+template <typename T>
+class Tensor;
+
+/**
+ * @class TensorView
+ * @brief A strided view of the data of a tensor.
+ *
+ * A view shares the buffer of the tensor it was taken from and describes its
+ * elements with an offset and one stride per dimension, so slicing, permuting
+ * dimensions and broadcasting only compute new strides instead of moving any
+ * data. Broadcast dimensions have a stride of zero, every index along them
+ * reads the same element. Writes through a view are visible in the tensor and
+ * in every other view of the same buffer. A view of const T, as taken from a
+ * const tensor, can only read.
+ *
+ * @tparam T The type of the data contained in the view, const for a read
+ * only view.
+ */
+template <typename T>
+class TensorView {
+ public:
+  using value_type = T;
+  /// The type of the elements without const, as they are copied out
+  using element_type = std::remove_const_t<T>;
+
+  /**
+   * @brief Constructor for TensorView.
+   *
+   * @param data The buffer to view, it is shared and not copied.
+   * @param offset The position of the first element in the buffer.
+   * @param shape The size of every dimension.
+   * @param strides The number of elements between two consecutive indices of
+   * every dimension.
+   */
+  TensorView(std::shared_ptr<T[]> data, size_t offset, Shape shape,
+             Shape strides);
+
+  /**
+   * @brief Access an element by one index per dimension, without bounds
+   * checking.
+   *
+   * @param indices The index along each leading dimension, missing trailing
+   * indices are taken as zero.
+   * @return A reference to the element.
+   */
+  template <typename... Indices>
+  T &operator()(Indices... indices) const {
+    size_t position = offset;
+    size_t dim = 0;
+    ((position += static_cast<size_t>(indices) * strides[dim++]), ...);
+    return data[position];
+  }
+
+  /**
+   * @brief Access an element by one index per dimension.
+   *
+   * @param indices The index along every dimension.
+   * @return A reference to the element.
+   * @throws std::invalid_argument If the indices are out of range.
+   */
+  T &at(const Shape &indices) const;
+
+  /**
+   * @brief Permute the dimensions of the view.
+   *
+   * @param perm The dimension of this view that becomes each dimension of the
+   * new view.
+   * @return The permuted view, it shares the buffer of this view.
+   * @throws std::invalid_argument If perm is not a permutation of the
+   * dimensions.
+   */
+  TensorView<T> transpose(const std::vector<int> &perm) const;
+
+  /**
+   * @brief Broadcast the view to a larger shape with the numpy rules.
+   *
+   * @param target_shape The shape to broadcast to, trailing dimensions are
+   * matched and every dimension must be equal or 1 in this view.
+   * @return The broadcast view, the new and repeated dimensions have a stride
+   * of zero.
+   * @throws std::invalid_argument If the view cannot be broadcast.
+   */
+  TensorView<T> broadcast(const Shape &target_shape) const;
+
+  /**
+   * @brief Restrict a dimension of the view to a range.
+   *
+   * @param dim The dimension to restrict.
+   * @param begin The first index of the range.
+   * @param end The end of the range, exclusive.
+   * @return The restricted view, it shares the buffer of this view.
+   * @throws std::invalid_argument If the range is out of bounds.
+   */
+  TensorView<T> slice(size_t dim, size_t begin, size_t end) const;
+
+  /**
+   * @brief Fix a dimension of the view to one index and drop it.
+   *
+   * @param dim The dimension to drop.
+   * @param index The index to keep along the dimension.
+   * @return The view with one dimension less, it shares the buffer of this
+   * view.
+   * @throws std::invalid_argument If the index is out of bounds.
+   */
+  TensorView<T> select(size_t dim, size_t index) const;
+
+  /**
+   * @brief Copy the elements of the view in row-major order into a tensor.
+   *
+   * @param destination The tensor to write to, it must have the shape of the
+   * view.
+   * @throws std::invalid_argument If the shapes do not match.
+   */
+  void copy_to(Tensor<element_type> &destination) const;
+
+  /**
+   * @brief Copy the 16-bit floats of the view in row-major order into a float
+   * tensor, widening every element.
+   *
+   * @param destination The tensor to write to, it must have the shape of the
+   * view.
+   * @throws std::invalid_argument If the shapes do not match.
+   */
+  void copy_to(Tensor<float> &destination) const
+    requires(is_half_v<element_type>);
+
+  /**
+   * @brief Copy the elements of the view into a new contiguous tensor.
+   *
+   * @return The new tensor.
+   */
+  std::shared_ptr<Tensor<element_type>> to_tensor() const;
+
+  /**
+   * @brief Check whether the elements are laid out contiguously in row-major
+   * order.
+   *
+   * @return True if the view is contiguous.
+   */
+  bool is_contiguous() const;
+
+  /**
+   * @brief Get the pointer to the first element.
+   *
+   * @return The pointer to the first element.
+   */
+  T *get_data() const;
+
+  /**
+   * @brief Get the buffer shared by the view.
+   *
+   * @return The buffer of the view.
+   */
+  const std::shared_ptr<T[]> &get_buffer() const;
+
+  /**
+   * @brief Get the position of the first element in the buffer.
+   *
+   * @return The offset of the view.
+   */
+  size_t get_offset() const;
+
+  /**
+   * @brief Get the shape of the view.
+   *
+   * @return The size of every dimension.
+   */
+  const Shape &get_shape() const;
+
+  /**
+   * @brief Get the strides of the view.
+   *
+   * @return The number of elements between two consecutive indices of every
+   * dimension.
+   */
+  const Shape &get_strides() const;
+
+  /**
+   * @brief Get the number of elements in the view.
+   *
+   * @return The number of elements.
+   */
+  size_t get_size() const;
+
+ private:
+  // Helper copying into a tensor of U, converting every element to U
+  template <typename U>
+  void copy_into(Tensor<U> &destination) const;
+
+  // Helper copying row by row along the last dimension
+  template <typename U>
+  void copy_rows(U *out) const;
+
+  // Helper copying square tiles of tile_dim and the last dimension, for views
+  // whose contiguous dimension is tile_dim
+  template <typename U>
+  void copy_tiled(U *out, size_t tile_dim) const;
+
+  std::shared_ptr<T[]> data;
+  size_t offset;
+  Shape shape;
+  Shape strides;
+};
+
+#define _TENSOR_VIEW(DT) \
+  template class TensorView<DT>;  \
+  template class TensorView<const DT>;
@@ -29,8 +29,7 @@ struct TensorVariantMaker<std::variant<Ts...>> {
 template <typename Variant>
 using TensorVariant = typename TensorVariantMaker<Variant>::type;
 
-// Type constraints: no bfloat16 or float16 for now (not native to c++ 17). Also
-// maybe exists more don't know.
+// The 16-bit floats are storage types, see half.hpp
 using GeneralDataTypes = std::variant<
     std::shared_ptr<Tensor<bool>>, std::shared_ptr<Tensor<double>>,
     std::shared_ptr<Tensor<float>>, std::shared_ptr<Tensor<int16_t>>,
@@ -40,7 +39,74 @@ using GeneralDataTypes = std::variant<
     std::shared_ptr<Tensor<uint64_t>>,  // Think this is meant to be
                                         // unsigned long long or uint64_t
                                         // not unsigned long int
-    std::shared_ptr<Tensor<uint8_t>>>;
+    std::shared_ptr<Tensor<uint8_t>>, std::shared_ptr<Tensor<fp16_t>>,
+    std::shared_ptr<Tensor<bf16_t>>>;
+
+/**
+ * @class TensorTable
+ * @brief A flat table of tensors indexed by integer slots.
+ *
+ * The slots are resolved from the tensor names once, when the execution plan
+ * is compiled, so running a node never hashes a name. An empty slot holds a
+ * null pointer. The table is sized once and reused for every inference.
+ */
+class TensorTable {
+ public:
+  /**
+   * @brief Constructor for TensorTable.
+   *
+   * @param num_slots The number of slots, all empty.
+   */
+  explicit TensorTable(size_t num_slots = 0);
+
+  /**
+   * @brief Empties every slot and sets the number of slots.
+   *
+   * @param num_slots The number of slots.
+   */
+  void reset(size_t num_slots);
+
+  /**
+   * @brief Get the number of slots.
+   *
+   * @return The number of slots.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Checks whether a slot holds a tensor.
+   *
+   * @param slot The slot to check.
+   * @return True if the slot holds a tensor.
+   */
+  bool contains(size_t slot) const;
+
+  /**
+   * @brief Access the tensor in a slot, the slot may be empty.
+   *
+   * @param slot The slot to access.
+   * @return A reference to the tensor in the slot.
+   */
+  GeneralDataTypes &operator[](size_t slot);
+
+  /**
+   * @brief Access the tensor in a slot, the slot may be empty.
+   *
+   * @param slot The slot to access.
+   * @return A const reference to the tensor in the slot.
+   */
+  const GeneralDataTypes &operator[](size_t slot) const;
+
+  /**
+   * @brief Empties a slot.
+   *
+   * @param slot The slot to empty.
+   */
+  void erase(size_t slot);
+
+ private:
+  std::vector<GeneralDataTypes> tensors;
+};
 
 /**
  * @class Node
@@ -56,11 +122,28 @@ class Node {
    * @brief Perform the forward pass computation.
    *
    * This pure virtual std::function must be overridden by derived classes to
-   * implement the specific forward pass logic. It modifies the output(s)
-   * in place.
+   * implement the specific forward pass logic. The inputs are read from and
+   * the outputs written to the given slots, which belong to the execution
+   * plan and not to the node, so a node can be shared by several plans and
+   * run concurrently. It modifies the output(s) in place.
+   *
+   * @param table The tensors of the graph, indexed by slot.
+   * @param inputs The slots of the inputs, in the order of getInputs.
+   * @param outputs The slots of the outputs, in the order of getOutputs.
    */
-  virtual void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) = 0;
+  virtual void forward(TensorTable &table, const std::vector<size_t> &inputs,
+                       const std::vector<size_t> &outputs) = 0;
+
+  /**
+   * @brief Perform the forward pass computation on tensors looked up by name.
+   *
+   * Runs forward on a temporary table holding the inputs and outputs of the
+   * node, and writes the outputs back into the map. This is meant for running
+   * a single node, a Model resolves the names only once.
+   *
+   * @param iomap The tensors of the graph, indexed by name.
+   */
+  void forward(std::unordered_map<std::string, GeneralDataTypes> &iomap);
 
   /**
    * @brief Get inputs.
@@ -84,4 +167,26 @@ class Node {
    * Ensures derived class destructors are called properly.
    */
   virtual ~Node() = default;
+
+ protected:
+  /**
+   * @brief Get a tensor to write an output into, the tensor already in the
+   * output slot is reused when it has the right type and shape.
+   *
+   * @param table The table the node runs on.
+   * @param slot The slot of the output.
+   * @param shape The shape of the output.
+   * @return The tensor in the slot or a new uninitialised tensor, either way
+   * the node has to write every element.
+   */
+  template <typename T>
+  std::shared_ptr<Tensor<T>> outputTensor(TensorTable &table, size_t slot,
+                                          const Shape &shape) const {
+    auto *existing = std::get_if<std::shared_ptr<Tensor<T>>>(&table[slot]);
+    if (existing != nullptr && *existing != nullptr &&
+        (*existing)->get_shape() == shape) {
+      return *existing;
+    }
+    return std::make_shared<Tensor<T>>(shape, uninitialized);
+  }
 };
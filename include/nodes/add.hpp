@@ -27,10 +27,12 @@ class AddNode : public Node {
 
   /**
    * @brief Performs element-wise binary addition in the two input tensors and
-   * stores the result in the output tensor.
+   * stores the result in the output tensor. The inputs are broadcast against
+   * each other when their shapes differ.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -51,14 +53,4 @@ class AddNode : public Node {
   std::string A;  // Input tensor A
   std::string B;  // Input tensor B
   std::string C;  // Output tensor C
-
-  /**
-   * @brief Helper std::function used when broadcasting addition is required.
-   * Likely only temporary to be replaced with something that can be used in
-   * multiple nodes instead.
-   *
-   * @return The output data.
-   */
-  void broadcast_addition(const TensorT &a_ptr, const TensorT &b_ptr,
-                          const TensorT &c_ptr) const;
 };
@@ -34,8 +34,9 @@ class AvgPoolNode : public Node {
   /**
    * @brief Perform the forward pass computation of AvgPoolNode.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes>& iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
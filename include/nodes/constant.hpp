@@ -27,8 +27,9 @@ class ConstantNode : public Node {
   /**§
    * @brief Perform the forward pass.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -7,7 +7,8 @@
  * @brief A class representing a Convolutional node in a computational graph.
  *
  * This class inherits from the Node class and represents a Conv node
- * in a computational graph.
+ * in a computational graph. With float data, the weights may also be stored
+ * as 16-bit floats.
  *
  * @author Tim Carlsson (timca@chalmers.se)
  */
@@ -75,8 +76,9 @@ class ConvNode : public Node {
    * operation, after the std::optional bias addition, is stored in the output
    * tensor `Y`, which represents the convolved feature maps.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -248,18 +250,27 @@ class ConvNode : public Node {
    * output_width, kernel_height * kernel_width * channels], representing the
    * flattened patches ready for matrix multiplication.
    *
+   * @param transposed Whether every patch is a row of the output instead of a
+   * column, the output then has shape [batch_size * output_height *
+   * output_width, kernel_height * kernel_width * channels].
+   *
    * @note The im2col operation prepares the input for matrix multiplication
    * with kernel weights during convolution but does not compute the convolution
    * itself.
    */
-  void im2col(const TensorT &input_variant, const TensorT &output_variant);
+  void im2col(const TensorT &input_variant, const TensorT &output_variant,
+              bool transposed = false);
 
   /**
    * @brief Performs the addition of the bias to the result.
    *
    * @param result_ptr The tensor to which the bias will be added.
+   * @param bias_variant The bias, of the type of the result or, for a float
+   * result, 16-bit floats.
+   * @throws std::runtime_error If the bias has another type.
    */
-  void add_bias(const TensorT &result_variant, const TensorT &bias_variant);
+  void add_bias(const TensorT &result_variant,
+                const GeneralDataTypes &bias_variant);
 
   // Getters for input tensor dimensions
   size_t get_batch_size() const;
@@ -292,6 +303,5 @@ class ConvNode : public Node {
   // Updates parameters based on the content of the input and weight tensor
   // This method is executed before forward so that we get the correct
   // parameters.
-  void update_parameters(const array_mml<size_t> &input_shape,
-                         const array_mml<size_t> &weight_shape);
+  void update_parameters(const Shape &input_shape, const Shape &weight_shape);
 };
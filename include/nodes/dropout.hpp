@@ -40,8 +40,9 @@ public:
   /**
    * @brief Perform the forward pass using dropout.
    */
-  void
-  forward(std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
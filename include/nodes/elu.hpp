@@ -30,8 +30,9 @@ class ELUNode : public Node {
   /**
    * @brief Perform the forward pass computation using the ELU std::function.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -46,8 +46,9 @@ class FlattenNode : public Node {
    *
    * Transforms the input tensor into a 2D tensor along the specified axis
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -9,6 +9,9 @@
  * This class inherits from the Node class and represents a General Matrix
  * Multiply (GEMM) node in a computational graph. It performs the forward pass
  * computation using the GEMM inner product.
+ *
+ * With float inputs, B may also be a tensor of 16-bit floats, which is read
+ * as it is stored instead of being widened first.
  */
 class GemmNode : public Node {
  public:
@@ -43,8 +46,9 @@ class GemmNode : public Node {
    * This std::function performs the forward pass computation using the General
    * Matrix Multiply (GEMM) inner product.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -74,4 +78,15 @@ class GemmNode : public Node {
   float beta;   // Scalar multiplier for C.
   int transA;   // Whether to transpose A (0: no, non-zero: yes).
   int transB;   // Whether to transpose B (0: no, non-zero: yes).
+
+  // Helper std::function returning the M x N output holding C, or
+  // uninitialised without C
+  template <typename ValueType>
+  std::shared_ptr<Tensor<ValueType>> prepareOutput(
+      TensorTable &table, const std::vector<size_t> &inputs,
+      const std::vector<size_t> &outputs, size_t M, size_t N);
+
+  // Helper std::function returning the factor of the output the GEMM runs
+  // with, 0 without C so that the uninitialised output is not read
+  float outputBeta() const;
 };
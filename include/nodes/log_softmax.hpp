@@ -35,8 +35,9 @@ class LogSoftMaxNode : public Node {
    * @brief Perform the forward pass computation using LogSoftMax activation
    * std::function.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -30,8 +30,9 @@ class LRNNode_mml : public Node {
 
   explicit LRNNode_mml(const nlohmann::json &node);
 
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
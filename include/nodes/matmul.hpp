@@ -38,8 +38,9 @@ class MatMulNode : public Node {
    * This std::function performs the forward pass computation using the General
    * Matrix Multiply (GEMM) inner product.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "datastructures/mml_array.hpp"
+#include "datastructures/inline_array.hpp"
 
 namespace NodeUtils {
 
@@ -27,8 +27,8 @@ namespace NodeUtils {
     }
 
     // Follows onnx specifications but onnxruntime does it differently.
-    inline array_mml<size_t> compute_pool_output_shape(
-        const array_mml<size_t>& input_shape,
+    inline Shape compute_pool_output_shape(
+        const Shape& input_shape,
         const std::string& auto_pad,
         const int ceil_mode,
         const std::vector<int>& dilations,
@@ -37,7 +37,7 @@ namespace NodeUtils {
         const std::vector<int>& strides
     ) {
         size_t spacial_rank = kernel_shape.size();
-        std::vector<size_t> output_shape_vector = { input_shape[0], input_shape[1] };
+        Shape output_shape = { input_shape[0], input_shape[1] };
 
         for (size_t i = 0; i < spacial_rank; ++i) {
             int input_dim = input_shape[i + 2];
@@ -69,14 +69,14 @@ namespace NodeUtils {
                 }
             }
 
-            output_shape_vector.push_back(out_dim);
+            output_shape.push_back(out_dim);
         }
-        return array_mml<size_t>(output_shape_vector);
+        return output_shape;
     }
 
     // Follows onnx specifications but onnxruntime does it differently.
     inline std::vector<std::pair<int, int>> compute_pool_pad_begin_end(
-        const array_mml<size_t>& input_shape,
+        const Shape& input_shape,
         const std::string& auto_pad,
         const int ceil_mode,
         const std::vector<int>& dilations,
@@ -51,8 +51,9 @@ public:
    * tensor is not allocated, if multiple -1 values are present in the shape
    * tensor, or if the inferred dimension does not match the total elements.
    */
-  void
-  forward(std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -31,8 +31,9 @@ class SwishNode : public Node {
   /**
    * @brief Perform the forward pass computation applying swish.
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
@@ -35,8 +35,9 @@ class TransposeNode : public Node {
    * @brief Perform the forward pass computation of GEMM.
    *
    */
-  void forward(
-      std::unordered_map<std::string, GeneralDataTypes> &iomap) override;
+  void forward(TensorTable &table, const std::vector<size_t> &inputs,
+               const std::vector<size_t> &outputs) override;
+  using Node::forward;
 
   /**
    * @brief Get inputs.
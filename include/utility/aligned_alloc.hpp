@@ -4,12 +4,15 @@
 #include <memory>
 #include <stdexcept>
 
+#include "utility/allocator.hpp"
+
 /**
  * @brief Function responsible for allocating aligned memory.
  * Instead of allocating an exact amount of memory according to T and data_size
  * memory is padded to be divisable by the provided alignment factorm this
  * ensures that vectorized loads and stores can be safely used without going
- * beyond memory boundraries
+ * beyond memory boundraries. The memory is drawn from Allocator::get_default,
+ * which recycles blocks across inferences.
  *
  * @return shared_ptr to aligned memory for T[]
  *
@@ -23,10 +26,14 @@ std::shared_ptr<T[]> alloc_aligned_memory(size_t data_size) {
   // Rounds up to the nearest value divisiable by the alignment factor
   size_t padded_bytes = ((total_bytes + alignment - 1) / alignment) * alignment;
 
-  void *ptr = nullptr;
-  if (posix_memalign(&ptr, alignment, padded_bytes) != 0) {
-    throw std::bad_alloc();
-  }
-
-  return std::shared_ptr<T[]>(static_cast<T *>(ptr), [](T *ptr) { free(ptr); });
+  // The buffer and its control block come from the default allocator, which
+  // the deleter keeps alive for as long as the buffer is
+  const std::shared_ptr<Allocator> &allocator = Allocator::get_default();
+  T *ptr = static_cast<T *>(allocator->allocate(padded_bytes, alignment));
+  return std::shared_ptr<T[]>(
+      ptr,
+      [allocator, padded_bytes](T *ptr) {
+        allocator->deallocate(ptr, padded_bytes);
+      },
+      AllocatorAdapter<T>(allocator));
 }
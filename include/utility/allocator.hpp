@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/// @brief A snapshot of the work an Allocator has done.
+struct AllocatorStats {
+  /// The allocations served from recycled blocks.
+  size_t hits = 0;
+  /// The allocations that went to the system.
+  size_t misses = 0;
+  /// The bytes of the blocks that are currently handed out.
+  size_t bytes_in_use = 0;
+  /// The bytes of the blocks that are kept for reuse.
+  size_t bytes_cached = 0;
+};
+
+/**
+ * @class Allocator
+ * @brief The interface behind every aligned buffer of array_mml.
+ *
+ * The allocator used for new buffers is chosen with set_default. A buffer
+ * keeps the allocator it came from alive, so the default can be swapped while
+ * buffers from the previous one are still in use.
+ */
+class Allocator {
+ public:
+  virtual ~Allocator() = default;
+
+  /**
+   * @brief Allocates a block of memory.
+   *
+   * @param bytes The size of the block.
+   * @param alignment The alignment of the block, a power of two.
+   * @return A pointer to the block.
+   * @throws std::bad_alloc If the memory could not be allocated.
+   */
+  virtual void *allocate(size_t bytes, size_t alignment) = 0;
+
+  /**
+   * @brief Gives back a block from allocate.
+   *
+   * @param ptr The pointer to the block.
+   * @param bytes The size the block was allocated with.
+   */
+  virtual void deallocate(void *ptr, size_t bytes) = 0;
+
+  /**
+   * @brief Get the statistics of the allocator.
+   *
+   * @return A snapshot of the statistics.
+   */
+  virtual AllocatorStats get_stats() const = 0;
+
+  /**
+   * @brief Sets the allocator used for new buffers. Other threads keep the
+   * previous one alive until they next call get_default.
+   *
+   * @param allocator The allocator, a PoolAllocator by default.
+   */
+  static void set_default(std::shared_ptr<Allocator> allocator);
+
+  /**
+   * @brief Get the allocator used for new buffers. Every thread caches it,
+   * so it takes no lock unless set_default was called since.
+   *
+   * @return The allocator, as cached by the calling thread.
+   */
+  static const std::shared_ptr<Allocator> &get_default();
+};
+
+/**
+ * @class SystemAllocator
+ * @brief An Allocator that asks the system for every block.
+ */
+class SystemAllocator : public Allocator {
+ public:
+  void *allocate(size_t bytes, size_t alignment) override;
+  void deallocate(void *ptr, size_t bytes) override;
+  AllocatorStats get_stats() const override;
+
+ private:
+  std::atomic<size_t> misses = 0;
+  std::atomic<size_t> bytes_in_use = 0;
+};
+
+/**
+ * @class PoolAllocator
+ * @brief An Allocator that recycles blocks by size class.
+ *
+ * Requests are rounded up to a size class, with four classes per power of
+ * two, so a freed block can serve any later request of the same class. Small
+ * blocks are first kept in a cache of the thread that freed them, which needs
+ * no locking, and otherwise go to a shared list of their class. Blocks are
+ * kept until trim is called, so once every size has been seen, repeated
+ * inferences do not allocate from the system at all. Blocks larger than
+ * 64 MiB are not pooled and go back to the system when they are freed.
+ */
+class PoolAllocator : public Allocator,
+                      public std::enable_shared_from_this<PoolAllocator> {
+ public:
+  PoolAllocator();
+  ~PoolAllocator() override;
+
+  void *allocate(size_t bytes, size_t alignment) override;
+  void deallocate(void *ptr, size_t bytes) override;
+  AllocatorStats get_stats() const override;
+
+  /**
+   * @brief Gives the blocks kept for reuse in the shared lists back to the
+   * system.
+   */
+  void trim();
+
+ private:
+  friend struct PoolThreadCache;
+
+  // The alignment of every pooled block, larger alignments are not reused
+  static constexpr size_t BLOCK_ALIGNMENT = 64;
+  // The size of the smallest class
+  static constexpr size_t MIN_BLOCK_BYTES = 64;
+  // Larger blocks are not pooled, so one-off buffers are not held on to
+  static constexpr size_t MAX_BLOCK_BYTES = size_t(1) << 26;
+
+  struct SizeClass {
+    std::mutex mutex;
+    std::vector<void *> blocks;
+  };
+
+  std::vector<SizeClass> classes;
+  std::atomic<size_t> hits = 0;
+  std::atomic<size_t> misses = 0;
+  std::atomic<size_t> bytes_in_use = 0;
+  std::atomic<size_t> bytes_cached = 0;
+
+  // Helpers mapping a size to its class and back
+  static size_t class_index(size_t bytes);
+  static size_t class_bytes(size_t index);
+
+  // Helper to give a block back to the shared list of its class
+  void release(size_t index, void *ptr);
+};
+
+/**
+ * @brief A standard allocator over an Allocator, so that containers and the
+ * control blocks of shared pointers can draw from a pool as well.
+ *
+ * @tparam U The type of the allocated objects.
+ */
+template <typename U>
+struct AllocatorAdapter {
+  using value_type = U;
+
+  explicit AllocatorAdapter(std::shared_ptr<Allocator> allocator)
+      : allocator(std::move(allocator)) {}
+
+  template <typename V>
+  AllocatorAdapter(const AllocatorAdapter<V> &other)
+      : allocator(other.allocator) {}
+
+  U *allocate(size_t n) {
+    return static_cast<U *>(allocator->allocate(n * sizeof(U), alignof(U)));
+  }
+
+  void deallocate(U *ptr, size_t n) {
+    allocator->deallocate(ptr, n * sizeof(U));
+  }
+
+  template <typename V>
+  bool operator==(const AllocatorAdapter<V> &other) const {
+    return allocator == other.allocator;
+  }
+
+  std::shared_ptr<Allocator> allocator;
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+
+/**
+ * @class CpuFeatures
+ * @brief Detects the vector instructions of the CPU at runtime and selects
+ * the kernels the dispatch build runs.
+ *
+ * The dispatch build (-DBUILD=dispatch) contains a scalar, an AVX2+FMA and
+ * an AVX-512 version of its kernels, and picks one by the instruction set
+ * returned by get_isa. It defaults to the MML_ISA environment variable
+ * (scalar, avx2 or avx512), or the best one the CPU supports if it is not
+ * set. An instruction set the CPU does not support is never selected, so
+ * MML_ISA can only lower it. The other builds choose their kernels at
+ * compile time and only report the instruction set.
+ */
+class CpuFeatures {
+ public:
+  CpuFeatures() = delete;  // Prevent instantiation of this class
+
+  /**
+   * @brief The instruction sets there are kernels for, in increasing order.
+   */
+  enum class Isa { SCALAR = 0, AVX2 = 1, AVX512 = 2 };
+
+  /**
+   * @brief Get the best instruction set the CPU and the operating system
+   * support.
+   *
+   * @return AVX512 for AVX-512F, AVX2 for AVX2 with FMA, else SCALAR.
+   */
+  static Isa get_supported();
+
+  /**
+   * @brief Get the instruction set the kernels use.
+   *
+   * @return The instruction set last set, else the one of MML_ISA or the
+   * supported one.
+   */
+  static Isa get_isa();
+
+  /**
+   * @brief Sets the instruction set the kernels use.
+   *
+   * @param isa An instruction set no better than get_supported().
+   * @throws std::invalid_argument If the CPU does not support it.
+   */
+  static void set_isa(Isa isa);
+
+  /**
+   * @brief Get the name of an instruction set, as MML_ISA takes it.
+   *
+   * @param isa The instruction set.
+   * @return "scalar", "avx2" or "avx512".
+   */
+  static std::string to_string(Isa isa);
+
+  /**
+   * @brief Get the instruction set of a name, as MML_ISA takes it.
+   *
+   * @param name "scalar", "avx2" or "avx512".
+   * @return The instruction set.
+   * @throws std::invalid_argument If the name is unknown.
+   */
+  static Isa from_string(const std::string &name);
+
+ private:
+  // The selected instruction set, or -1 before the first get_isa
+  static std::atomic<int> isa;
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include "utility/aligned_alloc.hpp"
+#include "utility/parallel.hpp"
+
+/**
+ * @struct GemmBlock
+ * @brief The rows and columns of C, and the part of K, one task of a
+ * partitioned GEMM computes. Every range is [begin, end).
+ */
+struct GemmBlock {
+  int row_begin;
+  int row_end;
+  int col_begin;
+  int col_end;
+  int k_begin;
+  int k_end;
+};
+
+/**
+ * @class GemmPartition
+ * @brief Splits a GEMM into blocks for the intra-op threads.
+ *
+ * C is cut into a grid of row and column blocks, about two per thread, so a
+ * batch of one still has its columns split. When that grid is smaller than
+ * the number of threads and K is deep, K is split as well. Every part of K
+ * then accumulates into its own buffer, and the buffers are added to C in a
+ * fixed order. The result does not depend on the scheduling, so it is the
+ * same on every run with the same number of threads. The split of K follows
+ * the number of threads, so floating point results can differ in the last
+ * bits between thread counts.
+ */
+class GemmPartition {
+ public:
+  GemmPartition() = delete;  // Prevent instantiation of this class
+
+  /**
+   * @brief The number of blocks of every dimension a GEMM is split into.
+   */
+  struct Grid {
+    int row_parts;
+    int col_parts;
+    int k_parts;
+  };
+
+  /**
+   * @brief Get the grid for a GEMM on the current number of threads.
+   *
+   * @param M The number of rows of C.
+   * @param N The number of columns of C.
+   * @param K The depth of the product.
+   * @param row_step The multiple of rows a block starts at.
+   * @param col_step The multiple of columns a block starts at.
+   * @return The number of parts of M, N and K.
+   */
+  static Grid grid(int M, int N, int K, int row_step, int col_step);
+
+  /**
+   * @brief Runs a GEMM kernel on every block of the grid.
+   *
+   * The kernel is called as `kernel(block, beta, c, ldc)` and computes
+   * c = ALPHA * A * B + beta * c over the block, where c is indexed like C
+   * by the absolute row and column. The first part of K gets C and BETA,
+   * the others a buffer and a beta of 0.
+   *
+   * @param M The number of rows of C.
+   * @param N The number of columns of C.
+   * @param K The depth of the product.
+   * @param row_step The multiple of rows a block starts at.
+   * @param col_step The multiple of columns a block starts at.
+   * @param BETA The factor of C.
+   * @param C The M x N output.
+   * @param ldc The row stride of C.
+   * @param kernel The kernel computing one block.
+   */
+  template <typename T, typename Kernel>
+  static void run(int M, int N, int K, int row_step, int col_step, T BETA,
+                  T *C, size_t ldc, const Kernel &kernel);
+
+ private:
+  // Rough number of multiply-adds below which a block costs more to
+  // schedule than it saves
+  static constexpr size_t MIN_BLOCK_COST = 1 << 16;
+
+  // Blocks per thread, so a thread that finishes early can take over work
+  static constexpr size_t BLOCKS_PER_THREAD = 2;
+
+  // Shallowest part of K worth its own buffer and reduction
+  static constexpr int MIN_K_PART = 256;
+
+  // Helper for the bounds of part i of n of a range, in multiples of step
+  static void part(int size, int step, int parts, int i, int &begin,
+                   int &end);
+};
+
+template <typename T, typename Kernel>
+void GemmPartition::run(int M, int N, int K, int row_step, int col_step,
+                        T BETA, T *C, size_t ldc, const Kernel &kernel) {
+  if (M <= 0 || N <= 0) return;
+
+  const Grid g = grid(M, N, K, row_step, col_step);
+  const size_t blocks = static_cast<size_t>(g.row_parts) * g.col_parts;
+  const size_t matrix = static_cast<size_t>(M) * N;
+
+  // The parts of K past the first accumulate into buffers of M x N, which
+  // come from the pool so that repeated calls reuse them
+  std::shared_ptr<T[]> partials;
+  if (g.k_parts > 1) {
+#ifdef ALIGN_TENSORS
+    partials = alloc_aligned_memory<T>((g.k_parts - 1) * matrix);
+#else
+    partials = std::shared_ptr<T[]>(new T[(g.k_parts - 1) * matrix]);
+#endif
+  }
+
+  Parallel::parallel_for(
+      0, blocks * g.k_parts, 1, [&](size_t task_begin, size_t task_end) {
+        for (size_t task = task_begin; task < task_end; task++) {
+          const int k_part = static_cast<int>(task / blocks);
+          const int row_part = static_cast<int>(task % blocks) / g.col_parts;
+          const int col_part = static_cast<int>(task % blocks) % g.col_parts;
+          GemmBlock block;
+          part(M, row_step, g.row_parts, row_part, block.row_begin,
+               block.row_end);
+          part(N, col_step, g.col_parts, col_part, block.col_begin,
+               block.col_end);
+          part(K, 1, g.k_parts, k_part, block.k_begin, block.k_end);
+          if (k_part == 0) {
+            kernel(block, BETA, C, ldc);
+          } else {
+            kernel(block, T(0), partials.get() + (k_part - 1) * matrix,
+                   static_cast<size_t>(N));
+          }
+        }
+      });
+
+  if (g.k_parts == 1) return;
+  Parallel::parallel_for(
+      0, M, Parallel::grain_for(static_cast<size_t>(N) * g.k_parts),
+      [&](size_t row_begin, size_t row_end) {
+        for (size_t i = row_begin; i < row_end; i++) {
+          T *c = C + i * ldc;
+          for (int p = 0; p < g.k_parts - 1; p++) {
+            const T *partial = partials.get() + p * matrix + i * N;
+            for (int j = 0; j < N; j++) c[j] = c[j] + partial[j];
+          }
+        }
+      });
+}
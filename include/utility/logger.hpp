@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+/// The most verbose level compiled in, 0 = off, 1 = errors, 2 = trace.
+#ifndef MML_MAX_LOG_LEVEL
+#define MML_MAX_LOG_LEVEL 2
+#endif
+
+/// @brief The levels of the Logger, every level includes the ones before it.
+enum class LogLevel { Off = 0, Error = 1, Trace = 2 };
+
+/**
+ * @class Logger
+ * @brief A thread safe logger for the inference path.
+ *
+ * A message is only formatted if its level is enabled. Levels above
+ * MML_MAX_LOG_LEVEL are removed at compile time, so a build with
+ * MML_MAX_LOG_LEVEL=0 pays nothing for the log statements.
+ */
+class Logger {
+ public:
+  Logger() = delete;  // Prevent instantiation of this class
+
+  /**
+   * @brief Sets the most verbose level that is written.
+   *
+   * @param level The level, levels above MML_MAX_LOG_LEVEL stay disabled.
+   */
+  static void set_level(LogLevel level);
+
+  /**
+   * @brief Get the most verbose level that is written.
+   *
+   * @return The level, Error by default.
+   */
+  static LogLevel get_level();
+
+  /**
+   * @brief Checks whether messages of a level are written.
+   *
+   * @tparam Level The level to check.
+   * @return True if the level is compiled in and enabled.
+   */
+  template <LogLevel Level>
+  static bool enabled() {
+    if constexpr (static_cast<int>(Level) > MML_MAX_LOG_LEVEL) {
+      return false;
+    } else {
+      return static_cast<int>(Level) <=
+             static_cast<int>(level.load(std::memory_order_relaxed));
+    }
+  }
+
+  /**
+   * @brief Writes a message if its level is enabled.
+   *
+   * Errors go to standard error and trace to standard output, one line per
+   * message.
+   *
+   * @tparam Level The level of the message.
+   * @param args The parts of the message, streamed one after another.
+   */
+  template <LogLevel Level, typename... Args>
+  static void log(const Args &...args) {
+    if constexpr (static_cast<int>(Level) <= MML_MAX_LOG_LEVEL) {
+      if (enabled<Level>()) {
+        std::ostringstream message;
+        (message << ... << args);
+        write(Level, message.str());
+      }
+    }
+  }
+
+ private:
+  static std::atomic<LogLevel> level;
+  static std::mutex mutex;
+
+  // Helper std::function writing one line without interleaving other threads
+  static void write(LogLevel level, const std::string &message);
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "utility/thread_pool.hpp"
+
+/**
+ * @class Parallel
+ * @brief The one place configuring the threads used inside the kernels.
+ *
+ * All kernels split their work through Parallel::parallel_for, which runs on
+ * a single project-wide work-stealing ThreadPool. The number of threads
+ * defaults to the MML_NUM_THREADS environment variable, or the number of
+ * hardware threads if it is not set or not a positive number, which is
+ * logged as an error. Setting MML_PIN_THREADS to 1 pins the
+ * workers to their own core from the start.
+ */
+class Parallel {
+ public:
+  Parallel() = delete;  // Prevent instantiation of this class
+
+  /**
+   * @brief Sets the number of threads the kernels use.
+   *
+   * @param num_threads The number of threads including the calling thread, one
+   * runs every kernel on the calling thread.
+   */
+  static void set_num_threads(size_t num_threads);
+
+  /**
+   * @brief Get the number of threads the kernels use.
+   *
+   * @return The number of threads including the calling thread.
+   */
+  static size_t get_num_threads();
+
+  /**
+   * @brief Sets whether the worker threads are pinned to their own core.
+   *
+   * @param pin_threads True to pin the workers.
+   */
+  static void set_pin_threads(bool pin_threads);
+
+  /**
+   * @brief Get whether the worker threads are pinned to their own core.
+   *
+   * @return True if the workers are pinned.
+   */
+  static bool get_pin_threads();
+
+  /**
+   * @brief Runs a loop body over a range on the intra-op threads.
+   *
+   * @param begin The start of the range.
+   * @param end The end of the range, exclusive.
+   * @param grain The minimum number of iterations in a chunk.
+   * @param body The loop body, called with the bounds of a chunk.
+   */
+  static void parallel_for(size_t begin, size_t end, size_t grain,
+                           const std::function<void(size_t, size_t)> &body);
+
+  /**
+   * @brief Get the grain for a loop so that a chunk is worth a thread.
+   *
+   * @param cost_per_iteration The rough number of operations per iteration.
+   * @return The minimum number of iterations in a chunk.
+   */
+  static size_t grain_for(size_t cost_per_iteration);
+
+  /**
+   * @brief Finds the first index in a range that satisfies a predicate, on
+   * the intra-op threads.
+   *
+   * The predicate is evaluated on whole blocks without branching, so the
+   * compiler can vectorise it, and the threads stop at the first block past
+   * a match that has already been found.
+   *
+   * @param begin The start of the range.
+   * @param end The end of the range, exclusive.
+   * @param cost_per_iteration The rough number of operations of the
+   * predicate.
+   * @param pred The predicate, called as `bool pred(size_t index)`.
+   * @return The first index satisfying the predicate, or end if none does.
+   */
+  template <typename P>
+  static size_t find_first(size_t begin, size_t end, size_t cost_per_iteration,
+                           const P &pred);
+
+ private:
+  // Number of indices find_first tests between looking for an earlier match
+  static constexpr size_t FIND_BLOCK = 1024;
+
+  // Rough number of operations below which splitting costs more than it gains
+  static constexpr size_t MIN_CHUNK_COST = 1 << 15;
+
+  static std::mutex mutex;
+  static std::shared_ptr<ThreadPool> pool;
+  // Read without the mutex on every parallel_for, 0 until first used
+  static std::atomic<size_t> num_threads;
+  static bool pin_threads;
+
+  // Helper std::function returning the pool, creating it on first use
+  static std::shared_ptr<ThreadPool> get_pool();
+};
+
+template <typename P>
+size_t Parallel::find_first(size_t begin, size_t end,
+                            size_t cost_per_iteration, const P &pred) {
+  std::atomic<size_t> first{end};
+  parallel_for(begin, end, grain_for(cost_per_iteration),
+               [&](size_t chunk_begin, size_t chunk_end) {
+                 for (size_t block = chunk_begin; block < chunk_end;
+                      block += FIND_BLOCK) {
+                   if (block >= first.load(std::memory_order_relaxed)) {
+                     return;
+                   }
+                   size_t block_end = std::min(block + FIND_BLOCK, chunk_end);
+                   bool found = false;
+                   for (size_t i = block; i < block_end; i++) {
+                     found |= pred(i);
+                   }
+                   if (!found) continue;
+
+                   size_t i = block;
+                   while (!pred(i)) i++;
+                   size_t current = first.load(std::memory_order_relaxed);
+                   while (i < current &&
+                          !first.compare_exchange_weak(current, i)) {
+                   }
+                   return;
+                 }
+               });
+  return first.load();
+}
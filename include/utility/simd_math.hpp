@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief The accuracy tiers of the SimdMath functions.
+ */
+enum class MathAccuracy {
+  /// The C++ standard library, one element at a time.
+  EXACT,
+  /// Polynomial approximations using the vector instructions the library was
+  /// built with, see SimdMath for the error bounds.
+  FAST
+};
+
+/**
+ * @class SimdMath
+ * @brief Transcendental functions applied to arrays of floats.
+ *
+ * Every function reads n elements from in and writes n elements to out, which
+ * may be the same array. The tier is chosen once for the whole library with
+ * set_accuracy, or the MML_MATH_ACCURACY environment variable set to "exact"
+ * or "fast", and defaults to FAST.
+ *
+ * The FAST tier runs on AVX-512 or AVX2 when the library is built with them,
+ * and on the same polynomials in scalar code otherwise. Its largest error
+ * measured against double precision, in units in the last place:
+ *
+ * | Function | Max error | Notes                                          |
+ * |----------|-----------|------------------------------------------------|
+ * | exp      | 1.1 ULP   | 0 below -87.3, infinity above 88.7             |
+ * | log      | 0.9 ULP   | -infinity at 0, NaN below 0                    |
+ * | tanh     | 1.4 ULP   |                                                |
+ * | sigmoid  | 2.5 ULP   | subnormal results, below -87.3, may flush to 0 |
+ * | erf      | 7.5 ULP   | the largest errors are close to +-1            |
+ *
+ * NaN inputs give NaN outputs in both tiers.
+ */
+class SimdMath {
+ public:
+  SimdMath() = delete;  // Prevent instantiation of this class
+
+  /**
+   * @brief Sets the accuracy tier of all the functions.
+   *
+   * @param accuracy The accuracy tier.
+   */
+  static void set_accuracy(MathAccuracy accuracy);
+
+  /**
+   * @brief Get the accuracy tier of all the functions.
+   *
+   * @return The accuracy tier.
+   */
+  static MathAccuracy get_accuracy();
+
+  /**
+   * @brief out[i] = e^in[i].
+   *
+   * @param in The input elements.
+   * @param out The output elements, may be the same as in.
+   * @param n The number of elements.
+   */
+  static void exp(const float *in, float *out, size_t n);
+
+  /**
+   * @brief out[i] = ln(in[i]).
+   *
+   * @param in The input elements.
+   * @param out The output elements, may be the same as in.
+   * @param n The number of elements.
+   */
+  static void log(const float *in, float *out, size_t n);
+
+  /**
+   * @brief out[i] = tanh(in[i]).
+   *
+   * @param in The input elements.
+   * @param out The output elements, may be the same as in.
+   * @param n The number of elements.
+   */
+  static void tanh(const float *in, float *out, size_t n);
+
+  /**
+   * @brief out[i] = 1 / (1 + e^-in[i]).
+   *
+   * @param in The input elements.
+   * @param out The output elements, may be the same as in.
+   * @param n The number of elements.
+   */
+  static void sigmoid(const float *in, float *out, size_t n);
+
+  /**
+   * @brief out[i] = erf(in[i]).
+   *
+   * @param in The input elements.
+   * @param out The output elements, may be the same as in.
+   * @param n The number of elements.
+   */
+  static void erf(const float *in, float *out, size_t n);
+
+ private:
+  static std::atomic<int> accuracy;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A fixed set of work-stealing worker threads executing tasks.
+ *
+ * Every worker owns a queue. Tasks submitted by a worker go to its own queue,
+ * other tasks are spread over the queues. A worker runs the newest task of its
+ * own queue first, and steals the oldest task of another queue when its own is
+ * empty. The threads are started once in the constructor and joined in the
+ * destructor, so submitting a task never creates a thread.
+ */
+class ThreadPool {
+ public:
+  /**
+   * @brief Constructor for ThreadPool.
+   *
+   * @param num_threads The number of worker threads, at least one.
+   * @param pin_threads Whether to pin each worker to its own core. Only the
+   * cores the process may run on are used, worker i is pinned to the one
+   * after the first i of them, leaving the first to the thread that owns the
+   * pool. Ignored on platforms without thread affinity.
+   */
+  explicit ThreadPool(size_t num_threads, bool pin_threads = false);
+
+  /**
+   * @brief Destructor for ThreadPool.
+   *
+   * Finishes the tasks that are already queued and joins the workers.
+   */
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  /**
+   * @brief Queues a task for execution on one of the workers.
+   *
+   * @param task The task to execute.
+   * @return A future that becomes ready when the task has finished, and
+   * rethrows any exception thrown by the task.
+   */
+  std::future<void> submit(std::function<void()> task);
+
+  /**
+   * @brief Runs a loop body over a range, split in chunks across the workers.
+   *
+   * The calling thread works on the chunks as well, so parallel_for can be
+   * called from within a task of the pool without deadlocking. The body is
+   * called with disjoint sub ranges [chunk_begin, chunk_end) covering the
+   * whole range, possibly concurrently.
+   *
+   * @param begin The start of the range.
+   * @param end The end of the range, exclusive.
+   * @param grain The minimum number of iterations in a chunk.
+   * @param body The loop body, called with the bounds of a chunk.
+   * @throws The first exception thrown by the body, after every chunk that
+   * was started has finished.
+   */
+  void parallel_for(size_t begin, size_t end, size_t grain,
+                    const std::function<void(size_t, size_t)> &body);
+
+  /**
+   * @brief Get the number of worker threads.
+   *
+   * @return The number of worker threads.
+   */
+  size_t get_num_threads() const;
+
+ private:
+  struct WorkerQueue {
+    std::deque<std::packaged_task<void()>> tasks;
+    std::mutex mutex;
+  };
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues;
+  std::vector<std::thread> workers;
+
+  // Sleeping workers wait for pending to become non-zero
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::atomic<size_t> pending = 0;
+  std::atomic<size_t> next_queue = 0;
+  bool stopping = false;
+
+  // Helper std::function run by every worker, executes tasks until stopped
+  void worker_loop(size_t index);
+
+  // Helper std::function taking a task from the own queue or stealing one
+  bool try_pop(size_t index, std::packaged_task<void()> &task);
+};
@@ -1,7 +1,11 @@
 #include <immintrin.h>
 
+#include <algorithm>
+
+#include "datastructures/packed_gemm.hpp"
 #include "datastructures/tensor_operations.hpp"
 #include "utility/avx_mask_helper.hpp"
+#include "utility/gemm_partition.hpp"
 
 template <typename T>
 void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
@@ -11,150 +15,97 @@ void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
   if (!A || !B || !C) {
     throw std::invalid_argument("GEMM received null tensor(s)");
   }
-  if (TA == 1) A = A->transpose();
-  if (TB == 1) B = B->transpose();
-
-  // Validate
-  auto a_shape = A->get_shape();
-  auto b_shape = B->get_shape();
-  auto c_shape = C->get_shape();
 
-  if (a_shape[0] != M || a_shape[1] != K)
-    throw std::invalid_argument("Matrix A shape does not match M x K");
+  // Validate the matrices as they are stored, a transposed operand has its
+  // dimensions swapped and a row may be longer than the leading dimension
+  // needs
+  const size_t a_rows = TA == 1 ? K : M, a_cols = TA == 1 ? M : K;
+  const size_t b_rows = TB == 1 ? N : K, b_cols = TB == 1 ? K : N;
+  if (M > 0 && N > 0 && K > 0) {
+    if (A->get_size() < (a_rows - 1) * lda + a_cols)
+      throw std::invalid_argument("Matrix A is too small for M x K");
 
-  if (b_shape[0] != K || b_shape[1] != N)
-    throw std::invalid_argument("Matrix B shape does not match K x N");
+    if (B->get_size() < (b_rows - 1) * ldb + b_cols)
+      throw std::invalid_argument("Matrix B is too small for K x N");
 
-  if (c_shape[0] != M || c_shape[1] != N)
-    throw std::invalid_argument("Matrix C shape does not match M x N");
+    if (C->get_size() < static_cast<size_t>(M - 1) * ldc + N)
+      throw std::invalid_argument("Matrix C is too small for M x N");
+  }
 
-  // Get the pointers to the raw data
-  T *a_data = A->get_raw_data().get();
-  T *b_data = B->get_raw_data().get();
+  // Get the pointers to the raw data, A and B are only read so a buffer they
+  // share with a copy is not made unique
+  const T *a_data = std::as_const(*A).get_data().get();
+  const T *b_data = std::as_const(*B).get_data().get();
   T *c_data = C->get_raw_data().get();
 
-  int i, j, k;
-  int i_col, k_col, i_col_out;
-
-  int simd = (512 / 8) / sizeof(T);
-  int elem_left = N % simd;
-
-  int N_s = elem_left ? N - simd : N;
-  if constexpr (std::is_same<T, float>::value) {
-    __m512 a_s, b_s, c_vals;
-
-    auto mask = make_avx512_mask<T>(elem_left);
-    __m512 beta_s = _mm512_set1_ps(BETA);
-
-    for (int i = 0; i < M; i++) {
-      i_col = i * lda;
-      i_col_out = i * ldc;
-
-      for (j = 0; j < N_s; j += simd) {
-        c_vals = _mm512_loadu_ps(c_data + i * ldc + j);
-        c_vals = _mm512_mul_ps(beta_s, c_vals);
-
-        for (int k = 0; k < K; k++) {
-          k_col = k * ldb;
-          float a = ALPHA * a_data[i_col + k];
-          __m512 a_vals = _mm512_set1_ps(a);
-          __m512 b_vals = _mm512_loadu_ps(b_data + k_col + j);
-          c_vals = _mm512_fmadd_ps(a_vals, b_vals, c_vals);
-        }
-        _mm512_storeu_ps(c_data + i * ldc + j, c_vals);
-      }
-      if (elem_left) {
-        c_vals = _mm512_loadu_ps(c_data + i_col_out + j);
-        c_vals = _mm512_mul_ps(beta_s, c_vals);
-        for (k = 0; k < K; k++) {
-          k_col = k * ldb;
-          float a = ALPHA * a_data[i_col + k];
-          a_s = _mm512_set1_ps(a);
-          b_s = _mm512_loadu_ps(b_data + k_col + j);
-          c_vals = _mm512_fmadd_ps(a_s, b_s, c_vals);
-        }
-        _mm512_mask_storeu_ps(c_data + i_col_out + j, mask, c_vals);
-      }
-    }
-  } else if constexpr (std::is_same<T, double>::value) {
-    __m512d a_s, b_s, c_vals;
-
-    auto mask = make_avx512_mask<T>(elem_left);
-    __m512d beta_s = _mm512_set1_pd(BETA);
-
-    for (int i = 0; i < M; i++) {
-      i_col = i * lda;
-      i_col_out = i * ldc;
-
-      for (j = 0; j < N_s; j += simd) {
-        c_vals = _mm512_loadu_pd(c_data + i * ldc + j);
-        c_vals = _mm512_mul_pd(beta_s, c_vals);
-
-        for (int k = 0; k < K; k++) {
-          k_col = k * ldb;
-          double a = ALPHA * a_data[i_col + k];
-          __m512d a_vals = _mm512_set1_pd(a);
-          __m512d b_vals = _mm512_loadu_pd(b_data + k_col + j);
-          c_vals = _mm512_fmadd_pd(a_vals, b_vals, c_vals);
-        }
-        _mm512_storeu_pd(c_data + i * ldc + j, c_vals);
-      }
-      if (elem_left) {
-        c_vals = _mm512_loadu_pd(c_data + i_col_out + j);
-        c_vals = _mm512_mul_pd(beta_s, c_vals);
-        for (k = 0; k < K; k++) {
-          k_col = k * ldb;
-          double a = ALPHA * a_data[i_col + k];
-          a_s = _mm512_set1_pd(a);
-          b_s = _mm512_loadu_pd(b_data + k_col + j);
-          c_vals = _mm512_fmadd_pd(a_s, b_s, c_vals);
-        }
-        _mm512_mask_storeu_pd(c_data + i_col_out + j, mask, c_vals);
-      }
-    }
+  // The transposes are read in place, through swapped strides
+  const int a_row_stride = TA == 1 ? 1 : lda;
+  const int a_col_stride = TA == 1 ? lda : 1;
+  const int b_row_stride = TB == 1 ? 1 : ldb;
+  const int b_col_stride = TB == 1 ? ldb : 1;
+
+  if constexpr (std::is_same<T, float>::value ||
+                std::is_same<T, double>::value) {
+    // The packed kernel reuses every loaded element of A and B for a whole
+    // 12 row tile, where a row at a time streamed all of B for every row.
+    // Each block of the partition is a GEMM of its own.
+    GemmPartition::run(
+        M, N, K, PackedGemm<T>::tile_rows(), PackedGemm<T>::tile_cols(),
+        BETA, c_data, static_cast<size_t>(ldc),
+        [&](const GemmBlock &block, T beta, T *out, size_t ld_out) {
+          PackedGemm<T>::gemm(
+              TA, TB, block.row_end - block.row_begin,
+              block.col_end - block.col_begin, block.k_end - block.k_begin,
+              ALPHA,
+              a_data + block.row_begin * a_row_stride +
+                  block.k_begin * a_col_stride,
+              lda,
+              b_data + block.k_begin * b_row_stride +
+                  block.col_begin * b_col_stride,
+              ldb, beta, out + block.row_begin * ld_out + block.col_begin,
+              ld_out);
+        });
   } else if constexpr (std::is_same<T, int>::value) {
-    __m512i a_s, b_s, c_vals;
-
-    auto mask = make_avx512_mask<T>(elem_left);
-    __m512i beta_s = _mm512_set1_epi32(BETA);
-
-    for (int i = 0; i < M; i++) {
-      i_col = i * lda;
-      i_col_out = i * ldc;
-
-      for (j = 0; j < N_s; j += simd) {
-        c_vals = _mm512_loadu_si512(
-            reinterpret_cast<const __m512i *>(c_data + i * ldc + j));
-        c_vals = _mm512_mullo_epi32(beta_s, c_vals);
-
-        for (int k = 0; k < K; k++) {
-          k_col = k * ldb;
-          int a = ALPHA * a_data[i_col + k];
-          a_s = _mm512_set1_epi32(a);
-          b_s = _mm512_loadu_si512(
-              reinterpret_cast<const __m512i *>(b_data + k_col + j));
-          __m512i mul = _mm512_mullo_epi32(a_s, b_s);
-          c_vals = _mm512_add_epi32(mul, c_vals);
-        }
-        _mm512_storeu_si512(reinterpret_cast<__m512i *>(c_data + i * ldc + j),
-                            c_vals);
-      }
-      if (elem_left) {
-        c_vals = _mm512_loadu_si512(
-            reinterpret_cast<const __m512i *>(c_data + i * ldc + j));
-        c_vals = _mm512_mul_epi32(beta_s, c_vals);
-        for (k = 0; k < K; k++) {
-          k_col = k * ldb;
-          int a = ALPHA * a_data[i_col + k];
-          a_s = _mm512_set1_epi32(a);
-          b_s = _mm512_loadu_si512(
-              reinterpret_cast<const __m512i *>(b_data + k_col + j));
-          __m512i mul = _mm512_mullo_epi32(a_s, b_s);
-          c_vals = _mm512_add_epi32(mul, c_vals);
-        }
-        _mm512_mask_storeu_epi32(c_data + i_col_out + j, mask, c_vals);
-      }
-    }
+    const int simd = (512 / 8) / sizeof(T);
+
+    GemmPartition::run(
+        M, N, K, 1, simd, BETA, c_data, static_cast<size_t>(ldc),
+        [&](const GemmBlock &block, T beta, T *out, size_t ld_out) {
+          const __m512i beta_s = _mm512_set1_epi32(beta);
+          // The offsets of the lanes down a column of a transposed B
+          const __m512i b_index = _mm512_mullo_epi32(
+              _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
+                                14, 15),
+              _mm512_set1_epi32(ldb));
+          for (int i = block.row_begin; i < block.row_end; i++) {
+            const T *a_row = a_data + i * a_row_stride;
+            T *c_row = out + i * ld_out;
+
+            // The mask is full for all but the last vector of the last block
+            for (int j = block.col_begin; j < block.col_end; j += simd) {
+              auto mask =
+                  make_avx512_mask<T>(std::min(simd, block.col_end - j));
+              // C is not read for a zero beta, it may be a fresh buffer
+              __m512i c_vals =
+                  beta == 0 ? _mm512_setzero_si512()
+                            : _mm512_mullo_epi32(
+                                  beta_s,
+                                  _mm512_maskz_loadu_epi32(mask, c_row + j));
+              for (int k = block.k_begin; k < block.k_end; k++) {
+                __m512i a_s =
+                    _mm512_set1_epi32(ALPHA * a_row[k * a_col_stride]);
+                __m512i b_s =
+                    TB == 1 ? _mm512_mask_i32gather_epi32(
+                                  _mm512_setzero_si512(), mask, b_index,
+                                  b_data + j * ldb + k, sizeof(T))
+                            : _mm512_maskz_loadu_epi32(mask,
+                                                       b_data + k * ldb + j);
+                c_vals = _mm512_add_epi32(_mm512_mullo_epi32(a_s, b_s), c_vals);
+              }
+              _mm512_mask_storeu_epi32(c_row + j, mask, c_vals);
+            }
+          }
+        });
   } else {
     throw std::runtime_error("AVX512 only supports float, double and int");
   }
@@ -1,4 +1,5 @@
 #include "datastructures/tensor_operations.hpp"
+#include "utility/gemm_partition.hpp"
 
 template <typename T>
 void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
@@ -7,28 +8,63 @@ void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
                                std::shared_ptr<Tensor<T>> C, int ldc) {
   int block_size = 64;  // Can be tuned or made adaptive later
 
-  if (!TA && !TB) {
-    for (int ii = 0; ii < M; ii += block_size) {
-      for (int kk = 0; kk < K; kk += block_size) {
-        for (int jj = 0; jj < N; jj += block_size) {
-          for (int i = ii; i < std::min(ii + block_size, M); i++) {
-            int i_col_A = i * lda;
-            int i_col_C = i * ldc;
-            for (int j = jj; j < std::min(jj + block_size, N); j++) {
-              T acc = (kk == 0 ? BETA * (*C)[i_col_C + j] : (*C)[i_col_C + j]);
-              for (int k = kk; k < std::min(kk + block_size, K); k++) {
-                // Access B row-wise now: B[k * ldb + j]
-                acc += ALPHA * (*A)[i_col_A + k] * (*B)[k * ldb + j];
+  // The spans are unchecked, so the bounds are checked once up front, on the
+  // matrices as they are stored
+  const size_t a_rows = TA == 1 ? K : M;
+  const size_t a_cols = TA == 1 ? M : K;
+  const size_t b_rows = TB == 1 ? N : K;
+  const size_t b_cols = TB == 1 ? K : N;
+  if (M > 0 && N > 0 && K > 0 &&
+      (A->get_size() < (a_rows - 1) * lda + a_cols ||
+       B->get_size() < (b_rows - 1) * ldb + b_cols ||
+       C->get_size() < static_cast<size_t>((M - 1) * ldc + N))) {
+    throw std::invalid_argument("GEMM matrices do not match M, N and K");
+  }
+
+  const T *a = std::as_const(*A).get_span().get_data();
+  const T *b = std::as_const(*B).get_span().get_data();
+  T *c = C->get_span().get_data();
+
+  // Transposed operands are indexed in place. The inner loop runs along K,
+  // which a transposed B has contiguous.
+  const size_t a_row_stride = TA == 1 ? 1 : lda;
+  const size_t a_col_stride = TA == 1 ? lda : 1;
+  const size_t b_row_stride = TB == 1 ? 1 : ldb;
+  const size_t b_col_stride = TB == 1 ? ldb : 1;
+
+  // Every block of the partition is tiled on its own, its first tile of K
+  // applies beta
+  GemmPartition::run(
+      M, N, K, block_size, block_size, BETA, c, static_cast<size_t>(ldc),
+      [&](const GemmBlock &block, T beta, T *out, size_t ld_out) {
+        for (int ii = block.row_begin; ii < block.row_end; ii += block_size) {
+          int i_end = std::min(ii + block_size, block.row_end);
+          for (int kk = block.k_begin; kk < block.k_end; kk += block_size) {
+            int k_end = std::min(kk + block_size, block.k_end);
+            for (int jj = block.col_begin; jj < block.col_end;
+                 jj += block_size) {
+              int j_end = std::min(jj + block_size, block.col_end);
+              for (int i = ii; i < i_end; i++) {
+                const T *a_row = a + i * a_row_stride;
+                T *c_row = out + i * ld_out;
+                for (int j = jj; j < j_end; j++) {
+                  const T *b_col = b + j * b_col_stride;
+                  // A zero beta discards C, it may be uninitialised
+                  T acc = c_row[j];
+                  if (kk == block.k_begin) {
+                    acc = beta == T(0) ? T(0) : beta * acc;
+                  }
+                  for (int k = kk; k < k_end; k++) {
+                    acc += ALPHA * a_row[k * a_col_stride] *
+                           b_col[k * b_row_stride];
+                  }
+                  c_row[j] = acc;
+                }
               }
-              (*C)[i_col_C + j] = acc;
             }
           }
         }
-      }
-    }
-  } else {
-    throw std::invalid_argument("Transposition not supported in blocked GEMM.");
-  }
+      });
 }
 
 #define TYPE(DT) _TENSOR_OPERATIONS(DT)
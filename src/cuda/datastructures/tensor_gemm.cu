@@ -3,14 +3,22 @@
 #include "datastructures/tensor_operations.hpp"
 
 template <typename T>
-__global__ void gemmKernel(int M, int N, int K, T ALPHA, T BETA, const T* A,
-                           int lda, const T* B, int ldb, T* C, int ldc) {
+__global__ void gemmKernel(int TA, int TB, int M, int N, int K, T ALPHA,
+                           T BETA, const T* A, int lda, const T* B, int ldb,
+                           T* C, int ldc) {
   int row = blockIdx.y * blockDim.y + threadIdx.y;
   int col = blockIdx.x * blockDim.x + threadIdx.x;
   if (row < M && col < N) {
+    // A transposed operand is indexed with its strides swapped
+    const int a_row = TA ? 1 : lda, a_col = TA ? lda : 1;
+    const int b_row = TB ? 1 : ldb, b_col = TB ? ldb : 1;
     T sum = 0;
-    for (int i = 0; i < K; ++i) sum += A[row * lda + i] * B[i * ldb + col];
-    C[row * ldc + col] = BETA * C[row * ldc + col] + ALPHA * sum;
+    for (int i = 0; i < K; ++i) {
+      sum += A[row * a_row + i * a_col] * B[i * b_row + col * b_col];
+    }
+    // A zero BETA overwrites C without reading it
+    T scaled = BETA == T(0) ? T(0) : BETA * C[row * ldc + col];
+    C[row * ldc + col] = scaled + ALPHA * sum;
   }
 }
 
@@ -62,16 +70,13 @@ void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
     }
   }
 
-  if (TA) A = A->transpose();
-  if (TB) B = B->transpose();
-
   const T* hA = A->get_data().get();
   const T* hB = B->get_data().get();
   T* hC = const_cast<T*>(C->get_data().get());
 
   T *dA = nullptr, *dB = nullptr, *dC = nullptr;
-  size_t sizeA = sizeof(T) * size_t(lda) * size_t(M);
-  size_t sizeB = sizeof(T) * size_t(ldb) * size_t(K);
+  size_t sizeA = sizeof(T) * size_t(lda) * size_t(TA ? K : M);
+  size_t sizeB = sizeof(T) * size_t(ldb) * size_t(TB ? N : K);
   size_t sizeC = sizeof(T) * size_t(ldc) * size_t(M);
   CUDA_CHECK(cudaMalloc(&dA, sizeA));
   CUDA_CHECK(cudaMalloc(&dB, sizeB));
@@ -85,7 +90,8 @@ void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
   dim3 block(TILE, TILE);
   dim3 grid((N + TILE - 1) / TILE, (M + TILE - 1) / TILE);
   gemmKernel<T>
-      <<<grid, block>>>(M, N, K, ALPHA, BETA, dA, lda, dB, ldb, dC, ldc);
+      <<<grid, block>>>(TA, TB, M, N, K, ALPHA, BETA, dA, lda, dB, ldb, dC,
+                        ldc);
   CUDA_CHECK(cudaGetLastError());
   CUDA_CHECK(cudaDeviceSynchronize());
 
@@ -63,6 +63,9 @@ std::unordered_map<std::string, GeneralDataTypes> mapTensors(
         case 9:  // BOOL
           tensorMap[initName] = ParserHelper::handle_tensor<bool>(init);
           break;
+        case 10:  // FLOAT16
+          tensorMap[initName] = ParserHelper::handle_tensor<fp16_t>(init);
+          break;
         case 11:  // DOUBLE
           tensorMap[initName] = ParserHelper::handle_tensor<double>(init);
           break;
@@ -72,6 +75,9 @@ std::unordered_map<std::string, GeneralDataTypes> mapTensors(
         case 13:  // UINT64
           tensorMap[initName] = ParserHelper::handle_tensor<uint64_t>(init);
           break;
+        case 16:  // BFLOAT16
+          tensorMap[initName] = ParserHelper::handle_tensor<bf16_t>(init);
+          break;
         default:
           throw std::runtime_error(
               std::format("Currently unsupported data type: {}", dataType));
@@ -186,6 +192,8 @@ std::unique_ptr<Model> DataParser::parse(const nlohmann::json &data) {
   // Get the outputs
   std::vector<std::string> outputs = getOutputs(graph);
 
-  // Create the model
-  return std::make_unique<Model>(nodes, iomap, inputs, outputs);
+  // Create the model and compile its execution plan once up front
+  auto model = std::make_unique<Model>(nodes, iomap, inputs, outputs);
+  model->compile();
+  return model;
 }
\ No newline at end of file
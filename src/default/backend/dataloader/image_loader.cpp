@@ -46,9 +46,11 @@ std::shared_ptr<Tensor<float>> ImageLoader::load(
       {1, static_cast<unsigned long int>(output_channels),
        static_cast<unsigned long int>(height),
        static_cast<unsigned long int>(width)});
-  array_mml<float> output_data(data_size);  // Fills with 0:s
+  // Every pixel of the first three channels is written below, a kept alpha
+  // channel is left at zero
   auto output =
-      std::make_shared<Tensor<float>>(image_tensor_shape, output_data);
+      std::make_shared<Tensor<float>>(image_tensor_shape, uninitialized);
+  if (output_channels > 3) output->fill(0.0f);
 
   // The data inside output_data is {R, G, B, R, G, B, ...}
   // So we iterate 3 steps each time and write the R G B for each pixel to the
@@ -91,9 +93,9 @@ std::shared_ptr<Tensor<float>> ImageLoader::load(
       {1, static_cast<unsigned long int>(output_channels),
        static_cast<unsigned long int>(raw.height),
        static_cast<unsigned long int>(raw.width)});
-  array_mml<float> output_data(data_size);
+  // At most three channels are kept and every pixel of them is written below
   std::shared_ptr<Tensor<float>> output =
-      std::make_shared<Tensor<float>>(image_tensor_shape, output_data);
+      std::make_shared<Tensor<float>>(image_tensor_shape, uninitialized);
 
   for (int y = 0; y < raw.height; ++y) {
     for (int x = 0; x < raw.width; ++x) {
@@ -22,16 +22,20 @@ std::shared_ptr<Tensor<float>> Normalize::normalize(
   size_t H = shape[2];
   size_t W = shape[3];
 
-  auto output = std::make_shared<Tensor<float>>(array_mml<size_t>{N, C, H, W});
+  auto output =
+      std::make_shared<Tensor<float>>(Shape{N, C, H, W}, uninitialized);
 
-  // Normalize the input tensor:
-  for (size_t n = 0; n < shape[0]; ++n) {
-    for (size_t c = 0; c < shape[1]; ++c) {
-      for (size_t h = 0; h < shape[2]; ++h) {
-        for (size_t w = 0; w < shape[3]; ++w) {
-          float v = (*input)[{n, c, h, w}];
-          (*output)[{n, c, h, w}] = (v - mean[c]) / std[c];
-        }
+  // Normalize the input tensor, one contiguous channel plane at a time
+  auto in = input->get_span();
+  auto out = output->get_span();
+  for (size_t n = 0; n < N; ++n) {
+    for (size_t c = 0; c < C; ++c) {
+      const float *in_plane = &in(n, c);
+      float *out_plane = &out(n, c);
+      const float channel_mean = mean[c];
+      const float channel_std = std[c];
+      for (size_t i = 0; i < H * W; ++i) {
+        out_plane[i] = (in_plane[i] - channel_mean) / channel_std;
       }
     }
   }
@@ -0,0 +1,198 @@
+#include "backend/execution_plan.hpp"
+
+#include <queue>
+
+ExecutionPlan::ExecutionPlan(const std::vector<std::shared_ptr<Node>> &nodes,
+                             const std::vector<std::string> &initializers,
+                             const std::vector<std::string> &inputs,
+                             const std::vector<std::string> &outputs) {
+  std::vector<std::vector<size_t>> layers = topologicalSort(nodes);
+
+  // Graph inputs and initializers get the lowest slots
+  for (const auto &name : inputs) {
+    input_slots.push_back(resolveSlot(name));
+  }
+  for (const auto &name : initializers) {
+    resolveSlot(name);
+  }
+
+  // Flatten the layers into steps and resolve the tensors they use
+  steps.reserve(nodes.size());
+  layer_offsets.reserve(layers.size() + 1);
+  for (const auto &layer : layers) {
+    layer_offsets.push_back(steps.size());
+    for (size_t node_idx : layer) {
+      Step step;
+      step.node = nodes[node_idx];
+      for (const auto &input : step.node->getInputs()) {
+        step.inputs.push_back(resolveSlot(input));
+      }
+      for (const auto &output : step.node->getOutputs()) {
+        step.outputs.push_back(resolveSlot(output));
+      }
+      steps.push_back(std::move(step));
+    }
+  }
+  layer_offsets.push_back(steps.size());
+
+  for (const auto &name : outputs) {
+    output_slots.push_back(resolveSlot(name));
+  }
+
+  computeLifetimes(initializers);
+}
+
+const std::vector<ExecutionPlan::Step> &ExecutionPlan::getSteps() const {
+  return steps;
+}
+
+const std::vector<size_t> &ExecutionPlan::getLayerOffsets() const {
+  return layer_offsets;
+}
+
+size_t ExecutionPlan::getNumSlots() const { return slot_names.size(); }
+
+const std::string &ExecutionPlan::getSlotName(size_t slot) const {
+  return slot_names.at(slot);
+}
+
+std::optional<size_t> ExecutionPlan::findSlot(const std::string &name) const {
+  auto it = slot_lookup.find(name);
+  if (it == slot_lookup.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+const std::vector<size_t> &ExecutionPlan::getInputSlots() const {
+  return input_slots;
+}
+
+const std::vector<size_t> &ExecutionPlan::getOutputSlots() const {
+  return output_slots;
+}
+
+const std::optional<ExecutionPlan::Lifetime> &ExecutionPlan::getLifetime(
+    size_t slot) const {
+  return lifetimes.at(slot);
+}
+
+const std::vector<size_t> &ExecutionPlan::getReleases(size_t layer) const {
+  return layer_releases.at(layer);
+}
+
+void ExecutionPlan::computeLifetimes(
+    const std::vector<std::string> &initializers) {
+  lifetimes.assign(slot_names.size(), std::nullopt);
+  layer_releases.assign(layer_offsets.size() - 1, {});
+
+  // Tensors provided from outside or returned to the caller are never released
+  std::vector<bool> external(slot_names.size(), false);
+  for (size_t slot : input_slots) external[slot] = true;
+  for (size_t slot : output_slots) external[slot] = true;
+  for (const auto &name : initializers) external[slot_lookup.at(name)] = true;
+
+  for (size_t layer = 0; layer + 1 < layer_offsets.size(); layer++) {
+    for (size_t i = layer_offsets[layer]; i < layer_offsets[layer + 1]; i++) {
+      for (size_t slot : steps[i].inputs) {
+        if (lifetimes[slot]) {
+          lifetimes[slot]->last_layer = layer;
+        }
+      }
+      for (size_t slot : steps[i].outputs) {
+        if (!external[slot] && !lifetimes[slot]) {
+          lifetimes[slot] = Lifetime{layer, layer};
+        }
+      }
+    }
+  }
+
+  for (size_t slot = 0; slot < lifetimes.size(); slot++) {
+    if (lifetimes[slot]) {
+      layer_releases[lifetimes[slot]->last_layer].push_back(slot);
+    }
+  }
+}
+
+size_t ExecutionPlan::resolveSlot(const std::string &name) {
+  auto [it, inserted] = slot_lookup.try_emplace(name, slot_names.size());
+  if (inserted) {
+    slot_names.push_back(name);
+  }
+  return it->second;
+}
+
+std::vector<std::vector<size_t>> ExecutionPlan::topologicalSort(
+    const std::vector<std::shared_ptr<Node>> &nodes) {
+  if (nodes.empty()) {
+    throw std::runtime_error("ComputeGraph has no nodes.");
+  }
+
+  // Create output-to-node mapping (which node produces which tensor)
+  std::unordered_map<std::string, size_t> producerMap;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    for (const auto &output : nodes[i]->getOutputs()) {
+      producerMap[output] = i;
+    }
+  }
+
+  // Calculate in-degrees and build adjacency list
+  std::vector<int> inDegree(nodes.size(), 0);
+  std::vector<std::vector<size_t>> adjacentMap(nodes.size());
+
+  // Build the adjacency list: if node B consumes output from node A, add A → B
+  // edge
+  for (size_t consumer = 0; consumer < nodes.size(); consumer++) {
+    for (const auto &input : nodes[consumer]->getInputs()) {
+      auto producerIt = producerMap.find(input);
+      if (producerIt != producerMap.end()) {
+        size_t producer = producerIt->second;
+        if (producer != consumer) {  // Avoid self-loops
+          adjacentMap[producer].push_back(consumer);
+          inDegree[consumer]++;
+        }
+      }
+      // Inputs that aren't in producerMap are external inputs or initializers
+    }
+  }
+
+  // Queue nodes with zero in-degree
+  std::queue<size_t> q;
+  for (size_t i = 0; i < nodes.size(); i++) {
+    if (inDegree[i] == 0) {
+      q.push(i);
+    }
+  }
+
+  // Perform topological sort
+  std::vector<std::vector<size_t>> layers;
+  size_t processedCount = 0;
+
+  while (!q.empty()) {
+    size_t size = q.size();
+    std::vector<size_t> currentLayer;
+    currentLayer.reserve(size);
+
+    for (size_t i = 0; i < size; i++) {
+      size_t node = q.front();
+      q.pop();
+
+      currentLayer.push_back(node);
+      processedCount++;
+
+      for (size_t adjacentNode : adjacentMap[node]) {
+        if (--inDegree[adjacentNode] == 0) {
+          q.push(adjacentNode);
+        }
+      }
+    }
+    layers.push_back(std::move(currentLayer));
+  }
+
+  // Check for cycles
+  if (processedCount != nodes.size()) {
+    throw std::runtime_error("ComputeGraph has a cycle.");
+  }
+
+  return layers;
+}
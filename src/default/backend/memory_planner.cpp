@@ -0,0 +1,81 @@
+#include "backend/memory_planner.hpp"
+
+#include <limits>
+
+MemoryPlanner::MemoryPlanner(const ExecutionPlan &plan,
+                             const std::vector<size_t> &slot_bytes) {
+  const size_t alignment = getAlignment();
+
+  for (size_t slot = 0; slot < slot_bytes.size(); slot++) {
+    if (slot_bytes[slot] == 0 || !plan.getLifetime(slot)) {
+      continue;
+    }
+    // Rounds up to the nearest value divisible by the alignment, like
+    // alloc_aligned_memory does
+    size_t padded_bytes =
+        ((slot_bytes[slot] + alignment - 1) / alignment) * alignment;
+    allocations.push_back({slot, 0, padded_bytes});
+    naive_bytes += padded_bytes;
+  }
+
+  // Place the largest tensors first, they are the hardest to fit in a gap
+  std::vector<size_t> order(allocations.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return allocations[a].bytes > allocations[b].bytes;
+  });
+
+  auto overlaps = [&](const Allocation &a, const Allocation &b) {
+    const auto &life_a = *plan.getLifetime(a.slot);
+    const auto &life_b = *plan.getLifetime(b.slot);
+    return life_a.first_layer <= life_b.last_layer &&
+           life_b.first_layer <= life_a.last_layer;
+  };
+
+  std::vector<size_t> placed;
+  for (size_t idx : order) {
+    Allocation &current = allocations[idx];
+
+    // Collect the placed tensors that are alive at the same time
+    std::vector<const Allocation *> live;
+    for (size_t other : placed) {
+      if (overlaps(current, allocations[other])) {
+        live.push_back(&allocations[other]);
+      }
+    }
+    std::sort(live.begin(), live.end(),
+              [](const Allocation *a, const Allocation *b) {
+                return a->offset < b->offset;
+              });
+
+    // Find the smallest gap between the live tensors that fits
+    size_t best_offset = 0;
+    size_t best_gap = std::numeric_limits<size_t>::max();
+    size_t gap_start = 0;
+    bool found = false;
+    for (const Allocation *other : live) {
+      if (other->offset >= gap_start) {
+        size_t gap = other->offset - gap_start;
+        if (gap >= current.bytes && gap < best_gap) {
+          best_offset = gap_start;
+          best_gap = gap;
+          found = true;
+        }
+      }
+      gap_start = std::max(gap_start, other->offset + other->bytes);
+    }
+    current.offset = found ? best_offset : gap_start;
+
+    peak_bytes = std::max(peak_bytes, current.offset + current.bytes);
+    placed.push_back(idx);
+  }
+}
+
+const std::vector<MemoryPlanner::Allocation> &MemoryPlanner::getAllocations()
+    const {
+  return allocations;
+}
+
+size_t MemoryPlanner::getPeakBytes() const { return peak_bytes; }
+
+size_t MemoryPlanner::getNaiveBytes() const { return naive_bytes; }
@@ -1,175 +1,304 @@
 #include "backend/model.hpp"
 
+#include "utility/logger.hpp"
+
 std::unordered_map<std::string, GeneralDataTypes> Model::infer(
     const std::unordered_map<std::string, GeneralDataTypes> &inputs) {
-  std::cout << "==== Starting inference ====" << std::endl;
+  Logger::log<LogLevel::Trace>("==== Starting inference ====");
 
   if (nodes.empty()) {
     throw std::runtime_error("ComputeGraph has no nodes.");
   }
 
-  // Perform topological sort
-  std::vector<std::vector<std::shared_ptr<Node>>> topoLayers =
-      topologicalSort();
-  std::cout << "Topological layers: " << topoLayers.size() << std::endl;
+  // Compile the graph on first use, later calls reuse the plan
+  std::unique_lock<std::mutex> lock(plan_mutex);
+  const ExecutionPlan &exec_plan = getPlan();
+  lock.unlock();
+  const auto &steps = exec_plan.getSteps();
+  const auto &layer_offsets = exec_plan.getLayerOffsets();
+  Logger::log<LogLevel::Trace>("Topological layers: ",
+                               layer_offsets.size() - 1);
 
-  // Create a deep copy of iomap
-  std::unordered_map<std::string, GeneralDataTypes> local_iomap;
-  for (const auto &[name, tensor] : iomap) {
-    std::visit(
-        [&](auto &&arg) {
-          // Deep copy
-          local_iomap[name] = arg->copy();
-        },
-        tensor);
-  }
+  // The initializers are shared with every inference instead of copied, the
+  // nodes only read their inputs and allocate their own outputs. Every
+  // inference has its own table, so concurrent ones do not see each other.
+  TensorTable tensor_table = initializer_table;
 
-  // Set input tensors
+  // Set input tensors, these are shared with the caller as well. Inputs no
+  // node uses have no slot and are skipped
   for (const auto &[name, tensor] : inputs) {
-    std::cout << "Setting input: " << name << std::endl;
+    Logger::log<LogLevel::Trace>("Setting input: ", name);
+    if (auto slot = exec_plan.findSlot(name)) {
+      tensor_table[*slot] = tensor;
+    }
+  }
+
+  // Reuse the memory plan as long as the input shapes are unchanged, otherwise
+  // record the intermediates of this inference to plan them anew
+  std::vector<array_mml<size_t>> input_shapes;
+  for (size_t slot : exec_plan.getInputSlots()) {
+    if (!tensor_table.contains(slot)) {
+      input_shapes.emplace_back();
+      continue;
+    }
     std::visit(
-        [&](auto &&arg) {
-          // Deep copy
-          local_iomap[name] = arg->copy();
+        [&](const auto &tensor) {
+          input_shapes.push_back(tensor->get_shape());
         },
-        tensor);
+        tensor_table[slot]);
+  }
+
+  lock.lock();
+  bool record_layouts = !memory_plan || input_shapes != planned_input_shapes;
+  std::shared_ptr<std::byte[]> arena;
+  size_t arena_generation = memory_generation;
+  if (!record_layouts) {
+    arena = takeArena();
+    seedArena(tensor_table, arena);
+  }
+  lock.unlock();
+
+  std::vector<SlotLayout> layouts;
+  if (record_layouts) {
+    layouts.assign(exec_plan.getNumSlots(), SlotLayout{});
   }
 
   // Process each layer
   try {
-    for (size_t layer_idx = 0; layer_idx < topoLayers.size(); ++layer_idx) {
-      const auto &layer = topoLayers[layer_idx];
-      std::cout << "Processing layer " << layer_idx << " with " << layer.size()
-                << " nodes" << std::endl;
-
-      for (size_t node_idx = 0; node_idx < layer.size(); ++node_idx) {
-        const auto &node = layer[node_idx];
-        std::string nodeType = typeid(*node).name();  // Get node type
-        std::cout << "  Processing node " << node_idx << " (type: " << nodeType
-                  << ")" << std::endl;
-
-        try {
-          node->forward(local_iomap);
-          std::cout << "  Node " << node_idx << " processed successfully"
-                    << std::endl;
-        } catch (const std::out_of_range &e) {
-          std::cerr << "*** Out of range error in node " << node_idx
-                    << " (type: " << nodeType << "): " << e.what() << std::endl;
-
-          // Print node inputs and outputs
-          std::cout << "  Node inputs: ";
-          for (const auto &input : node->getInputs()) {
-            std::cout << input << " ";
-          }
-          std::cout << std::endl;
-
-          std::cout << "  Node outputs: ";
-          for (const auto &output : node->getOutputs()) {
-            std::cout << output << " ";
-          }
-          std::cout << std::endl;
-
-          // Rethrow so the test catches it
-          throw;
-        } catch (const std::exception &e) {
-          std::cerr << "*** Error in node " << node_idx
-                    << " (type: " << nodeType << "): " << e.what() << std::endl;
-          throw;
+    for (size_t layer_idx = 0; layer_idx + 1 < layer_offsets.size();
+         ++layer_idx) {
+      size_t layer_begin = layer_offsets[layer_idx];
+      size_t layer_end = layer_offsets[layer_idx + 1];
+      Logger::log<LogLevel::Trace>("Processing layer ", layer_idx, " with ",
+                                   layer_end - layer_begin, " nodes");
+
+      if (inter_op_pool && layer_end - layer_begin > 1) {
+        runLayerParallel(layer_begin, layer_end, tensor_table);
+      } else {
+        for (size_t node_idx = 0; node_idx < layer_end - layer_begin;
+             ++node_idx) {
+          runNode(node_idx, steps[layer_begin + node_idx], tensor_table);
+        }
+      }
+
+      // Release the intermediates that have no consumers left
+      for (size_t slot : exec_plan.getReleases(layer_idx)) {
+        if (!tensor_table.contains(slot)) {
+          continue;
         }
+        if (record_layouts) {
+          std::visit(
+              [&](const auto &tensor) {
+                using TensorType =
+                    typename std::decay_t<decltype(tensor)>::element_type;
+                using ValueType = typename TensorType::value_type;
+                layouts[slot] = {tensor->get_shape(),
+                                 std::shared_ptr<TensorType>(),
+                                 tensor->get_size() * sizeof(ValueType)};
+              },
+              tensor_table[slot]);
+        }
+        tensor_table.erase(slot);
       }
     }
   } catch (const std::exception &e) {
-    std::cerr << "Exception during inference: " << e.what() << std::endl;
+    Logger::log<LogLevel::Error>("Exception during inference: ", e.what());
     throw;
   }
 
   // Get output(s)
   std::unordered_map<std::string, GeneralDataTypes> returnMap;
-  for (const auto &name : outputs) {
-    if (local_iomap.find(name) != local_iomap.end()) {
-      returnMap[name] = local_iomap[name];
+  for (size_t slot : exec_plan.getOutputSlots()) {
+    if (tensor_table.contains(slot)) {
+      returnMap[exec_plan.getSlotName(slot)] = tensor_table[slot];
     }
   }
 
+  // Only the outputs are kept alive, by the caller
+  tensor_table.reset(exec_plan.getNumSlots());
+
+  lock.lock();
+  if (record_layouts) {
+    planMemory(std::move(layouts), input_shapes);
+  } else if (arena.use_count() == 1 &&
+             arena_generation == memory_generation) {
+    // An output that views the arena keeps it for the caller instead
+    idle_arenas.push_back(std::move(arena));
+  }
+
   return returnMap;
 }
 
-std::vector<std::vector<std::shared_ptr<Node>>> Model::topologicalSort() {
-  if (nodes.empty()) {
-    throw std::runtime_error("ComputeGraph has no nodes.");
+void Model::compile() {
+  // Initializers are the tensors known before inference, sorted so that the
+  // slot assignment does not depend on the hash map iteration order
+  std::vector<std::string> initializers;
+  initializers.reserve(iomap.size());
+  for (const auto &[name, tensor] : iomap) {
+    initializers.push_back(name);
   }
+  std::sort(initializers.begin(), initializers.end());
 
-  // Create output-to-node mapping (which node produces which tensor)
-  std::unordered_map<std::string, std::shared_ptr<Node>> producerMap;
-  for (auto &node : nodes) {
-    for (const auto &output : node->getOutputs()) {
-      producerMap[output] = node;
-    }
+  plan.emplace(nodes, initializers, inputs, outputs);
+
+  initializer_table.reset(plan->getNumSlots());
+  for (const auto &[name, tensor] : iomap) {
+    initializer_table[*plan->findSlot(name)] = tensor;
   }
 
-  // Calculate in-degrees and build adjacency list
-  std::unordered_map<std::shared_ptr<Node>, int> inDegree;
-  std::unordered_map<std::shared_ptr<Node>, std::vector<std::shared_ptr<Node>>>
-      adjacentMap;
+  // The slots of the new plan do not match the old memory plan
+  memory_plan.reset();
+  slot_layouts.clear();
+  idle_arenas.clear();
+  memory_generation++;
+}
 
-  // Initialize in-degree to zero for all nodes
-  for (auto &node : nodes) {
-    inDegree[node] = 0;
+const ExecutionPlan &Model::getPlan() {
+  if (!plan) {
+    compile();
   }
+  return *plan;
+}
 
-  // Build the adjacency list: if node B consumes output from node A, add A → B
-  // edge
-  for (auto &consumerNode : nodes) {
-    for (const auto &input : consumerNode->getInputs()) {
-      auto producerIt = producerMap.find(input);
-      if (producerIt != producerMap.end()) {
-        std::shared_ptr<Node> producerNode = producerIt->second;
-        if (producerNode != consumerNode) {  // Avoid self-loops
-          adjacentMap[producerNode].push_back(consumerNode);
-          inDegree[consumerNode]++;
-        }
-      }
-      // Inputs that aren't in producerMap are external inputs or initializers
-    }
+const std::optional<MemoryPlanner> &Model::getMemoryPlan() const {
+  return memory_plan;
+}
+
+std::shared_ptr<std::byte[]> Model::takeArena() {
+  if (!idle_arenas.empty()) {
+    std::shared_ptr<std::byte[]> arena = std::move(idle_arenas.back());
+    idle_arenas.pop_back();
+    return arena;
   }
 
-  // Queue nodes with zero in-degree
-  std::queue<std::shared_ptr<Node>> q;
-  for (auto &node : nodes) {
-    if (inDegree[node] == 0) {
-      q.push(node);
-    }
+  size_t arena_bytes = memory_plan->getPeakBytes();
+#ifdef ALIGN_TENSORS
+  return alloc_aligned_memory<std::byte>(arena_bytes);
+#else
+  return std::shared_ptr<std::byte[]>(new std::byte[arena_bytes]);
+#endif
+}
+
+void Model::seedArena(TensorTable &table,
+                      const std::shared_ptr<std::byte[]> &arena) const {
+  for (const auto &allocation : memory_plan->getAllocations()) {
+    const SlotLayout &layout = slot_layouts[allocation.slot];
+    std::visit(
+        [&](const auto &prototype) {
+          using TensorType =
+              typename std::decay_t<decltype(prototype)>::element_type;
+          using ValueType = typename TensorType::value_type;
+
+          // The tensor only views its part of the arena, and keeps the arena
+          // alive for as long as the tensor is
+          std::shared_ptr<ValueType[]> data(
+              arena, reinterpret_cast<ValueType *>(arena.get() +
+                                                   allocation.offset));
+          table[allocation.slot] = std::make_shared<TensorType>(
+              layout.shape,
+              array_mml<ValueType>(data, layout.bytes / sizeof(ValueType)));
+        },
+        layout.type);
   }
+}
 
-  // Perform topological sort
-  std::vector<std::vector<std::shared_ptr<Node>>> layers;
-  int processedCount = 0;
+void Model::planMemory(std::vector<SlotLayout> layouts,
+                       const std::vector<array_mml<size_t>> &input_shapes) {
+  // The arenas of the previous plan no longer fit
+  slot_layouts = std::move(layouts);
+  idle_arenas.clear();
+  memory_generation++;
 
-  while (!q.empty()) {
-    int size = q.size();
-    std::vector<std::shared_ptr<Node>> currentLayer;
-    currentLayer.reserve(size);
+  std::vector<size_t> slot_bytes(slot_layouts.size());
+  for (size_t slot = 0; slot < slot_layouts.size(); slot++) {
+    slot_bytes[slot] = slot_layouts[slot].bytes;
+  }
 
-    for (int i = 0; i < size; i++) {
-      auto node = q.front();
-      q.pop();
+  memory_plan.emplace(*plan, slot_bytes);
+  planned_input_shapes = input_shapes;
 
-      currentLayer.push_back(node);
-      processedCount++;
+  size_t arena_bytes = memory_plan->getPeakBytes();
+  Logger::log<LogLevel::Trace>("Planned activation memory: ", arena_bytes,
+                               " bytes (", memory_plan->getNaiveBytes(),
+                               " bytes without reuse)");
+}
 
-      for (auto &adjacentNode : adjacentMap[node]) {
-        if (--inDegree[adjacentNode] == 0) {
-          q.push(adjacentNode);
-        }
+void Model::setInterOpThreads(size_t num_threads) {
+  if (num_threads == 0) {
+    throw std::invalid_argument("Model needs at least one inter-op thread.");
+  }
+
+  if (num_threads == 1) {
+    inter_op_pool.reset();
+  } else if (getInterOpThreads() != num_threads) {
+    inter_op_pool = std::make_shared<ThreadPool>(num_threads);
+  }
+}
+
+size_t Model::getInterOpThreads() const {
+  return inter_op_pool ? inter_op_pool->get_num_threads() : 1;
+}
+
+void Model::runNode(size_t node_idx, const ExecutionPlan::Step &step,
+                    TensorTable &table) {
+  const std::shared_ptr<Node> &node = step.node;
+
+  // The node type is only looked up when it is going to be printed
+  if (Logger::enabled<LogLevel::Trace>()) {
+    Logger::log<LogLevel::Trace>("  Processing node ", node_idx,
+                                 " (type: ", typeid(*node).name(), ")");
+  }
+
+  try {
+    // Every node reads and writes its tensors through the slots of the plan
+    node->forward(table, step.inputs, step.outputs);
+  } catch (const std::exception &e) {
+    if (Logger::enabled<LogLevel::Error>()) {
+      std::string node_inputs;
+      for (const auto &input : node->getInputs()) {
+        node_inputs += input + " ";
+      }
+      std::string node_outputs;
+      for (const auto &output : node->getOutputs()) {
+        node_outputs += output + " ";
       }
+      Logger::log<LogLevel::Error>(
+          "*** Error in node ", node_idx, " (type: ", typeid(*node).name(),
+          "): ", e.what(), "\n  Node inputs: ", node_inputs,
+          "\n  Node outputs: ", node_outputs);
     }
-    layers.push_back(currentLayer);
+
+    // Rethrow so the caller can handle it
+    throw;
   }
 
-  // Check for cycles
-  if (processedCount != nodes.size()) {
-    throw std::runtime_error("ComputeGraph has a cycle.");
+  Logger::log<LogLevel::Trace>("  Node ", node_idx, " processed successfully");
+}
+
+void Model::runLayerParallel(size_t begin, size_t end, TensorTable &table) {
+  const auto &steps = plan->getSteps();
+
+  // The nodes of a layer are independent, so each one only writes its own
+  // output slots and the table can be shared without locking
+  std::vector<std::future<void>> futures;
+  futures.reserve(end - begin);
+  for (size_t i = 0; i < end - begin; i++) {
+    futures.push_back(inter_op_pool->submit(
+        [&, i] { runNode(i, steps[begin + i], table); }));
   }
 
-  return layers;
-}
\ No newline at end of file
+  // Wait for every node before rethrowing, the tasks use the table
+  std::exception_ptr error;
+  for (auto &future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
@@ -0,0 +1,124 @@
+#include "datastructures/elementwise_ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "utility/simd_math.hpp"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// The vector paths are picked when the library itself is built with AVX2 or
+// AVX-512, so callers compiled without those flags still get them. The tail
+// that does not fill a register falls back to the scalar call operator.
+
+void ReluOp::apply(const float *in, float *out, size_t n) const {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  const __m512 zero = _mm512_setzero_ps();
+  for (; i + 16 <= n; i += 16) {
+    _mm512_storeu_ps(out + i, _mm512_max_ps(_mm512_loadu_ps(in + i), zero));
+  }
+#elif defined(__AVX2__)
+  const __m256 zero = _mm256_setzero_ps();
+  for (; i + 8 <= n; i += 8) {
+    _mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_loadu_ps(in + i), zero));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = (*this)(in[i]);
+  }
+}
+
+void LeakyReluOp::apply(const float *in, float *out, size_t n) const {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  const __m512 zero = _mm512_setzero_ps();
+  const __m512 slope = _mm512_set1_ps(alpha);
+  for (; i + 16 <= n; i += 16) {
+    __m512 x = _mm512_loadu_ps(in + i);
+    __mmask16 negative = _mm512_cmp_ps_mask(x, zero, _CMP_LT_OQ);
+    _mm512_storeu_ps(out + i,
+                     _mm512_mask_mul_ps(x, negative, x, slope));
+  }
+#elif defined(__AVX2__)
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 slope = _mm256_set1_ps(alpha);
+  for (; i + 8 <= n; i += 8) {
+    __m256 x = _mm256_loadu_ps(in + i);
+    __m256 negative = _mm256_cmp_ps(x, zero, _CMP_LT_OQ);
+    _mm256_storeu_ps(out + i,
+                     _mm256_blendv_ps(x, _mm256_mul_ps(x, slope), negative));
+  }
+#endif
+  for (; i < n; ++i) {
+    out[i] = (*this)(in[i]);
+  }
+}
+
+// The composite functors stage SimdMath results in a stack buffer of this many
+// floats, small enough to stay in L1 next to the chunk being read
+constexpr size_t STAGING_SIZE = 256;
+
+void SigmoidOp::apply(const float *in, float *out, size_t n) const {
+  SimdMath::sigmoid(in, out, n);
+}
+
+void TanhOp::apply(const float *in, float *out, size_t n) const {
+  SimdMath::tanh(in, out, n);
+}
+
+void SwishOp::apply(const float *in, float *out, size_t n) const {
+  float staged[STAGING_SIZE];
+  for (size_t i = 0; i < n; i += STAGING_SIZE) {
+    size_t m = std::min(STAGING_SIZE, n - i);
+    SimdMath::sigmoid(in + i, staged, m);
+    for (size_t j = 0; j < m; ++j) {
+      out[i + j] = in[i + j] * staged[j];
+    }
+  }
+}
+
+void EluOp::apply(const float *in, float *out, size_t n) const {
+  float staged[STAGING_SIZE];
+  for (size_t i = 0; i < n; i += STAGING_SIZE) {
+    size_t m = std::min(STAGING_SIZE, n - i);
+    SimdMath::exp(in + i, staged, m);
+    for (size_t j = 0; j < m; ++j) {
+      float x = in[i + j];
+      out[i + j] = x < 0 ? alpha * (staged[j] - 1) : x;
+    }
+  }
+}
+
+void GeluOp::apply(const float *in, float *out, size_t n) const {
+  const float inv_sqrt2 = 1.0f / std::sqrt(2.0f);
+  float staged[STAGING_SIZE];
+  for (size_t i = 0; i < n; i += STAGING_SIZE) {
+    size_t m = std::min(STAGING_SIZE, n - i);
+    for (size_t j = 0; j < m; ++j) {
+      staged[j] = in[i + j] * inv_sqrt2;
+    }
+    SimdMath::erf(staged, staged, m);
+    for (size_t j = 0; j < m; ++j) {
+      out[i + j] = 0.5f * in[i + j] * (1.0f + staged[j]);
+    }
+  }
+}
+
+void GeluTanhOp::apply(const float *in, float *out, size_t n) const {
+  const float sqrt_2_over_pi = std::sqrt(2.0f / static_cast<float>(M_PI));
+  float staged[STAGING_SIZE];
+  for (size_t i = 0; i < n; i += STAGING_SIZE) {
+    size_t m = std::min(STAGING_SIZE, n - i);
+    for (size_t j = 0; j < m; ++j) {
+      float x = in[i + j];
+      staged[j] = sqrt_2_over_pi * (x + 0.044715f * x * x * x);
+    }
+    SimdMath::tanh(staged, staged, m);
+    for (size_t j = 0; j < m; ++j) {
+      out[i + j] = 0.5f * in[i + j] * (1.0f + staged[j]);
+    }
+  }
+}
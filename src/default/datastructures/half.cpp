@@ -0,0 +1,109 @@
+#include "datastructures/half.hpp"
+
+#if defined(__AVX512F__) || defined(__F16C__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// The F16C and AVX-512 conversions round to nearest even like the scalar
+// ones, so both give the same bits. The tails go through the scalar ones.
+
+void fp16_t::to_float(const fp16_t *in, float *out, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    _mm512_storeu_ps(out + i, _mm512_cvtph_ps(h));
+  }
+#elif defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = to_float(in[i].bits);
+  }
+}
+
+void fp16_t::from_float(const float *in, fp16_t *out, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(in + i),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), h);
+  }
+#elif defined(__F16C__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), h);
+  }
+#endif
+  for (; i < n; i++) {
+    out[i].bits = from_float(in[i]);
+  }
+}
+
+void bf16_t::to_float(const bf16_t *in, float *out, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  for (; i + 16 <= n; i += 16) {
+    __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+    __m512i w = _mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16);
+    _mm512_storeu_ps(out + i, _mm512_castsi512_ps(w));
+  }
+#elif defined(__AVX2__)
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    __m256i w = _mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16);
+    _mm256_storeu_ps(out + i, _mm256_castsi256_ps(w));
+  }
+#endif
+  for (; i < n; i++) {
+    out[i] = to_float(in[i].bits);
+  }
+}
+
+void bf16_t::from_float(const float *in, bf16_t *out, size_t n) {
+  size_t i = 0;
+#if defined(__AVX512F__)
+  const __m512i one = _mm512_set1_epi32(1);
+  const __m512i round = _mm512_set1_epi32(0x7FFF);
+  const __m512i quiet = _mm512_set1_epi32(0x0040);
+  for (; i + 16 <= n; i += 16) {
+    __m512 x = _mm512_loadu_ps(in + i);
+    __m512i w = _mm512_castps_si512(x);
+    __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(w, 16), one);
+    __m512i sum = _mm512_add_epi32(_mm512_add_epi32(w, round), lsb);
+    __m512i rounded = _mm512_srli_epi32(sum, 16);
+    __mmask16 nan = _mm512_cmp_ps_mask(x, x, _CMP_UNORD_Q);
+    rounded = _mm512_mask_or_epi32(rounded, nan, _mm512_srli_epi32(w, 16),
+                                   quiet);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i),
+                        _mm512_cvtepi32_epi16(rounded));
+  }
+#elif defined(__AVX2__)
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i round = _mm256_set1_epi32(0x7FFF);
+  const __m256i quiet = _mm256_set1_epi32(0x0040);
+  for (; i + 8 <= n; i += 8) {
+    __m256 x = _mm256_loadu_ps(in + i);
+    __m256i w = _mm256_castps_si256(x);
+    __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(w, 16), one);
+    __m256i sum = _mm256_add_epi32(_mm256_add_epi32(w, round), lsb);
+    __m256i rounded = _mm256_srli_epi32(sum, 16);
+    __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    __m256i quieted = _mm256_or_si256(_mm256_srli_epi32(w, 16), quiet);
+    rounded = _mm256_blendv_epi8(rounded, quieted, nan);
+    // The pack works within 128-bit lanes, the permute puts them in order
+    __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(rounded, _mm256_setzero_si256()), 0xD8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                     _mm256_castsi256_si128(packed));
+  }
+#endif
+  for (; i < n; i++) {
+    out[i].bits = from_float(in[i]);
+  }
+}
@@ -1,5 +1,7 @@
 #include "datastructures/mml_array.hpp"
 
+#include "datastructures/half.hpp"
+
 template <typename T>
 array_mml<T>::array_mml(size_t size) : d_size(size) {
 #ifdef ALIGN_TENSORS
@@ -42,7 +44,7 @@ array_mml<T>::array_mml(const std::vector<T> &data) : d_size(data.size()) {
 
 template <typename T>
 array_mml<T>::array_mml(std::shared_ptr<T[]> data, size_t size)
-    : data(data), d_size(size) {
+    : data(data), d_size(size), aliased(true) {
 #ifdef ALIGN_TENSORS
   // Alert if the passed memory is not aligned
   if (reinterpret_cast<uintptr_t>(data.get()) % MEMORY_ALIGNMENT != 0) {
@@ -53,6 +55,14 @@ array_mml<T>::array_mml(std::shared_ptr<T[]> data, size_t size)
 
 template <typename T>
 array_mml<T>::array_mml(const array_mml &other) : d_size(other.d_size) {
+  if (!other.aliased) {
+    // Share the buffer until one of the arrays is written to
+    this->data = other.data;
+    this->shared.store(true, std::memory_order_relaxed);
+    other.shared.store(true, std::memory_order_relaxed);
+    return;
+  }
+
 #ifdef ALIGN_TENSORS
   this->data = alloc_aligned_memory<T>(d_size);
 #else
@@ -64,8 +74,13 @@ array_mml<T>::array_mml(const array_mml &other) : d_size(other.d_size) {
 
 template <typename T>
 array_mml<T>::array_mml(array_mml &&other) noexcept
-    : data(std::move(other.data)), d_size(other.d_size) {
+    : data(std::move(other.data)),
+      d_size(other.d_size),
+      aliased(other.aliased),
+      shared(other.shared.load(std::memory_order_relaxed)) {
   other.d_size = 0;
+  other.aliased = false;
+  other.shared.store(false, std::memory_order_relaxed);
 }
 
 template <typename T>
@@ -80,6 +95,7 @@ T &array_mml<T>::operator[](size_t index) {
         "Invalid array_mml index: " + std::to_string(index) +
         ". Array size: " + std::to_string(this->d_size));
   } else {
+    detach();
     return this->data[index];
   }
 }
@@ -96,10 +112,29 @@ const T &array_mml<T>::operator[](size_t index) const {
 }
 
 template <typename T>
-array_mml<T> &array_mml<T>::operator=(const array_mml &other) {
+array_mml<T> &array_mml<T>::operator=(array_mml &&other) noexcept {
   if (this != &other) {
-    std::ranges::copy(other, this->data.get());
+    this->data = std::move(other.data);
     this->d_size = other.d_size;
+    this->aliased = other.aliased;
+    this->shared.store(other.shared.load(std::memory_order_relaxed),
+                       std::memory_order_relaxed);
+    other.d_size = 0;
+    other.aliased = false;
+    other.shared.store(false, std::memory_order_relaxed);
+  }
+  return *this;
+}
+
+template <typename T>
+array_mml<T> &array_mml<T>::operator=(const array_mml &other) {
+  if (this != &other) {
+    if (this->aliased && this->d_size == other.d_size) {
+      // Others write to this buffer in place, so it is kept
+      std::ranges::copy(other, this->data.get());
+    } else {
+      *this = array_mml(other);
+    }
   }
   return *this;
 }
@@ -153,7 +188,7 @@ std::string array_mml<T>::to_string() const {
 
 template <typename T>
 T *array_mml<T>::begin() {
-  return this->data.get();
+  return escape();
 }
 
 template <typename T>
@@ -163,7 +198,7 @@ const T *array_mml<T>::begin() const {
 
 template <typename T>
 T *array_mml<T>::end() {
-  return this->data.get() + this->d_size;
+  return escape() + this->d_size;
 }
 
 template <typename T>
@@ -173,7 +208,7 @@ const T *array_mml<T>::end() const {
 
 template <typename T>
 T *array_mml<T>::get() {
-  return this->data.get();
+  return escape();
 }
 
 template <typename T>
@@ -181,12 +216,54 @@ const T *array_mml<T>::get() const {
   return this->data.get();
 }
 
+template <typename T>
+std::shared_ptr<T[]> array_mml<T>::get_shared() {
+  escape();
+  return this->data;
+}
+
+template <typename T>
+std::shared_ptr<const T[]> array_mml<T>::get_shared() const {
+  return this->data;
+}
+
 template <typename T>
 void array_mml<T>::fill(const T &value) {
-  std::ranges::fill(*this, value);
+  // Every element is overwritten, so a shared buffer is not copied first
+  detach(false);
+  std::fill(this->data.get(), this->data.get() + this->d_size, value);
+}
+
+template <typename T>
+void array_mml<T>::detach(bool keep_data) {
+  if (!this->shared.load(std::memory_order_relaxed)) return;
+
+  if (this->data.use_count() > 1) {
+    std::shared_ptr<T[]> own_data;
+#ifdef ALIGN_TENSORS
+    own_data = alloc_aligned_memory<T>(d_size);
+#else
+    own_data = std::shared_ptr<T[]>(new T[d_size]);
+#endif
+    if (keep_data) {
+      std::copy(this->data.get(), this->data.get() + d_size, own_data.get());
+    }
+    this->data = std::move(own_data);
+  }
+  this->shared.store(false, std::memory_order_relaxed);
+}
+
+template <typename T>
+T *array_mml<T>::escape() {
+  // Writes through the pointer must not reach the copies of this array, the
+  // ones made before it and the ones made while it is still in use
+  detach();
+  this->aliased = true;
+  return this->data.get();
 }
 
 #define TYPE(DT) _ARRAY_MML(DT)
 #include "types_integer.txt"
 #include "types_real.txt"
+#include "types_half.txt"
 #undef TYPE
@@ -0,0 +1,24 @@
+#include "datastructures/packed_gemm.hpp"
+
+#include "datastructures/packed_gemm_kernel.hpp"
+
+template <typename T>
+void PackedGemm<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
+                         const T *A, size_t lda, const T *B, size_t ldb,
+                         T BETA, T *C, size_t ldc) {
+  packed_gemm(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, BETA, C, ldc,
+              Allocator::get_default().get());
+}
+
+template <typename T>
+int PackedGemm<T>::tile_rows() {
+  return MR;
+}
+
+template <typename T>
+int PackedGemm<T>::tile_cols() {
+  return NR<T>;
+}
+
+template class PackedGemm<float>;
+template class PackedGemm<double>;
@@ -31,7 +31,7 @@ Tensor<T>::Tensor(const std::initializer_list<size_t> shape,
 }
 
 template <typename T>
-Tensor<T>::Tensor(const array_mml<size_t> &shape, const size_t jump_indexes,
+Tensor<T>::Tensor(const Shape &shape, const size_t jump_indexes,
                   const size_t jump_columns, const size_t jump_rows,
                   const bool sliced)
     : shape(shape),
@@ -46,7 +46,7 @@ Tensor<T>::Tensor(const array_mml<size_t> &shape, const size_t jump_indexes,
 }
 
 template <typename T>
-Tensor<T>::Tensor(const array_mml<size_t> &shape, const array_mml<T> &data,
+Tensor<T>::Tensor(const Shape &shape, const array_mml<T> &data,
                   const size_t jump_indexes, const size_t jump_columns,
                   const size_t jump_rows, const bool sliced)
     : shape(shape),
@@ -59,6 +59,32 @@ Tensor<T>::Tensor(const array_mml<size_t> &shape, const array_mml<T> &data,
   this->size = compute_size();
 }
 
+template <typename T>
+Tensor<T>::Tensor(const Shape &shape, array_mml<T> &&data,
+                  const size_t jump_indexes, const size_t jump_columns,
+                  const size_t jump_rows, const bool sliced)
+    : shape(shape),
+      data(std::move(data)),
+      jump_indexes(jump_indexes),
+      jump_columns(jump_columns),
+      jump_rows(jump_rows),
+      sliced(sliced) {
+  this->indices_offsets = compute_indices_offsets();
+  this->size = compute_size();
+}
+
+template <typename T>
+Tensor<T>::Tensor(const Shape &shape, uninitialized_t)
+    : shape(shape),
+      sliced(false),
+      jump_indexes(0),
+      jump_rows(0),
+      jump_columns(0) {
+  this->indices_offsets = compute_indices_offsets();
+  this->size = compute_size();
+  this->data = array_mml<T>(this->size);
+}
+
 template <typename T>
 Tensor<T>::Tensor(Tensor &&other) noexcept {
   this->shape = std::move(other.shape);
@@ -73,8 +99,8 @@ Tensor<T>::Tensor(Tensor &&other) noexcept {
 
 template <typename T>
 Tensor<T>::Tensor(const Tensor &other) {
-  this->shape = array_mml<size_t>(other.shape);
-  this->indices_offsets = array_mml<size_t>(other.indices_offsets);
+  this->shape = other.shape;
+  this->indices_offsets = other.indices_offsets;
   this->data = array_mml<T>(other.data);
   this->size = other.size;
   this->jump_indexes = other.jump_indexes;
@@ -96,10 +122,12 @@ array_mml<T> &Tensor<T>::get_raw_data() {
 template <typename T>
 Tensor<T> &Tensor<T>::operator=(const Tensor<T> &other) {
   if (this != &other) {
-    auto other_cast = dynamic_cast<const Tensor<T> &>(other);
-    this->shape = array_mml<size_t>(other_cast.shape);
-    this->indices_offsets = array_mml<size_t>(other_cast.indices_offsets);
-    this->data = array_mml<T>(other_cast.data);
+    const auto &other_cast = dynamic_cast<const Tensor<T> &>(other);
+    this->shape = other_cast.shape;
+    this->indices_offsets = other_cast.indices_offsets;
+    // A buffer placed in a preallocated arena is reused, others are shared
+    // until written to
+    this->data = other_cast.data;
     this->size = other_cast.size;
     this->jump_indexes = other_cast.jump_indexes;
     this->jump_columns = other_cast.jump_columns;
@@ -160,15 +188,36 @@ std::shared_ptr<Tensor<T>> Tensor<T>::copy() const {
 }
 
 template <typename T>
-void Tensor<T>::reshape(const array_mml<size_t> &new_shape) {
+void Tensor<T>::reshape(const Shape &new_shape) {
   if (!valid_shape(new_shape)) throw std::invalid_argument("Invalid shape");
-  this->shape = array_mml<size_t>(new_shape);
+  this->shape = new_shape;
   this->indices_offsets = compute_indices_offsets();
 }
 
 template <typename T>
 void Tensor<T>::reshape(std::initializer_list<size_t> new_shape) {
-  reshape(array_mml<size_t>(new_shape));
+  reshape(Shape(new_shape));
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> Tensor<T>::reshaped(
+    const Shape &new_shape) {
+  if (!valid_shape(new_shape)) throw std::invalid_argument("Invalid shape");
+  if (this->sliced) throw std::logic_error("Cannot reshape a sliced tensor");
+
+  // Share the buffer instead of copying it
+  return std::make_shared<Tensor<T>>(
+      new_shape, array_mml<T>(this->data.get_shared(), this->data.size()));
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> Tensor<T>::reshaped(const Shape &new_shape) const {
+  if (!valid_shape(new_shape)) throw std::invalid_argument("Invalid shape");
+  if (this->sliced) throw std::logic_error("Cannot reshape a sliced tensor");
+
+  // A copy of the array shares the buffer until one of them is written to,
+  // so neither the data nor the flags of this tensor are changed
+  return std::make_shared<Tensor<T>>(new_shape, array_mml<T>(this->data));
 }
 
 template <typename T>
@@ -187,12 +236,11 @@ void Tensor<T>::reverse_buffer() {
 template <typename T>
 std::shared_ptr<Tensor<T>> Tensor<T>::slice(
     std::initializer_list<size_t> slice_indices) {
-  auto slice_indices_array = array_mml<size_t>(slice_indices);
-  return slice(slice_indices_array);
+  return slice(Shape(slice_indices));
 }
 
 template <typename T>
-std::shared_ptr<Tensor<T>> Tensor<T>::slice(array_mml<size_t> &slice_indices) {
+std::shared_ptr<Tensor<T>> Tensor<T>::slice(const Shape &slice_indices) {
   if (!valid_slice_indices(slice_indices))
     throw std::invalid_argument("Invalid slice indices");
 
@@ -207,12 +255,12 @@ std::shared_ptr<Tensor<T>> Tensor<T>::slice(array_mml<size_t> &slice_indices) {
     } while (i++, i < slice_indices.size() - 1);
   }
 
-  // Create the buffer
-  std::shared_ptr<T[]> data_ptr(this->data.get(), [](T *) { /* NOOP */ });
-  auto shared_buffer = array_mml<T>(data_ptr, this->data.size());
+  // Share the buffer, the slice is a view of this tensor
+  auto shared_buffer =
+      array_mml<T>(this->data.get_shared(), this->data.size());
 
   // New shape and jump row/col for column slices.
-  array_mml<size_t> slice_shape(this->shape.size() - slice_indices.size());
+  Shape slice_shape(this->shape.size() - slice_indices.size());
   size_t slice_jump_columns = 0;
   size_t slice_jump_rows = 1;
   // Is the slice a column slice?
@@ -228,8 +276,8 @@ std::shared_ptr<Tensor<T>> Tensor<T>::slice(array_mml<size_t> &slice_indices) {
   }
 
   auto sliced_tensor = std::make_shared<Tensor<T>>(
-      slice_shape, shared_buffer, slice_jump_indexes, slice_jump_columns,
-      slice_jump_rows, true);
+      slice_shape, std::move(shared_buffer), slice_jump_indexes,
+      slice_jump_columns, slice_jump_rows, true);
 
   return sliced_tensor;
 }
@@ -253,12 +301,12 @@ bool Tensor<T>::operator==(const Tensor<T> &other) const {
 }
 
 template <typename T>
-const array_mml<size_t> &Tensor<T>::get_shape() const {
+const Shape &Tensor<T>::get_shape() const {
   return this->shape;
 }
 
 template <typename T>
-const array_mml<size_t> &Tensor<T>::get_offsets() const {
+const Shape &Tensor<T>::get_offsets() const {
   return this->indices_offsets;
 }
 
@@ -268,7 +316,7 @@ size_t Tensor<T>::get_size() const {
 }
 
 template <typename T>
-const T &Tensor<T>::operator[](array_mml<size_t> &indices) const {
+const T &Tensor<T>::operator[](const Shape &indices) const {
   if (!valid_indices(indices))
     throw std::invalid_argument("Invalid Tensor indices");
   if (this->sliced)
@@ -277,7 +325,7 @@ const T &Tensor<T>::operator[](array_mml<size_t> &indices) const {
 }
 
 template <typename T>
-T &Tensor<T>::operator[](array_mml<size_t> &indices) {
+T &Tensor<T>::operator[](const Shape &indices) {
   if (!valid_indices(indices))
     throw std::invalid_argument("Invalid Tensor indices");
   if (this->sliced)
@@ -287,14 +335,12 @@ T &Tensor<T>::operator[](array_mml<size_t> &indices) {
 
 template <typename T>
 const T &Tensor<T>::operator[](std::initializer_list<size_t> indices) const {
-  auto indices_array = array_mml<size_t>(indices);
-  return (*this)[indices_array];
+  return (*this)[Shape(indices)];
 }
 
 template <typename T>
 T &Tensor<T>::operator[](std::initializer_list<size_t> indices) {
-  auto indices_array = array_mml<size_t>(indices);
-  return (*this)[indices_array];
+  return (*this)[Shape(indices)];
 }
 
 template <typename T>
@@ -311,6 +357,42 @@ T &Tensor<T>::operator[](size_t index) {
   return this->data[index];
 }
 
+template <typename T>
+TensorSpan<T> Tensor<T>::get_span() {
+  if (this->sliced) {
+    throw std::runtime_error("Cannot take a span of a sliced Tensor");
+  }
+  return TensorSpan<T>(this->data.get(), this->shape.get(),
+                       this->indices_offsets.get(), this->shape.size());
+}
+
+template <typename T>
+TensorSpan<const T> Tensor<T>::get_span() const {
+  if (this->sliced) {
+    throw std::runtime_error("Cannot take a span of a sliced Tensor");
+  }
+  return TensorSpan<const T>(this->data.get(), this->shape.get(),
+                             this->indices_offsets.get(), this->shape.size());
+}
+
+template <typename T>
+TensorView<T> Tensor<T>::view() {
+  if (this->sliced) {
+    throw std::runtime_error("Cannot take a view of a sliced Tensor");
+  }
+  return TensorView<T>(this->data.get_shared(), 0, this->shape,
+                       this->indices_offsets);
+}
+
+template <typename T>
+TensorView<const T> Tensor<T>::view() const {
+  if (this->sliced) {
+    throw std::runtime_error("Cannot take a view of a sliced Tensor");
+  }
+  return TensorView<const T>(this->data.get_shared(), 0, this->shape,
+                             this->indices_offsets);
+}
+
 template <typename T>
 void Tensor<T>::fill(T value) {
   this->data.fill(value);
@@ -331,125 +413,45 @@ std::shared_ptr<Tensor<T>> Tensor<T>::transpose(
     return this->copy();
   }
 
-  array_mml<size_t> new_shape = this->shape;
+  Shape new_shape = this->shape;
   std::swap(new_shape[d0], new_shape[d1]);
 
-  auto transposed = std::make_shared<Tensor<T>>(new_shape);
-
-  if (rank == 2 && d0 == 0 && d1 == 1) {
-    // Optimize the common 2D matrix transpose case using blocking
-    const size_t block_size = 128;
-    size_t i, j, bi, bj;
-    auto rows = this->shape[0];
-    auto cols = this->shape[1];
-    for (i = 0; i < rows; i += block_size) {
-      for (j = 0; j < cols; j += block_size) {
-        for (bi = i; bi < std::min(i + block_size, rows); bi++) {
-          for (bj = j; bj < std::min(j + block_size, cols); bj++) {
-            (*transposed)[bj * rows + bi] = (*this)[bi * cols + bj];
-          }
-        }
-      }
-    }
-  } else {
-    std::function<void(array_mml<size_t> &, size_t)> transpose_recursive;
-    transpose_recursive = [&](array_mml<size_t> &indices, size_t dim) {
-      if (dim == rank) {
-        array_mml<size_t> transposed_indices = indices;
-        std::swap(transposed_indices[d0], transposed_indices[d1]);
-        (*transposed)[transposed_indices] = (*this)[indices];
-        return;
-      }
+  auto transposed = std::make_shared<Tensor<T>>(new_shape, uninitialized);
 
-      for (size_t i = 0; i < this->shape[dim]; ++i) {
-        indices[dim] = i;
-        transpose_recursive(indices, dim + 1);
+  if (this->sliced && rank == 2) {
+    // A sliced matrix has no strided view, so it is read element by element
+    size_t rows = this->shape[0];
+    size_t cols = this->shape[1];
+    auto out = transposed->get_span();
+    for (size_t i = 0; i < rows; i++) {
+      for (size_t j = 0; j < cols; j++) {
+        out[j * rows + i] = (*this)[i * cols + j];
       }
-    };
-
-    array_mml<size_t> indices(rank);
-    indices.fill(0);
-    transpose_recursive(indices, 0);
+    }
+    return transposed;
   }
 
+  // Swap the strides of a view and copy it once, the copy is tiled when the
+  // contiguous dimension moves
+  std::vector<int> perm(rank);
+  std::iota(perm.begin(), perm.end(), 0);
+  std::swap(perm[d0], perm[d1]);
+  this->view().transpose(perm).copy_to(*transposed);
+
   return transposed;
 };
 
 template <typename T>
 std::shared_ptr<Tensor<T>> Tensor<T>::transpose(
     const std::vector<int> &perm) const {
-  if (perm.size() != this->shape.size()) {
-    throw std::invalid_argument(
-        "Transpose: perm size must be equal to tensor rank");
-  }
-
-  // Checks that the perm vector is valid
-  std::vector<bool> seen(perm.size(), false);
-  for (size_t p : perm) {
-    if (p >= perm.size() || seen[p]) {
-      throw std::invalid_argument(
-          "Transpose: invalid or duplicate entry in perm");
-    }
-    seen[p] = true;
-  }
-
-  array_mml<size_t> new_shape(perm.size());
-
-  for (size_t i = 0; i < perm.size(); ++i) {
-    size_t val = shape[perm[i]];
-    new_shape[i] = val;
-  }
-
-  auto transposed = std::make_shared<Tensor<T>>(new_shape);
-  // This recursive function remaps each element in the old tensor to the new
-  // permutation based in the perm vector
-  std::function<void(array_mml<size_t> &, size_t)> recurse;
-  recurse = [&](array_mml<size_t> &indices, size_t dim) {
-    if (dim == shape.size()) {
-      array_mml<size_t> transposed_indices(perm.size());
-
-      for (size_t i = 0; i < perm.size(); ++i) {
-        if (perm[i] >= indices.size()) {
-          std::cerr << "ERROR: perm[" << i << "] = " << perm[i]
-                    << " out of bounds for indices of size " << indices.size()
-                    << std::endl;
-          throw std::out_of_range("perm index out of bounds");
-        }
-        transposed_indices[i] = indices[perm[i]];
-      }
-
-      try {
-        auto val = (*this)[indices];
-        (*transposed)[transposed_indices] = val;
-      } catch (const std::exception &e) {
-        std::cerr << "Exception accessing tensor at ";
-        for (size_t idx : indices) std::cerr << idx << " ";
-        std::cerr << " or transposed at ";
-        for (size_t idx : transposed_indices) std::cerr << idx << " ";
-        std::cerr << ": " << e.what() << std::endl;
-        throw;
-      }
-
-      return;
-    }
-
-    for (size_t i = 0; i < shape[dim]; ++i) {
-      indices[dim] = i;
-      recurse(indices, dim + 1);
-    }
-  };
-
-  array_mml<size_t> indices(shape.size());
-  indices.fill(0);
-  recurse(indices, 0);
-
-  return transposed;
+  // Permute the strides of a view, the data is only moved by the one copy
+  return this->view().transpose(perm).to_tensor();
 }
 
 template <typename T>
 bool Tensor<T>::valid_broadcast_reshape_size(
-    const array_mml<size_t> &target_shape) const {
-  const array_mml<size_t> &current_shape = this->shape;
+    const Shape &target_shape) const {
+  const Shape &current_shape = this->shape;
 
   size_t i = current_shape.size();
   size_t j = target_shape.size();
@@ -475,7 +477,7 @@ bool Tensor<T>::valid_broadcast_reshape_size(
 
 template <typename T>
 std::shared_ptr<Tensor<T>> Tensor<T>::broadcast_reshape(
-    const array_mml<size_t> &target_shape) const {
+    const Shape &target_shape) const {
   if (this->shape == target_shape) return this->copy();
 
   if (!valid_broadcast_reshape_size(target_shape))
@@ -483,30 +485,20 @@ std::shared_ptr<Tensor<T>> Tensor<T>::broadcast_reshape(
 
   if (this->sliced) throw std::logic_error("Cannot broadcast a sliced tensor");
 
-  // Caclulate how many times we should repeat the tensor
-  size_t tensor_size = this->data.size();
-  size_t target_size = std::accumulate(target_shape.begin(), target_shape.end(),
-                                       1, std::multiplies<size_t>());
-  size_t repeat_count = target_size / tensor_size;
-
-  // Create the new buffer
-  auto broadcasted_buffer = array_mml<T>(this->data.size() * repeat_count);
-  for (size_t i = 0; i < repeat_count; i++) {
-    for (size_t j = 0; j < tensor_size; j++) {
-      broadcasted_buffer[i * tensor_size + j] = this->data[j];
-    }
+  // Leading dimensions of size 1 beyond the target rank are dropped
+  TensorView<const T> broadcast_view = this->view();
+  while (broadcast_view.get_shape().size() > target_shape.size()) {
+    broadcast_view = broadcast_view.select(0, 0);
   }
 
-  // Create the new tensor
-  auto broadcasted_tensor =
-      std::make_shared<Tensor<T>>(target_shape, broadcasted_buffer);
-  return broadcasted_tensor;
-};
+  // Repeat the data through zero strides instead of tiling a buffer
+  return broadcast_view.broadcast(target_shape).to_tensor();
+}
 
 template <typename T>
-array_mml<size_t> Tensor<T>::compute_indices_offsets() const {
+Shape Tensor<T>::compute_indices_offsets() const {
   const size_t shape_size = this->shape.size();
-  array_mml<size_t> computed_offsets(shape_size);
+  Shape computed_offsets(shape_size);
 
   if (shape_size == 0) {
     // Scalar tensor: no offsets needed
@@ -534,7 +526,7 @@ size_t Tensor<T>::compute_size() const {
 }
 
 template <typename T>
-bool Tensor<T>::valid_shape(const array_mml<size_t> &new_shape) const {
+bool Tensor<T>::valid_shape(const Shape &new_shape) const {
   return std::accumulate(new_shape.begin(), new_shape.end(), 1,
                          std::multiplies<size_t>()) == this->get_size();
 }
@@ -545,7 +537,7 @@ bool Tensor<T>::valid_index(size_t index) const {
 }
 
 template <typename T>
-bool Tensor<T>::valid_indices(const array_mml<size_t> &indices) const {
+bool Tensor<T>::valid_indices(const Shape &indices) const {
   if (indices.size() != this->shape.size()) {
     return false;
   }
@@ -558,8 +550,8 @@ bool Tensor<T>::valid_indices(const array_mml<size_t> &indices) const {
 }
 
 template <typename T>
-size_t Tensor<T>::indices_to_1d_index(array_mml<size_t> indices) const {
-  auto index = 0;
+size_t Tensor<T>::indices_to_1d_index(const Shape &indices) const {
+  size_t index = 0;
   for (size_t i = 0; i < indices.size(); i++) {
     index += (indices[i]) * this->indices_offsets[i];
   }
@@ -574,7 +566,7 @@ size_t Tensor<T>::index_to_offset_1d_index(size_t index) const {
 
 template <typename T>
 bool Tensor<T>::valid_slice_indices(
-    const array_mml<size_t> &slice_indices) const {
+    const Shape &slice_indices) const {
   if (slice_indices.size() >= this->shape.size()) {
     return false;
   }
@@ -590,4 +582,5 @@ bool Tensor<T>::valid_slice_indices(
 #define TYPE(DT) _TENSOR(DT)
 #include "types_integer.txt"
 #include "types_real.txt"
+#include "types_half.txt"
 #undef TYPE
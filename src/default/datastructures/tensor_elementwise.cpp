@@ -1,62 +0,0 @@
-#include "datastructures/tensor_operations.hpp"
-
-template <typename T>
-void TensorOperations<T>::elementwise(const std::shared_ptr<const Tensor<T>> a,
-                                      const std::function<T(T)> &f,
-                                      const std::shared_ptr<Tensor<T>> c) {
-  const auto shape = a->get_shape();
-  const auto num_dimensions = shape.size();
-
-  array_mml<size_t> indices(num_dimensions);
-  for (size_t i = 0; i < num_dimensions; ++i) {
-    indices[i] = 0;
-  }
-  const auto total_elements = a->get_size();
-
-  for (size_t linear_idx = 0; linear_idx < total_elements; ++linear_idx) {
-    // Apply std::function `f` from `a` to `c`
-    (*c)[indices] = f((*a)[indices]);
-
-    // Increment indices
-    size_t d = num_dimensions - 1;
-    do {
-      if (++indices[d] < shape[d]) {
-        break;  // No carry needed, continue iteration
-      }
-      indices[d] = 0;  // Carry over to the next dimension
-    } while (d-- > 0);
-  }
-}
-
-template <typename T>
-void TensorOperations<T>::elementwise_in_place(
-    const std::shared_ptr<Tensor<T>> a, const std::function<T(T)> &f) {
-  const auto shape = a->get_shape();
-  const auto num_dimensions = shape.size();
-
-  array_mml<size_t> indices(num_dimensions);
-  for (size_t i = 0; i < num_dimensions; ++i) {
-    indices[i] = 0;
-  }
-
-  const auto total_elements = a->get_size();
-
-  for (size_t linear_idx = 0; linear_idx < total_elements; ++linear_idx) {
-    // Apply the std::function `f` to the current element
-    (*a)[indices] = f((*a)[indices]);
-
-    // Increment indices like a multi-dimensional counter
-    size_t d = num_dimensions - 1;
-    do {
-      if (++indices[d] < shape[d]) {
-        break;  // No carry needed, continue iteration
-      }
-      indices[d] = 0;  // Carry over to the next dimension
-    } while (d-- > 0);
-  }
-}
-
-#define TYPE(DT) _TENSOR_OPERATIONS(DT)
-#include "types_integer.txt"
-#include "types_real.txt"
-#undef TYPE
\ No newline at end of file
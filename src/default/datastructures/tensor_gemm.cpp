@@ -1,29 +1,56 @@
 #include "datastructures/tensor_operations.hpp"
+#include "utility/gemm_partition.hpp"
 
 template <typename T>
 void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
                                T BETA, std::shared_ptr<Tensor<T>> A, int lda,
                                std::shared_ptr<Tensor<T>> B, int ldb,
                                std::shared_ptr<Tensor<T>> C, int ldc) {
-  int k_col;
-  int i_col_out;
-  if (TA == 1) A = A->transpose();
-  if (TB == 1) B = B->transpose();
+  // The spans are unchecked, so the bounds are checked once up front, on
+  // the matrices as they are stored
+  const size_t a_rows = TA == 1 ? K : M;
+  const size_t a_cols = TA == 1 ? M : K;
+  const size_t b_rows = TB == 1 ? N : K;
+  const size_t b_cols = TB == 1 ? K : N;
+  if (M > 0 && N > 0 && K > 0 &&
+      (A->get_size() < (a_rows - 1) * lda + a_cols ||
+       B->get_size() < (b_rows - 1) * ldb + b_cols ||
+       C->get_size() < static_cast<size_t>((M - 1) * ldc + N))) {
+    throw std::invalid_argument("GEMM matrices do not match M, N and K");
+  }
 
-  for (int i = 0; i < M; i++) {
-    i_col_out = i * ldc;
+  const T *a = std::as_const(*A).get_span().get_data();
+  const T *b = std::as_const(*B).get_span().get_data();
+  T *c = C->get_span().get_data();
 
-    for (int j = 0; j < N; j++) {
-      (*C)[i_col_out + j] = ((T)BETA) * (*C)[i_col_out + j];
-    }
-    for (int k = 0; k < K; k++) {
-      k_col = k * ldb;
+  // A transposed operand is read through swapped strides instead of copied
+  const size_t a_row_stride = TA == 1 ? 1 : lda;
+  const size_t a_col_stride = TA == 1 ? lda : 1;
+  const size_t b_row_stride = TB == 1 ? 1 : ldb;
+  const size_t b_col_stride = TB == 1 ? ldb : 1;
 
-      for (int j = 0; j < N; j++) {
-        (*C)[i_col_out + j] += ((T)ALPHA) * (*A)[i * lda + k] * (*B)[k_col + j];
-      }
-    }
-  }
+  // C is split into blocks of rows and columns, and K as well when C alone
+  // has too few blocks for the threads
+  GemmPartition::run(
+      M, N, K, 1, 1, BETA, c, static_cast<size_t>(ldc),
+      [&](const GemmBlock &block, T beta, T *out, size_t ld_out) {
+        for (int i = block.row_begin; i < block.row_end; i++) {
+          T *c_row = out + i * ld_out;
+
+          // Like in BLAS, C is not read when beta is 0, so it may hold
+          // uninitialised values
+          for (int j = block.col_begin; j < block.col_end; j++) {
+            c_row[j] = beta == T(0) ? T(0) : beta * c_row[j];
+          }
+          for (int k = block.k_begin; k < block.k_end; k++) {
+            const T a_ik = a[i * a_row_stride + k * a_col_stride];
+            const T *b_row = b + k * b_row_stride;
+            for (int j = block.col_begin; j < block.col_end; j++) {
+              c_row[j] += ((T)ALPHA) * a_ik * b_row[j * b_col_stride];
+            }
+          }
+        }
+      });
 
   return;
 }
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "datastructures/tensor_operations.hpp"
+#include "utility/parallel.hpp"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// One register of floats and the operations the kernels need on it. The
+// 16-bit floats are widened straight from memory into a register.
+#if defined(__AVX512F__)
+constexpr int LANES = 16;
+using vfloat = __m512;
+
+inline vfloat widen(const fp16_t *p) {
+  return _mm512_cvtph_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)));
+}
+inline vfloat widen(const bf16_t *p) {
+  __m256i h = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16));
+}
+inline vfloat load(const float *p) { return _mm512_loadu_ps(p); }
+inline vfloat splat(float x) { return _mm512_set1_ps(x); }
+inline vfloat zero() { return _mm512_setzero_ps(); }
+inline vfloat fmadd(vfloat a, vfloat b, vfloat c) {
+  return _mm512_fmadd_ps(a, b, c);
+}
+inline vfloat add(vfloat a, vfloat b) { return _mm512_add_ps(a, b); }
+inline float sum(vfloat a) { return _mm512_reduce_add_ps(a); }
+inline void store(float *p, vfloat a) { _mm512_storeu_ps(p, a); }
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+constexpr int LANES = 8;
+using vfloat = __m256;
+
+inline vfloat widen(const fp16_t *p) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i *>(p)));
+}
+inline vfloat widen(const bf16_t *p) {
+  __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+}
+inline vfloat load(const float *p) { return _mm256_loadu_ps(p); }
+inline vfloat splat(float x) { return _mm256_set1_ps(x); }
+inline vfloat zero() { return _mm256_setzero_ps(); }
+inline vfloat fmadd(vfloat a, vfloat b, vfloat c) {
+  return _mm256_fmadd_ps(a, b, c);
+}
+inline vfloat add(vfloat a, vfloat b) { return _mm256_add_ps(a, b); }
+inline float sum(vfloat a) {
+  __m128 half = _mm_add_ps(_mm256_castps256_ps128(a),
+                           _mm256_extractf128_ps(a, 1));
+  half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+  half = _mm_add_ss(half, _mm_movehdup_ps(half));
+  return _mm_cvtss_f32(half);
+}
+inline void store(float *p, vfloat a) { _mm256_storeu_ps(p, a); }
+#else
+constexpr int LANES = 1;
+using vfloat = float;
+
+template <typename W>
+inline vfloat widen(const W *p) {
+  return static_cast<float>(*p);
+}
+inline vfloat load(const float *p) { return *p; }
+inline vfloat splat(float x) { return x; }
+inline vfloat zero() { return 0.0f; }
+inline vfloat fmadd(vfloat a, vfloat b, vfloat c) { return a * b + c; }
+inline vfloat add(vfloat a, vfloat b) { return a + b; }
+inline float sum(vfloat a) { return a; }
+inline void store(float *p, vfloat a) { *p = a; }
+#endif
+
+// Registers of C a task of the untransposed kernel accumulates at once
+constexpr int TILE_REGISTERS = 4;
+constexpr int TILE = TILE_REGISTERS * LANES;
+
+// Writes ALPHA * acc + BETA * C to C, without reading C when BETA is 0
+inline void finish(float *c, const float *acc, int n, float alpha,
+                   float beta) {
+  for (int j = 0; j < n; j++) {
+    c[j] = beta == 0 ? alpha * acc[j] : alpha * acc[j] + beta * c[j];
+  }
+}
+
+// C[i, j0:j0+U*LANES] for a B of K x N
+template <int U, typename W>
+void tile_nn(const float *a, const W *b, int ldb, int K, int j0, float *acc) {
+  vfloat sums[U];
+  for (int u = 0; u < U; u++) sums[u] = zero();
+  for (int k = 0; k < K; k++) {
+    vfloat x = splat(a[k]);
+    const W *row = b + static_cast<size_t>(k) * ldb + j0;
+    for (int u = 0; u < U; u++) {
+      sums[u] = fmadd(x, widen(row + u * LANES), sums[u]);
+    }
+  }
+  for (int u = 0; u < U; u++) store(acc + u * LANES, sums[u]);
+}
+
+// The dot product of a row of A and a row of a B of N x K
+template <typename W>
+float dot_nt(const float *a, const W *b, int K) {
+  vfloat sums[TILE_REGISTERS];
+  for (int u = 0; u < TILE_REGISTERS; u++) sums[u] = zero();
+  int k = 0;
+  for (; k + TILE <= K; k += TILE) {
+    for (int u = 0; u < TILE_REGISTERS; u++) {
+      int offset = k + u * LANES;
+      sums[u] = fmadd(load(a + offset), widen(b + offset), sums[u]);
+    }
+  }
+  for (; k + LANES <= K; k += LANES) {
+    sums[0] = fmadd(load(a + k), widen(b + k), sums[0]);
+  }
+  vfloat total = sums[0];
+  for (int u = 1; u < TILE_REGISTERS; u++) total = add(total, sums[u]);
+  float result = sum(total);
+  for (; k < K; k++) {
+    result += a[k] * static_cast<float>(b[k]);
+  }
+  return result;
+}
+
+}  // namespace
+
+template <typename T>
+template <typename W>
+  requires(std::is_same_v<T, float> && is_half_v<W>)
+void TensorOperations<T>::gemm_half(int TB, int M, int N, int K, T ALPHA,
+                                    T BETA,
+                                    std::shared_ptr<const Tensor<T>> A,
+                                    int lda,
+                                    std::shared_ptr<const Tensor<W>> B,
+                                    int ldb, std::shared_ptr<Tensor<T>> C,
+                                    int ldc) {
+  if (M <= 0 || N <= 0) return;
+
+  // The kernels read raw pointers, so the bounds are checked once up front
+  size_t b_rows = TB == 1 ? N : K;
+  size_t b_cols = TB == 1 ? K : N;
+  if (A->get_size() < static_cast<size_t>(M - 1) * lda + K ||
+      (K > 0 && B->get_size() < (b_rows - 1) * ldb + b_cols) ||
+      C->get_size() < static_cast<size_t>(M - 1) * ldc + N) {
+    throw std::invalid_argument("GEMM matrices do not match M, N and K");
+  }
+
+  const float *a = A->get_span().get_data();
+  const W *b = B->get_span().get_data();
+  float *c = C->get_span().get_data();
+
+  if (TB == 1) {
+    // Every column of C is a dot product with one row of B, which stays in
+    // cache while it is used for all the rows of A
+    Parallel::parallel_for(
+        0, N, Parallel::grain_for(static_cast<size_t>(M) * K),
+        [&](size_t j_begin, size_t j_end) {
+          for (size_t j = j_begin; j < j_end; j++) {
+            const W *b_row = b + j * ldb;
+            for (int i = 0; i < M; i++) {
+              float acc = dot_nt(a + static_cast<size_t>(i) * lda, b_row, K);
+              finish(c + static_cast<size_t>(i) * ldc + j, &acc, 1, ALPHA,
+                     BETA);
+            }
+          }
+        });
+    return;
+  }
+
+  // Tiles of columns are split across the threads, the last one may be
+  // narrower and end in columns that are done one at a time
+  const int tiles = (N + TILE - 1) / TILE;
+  Parallel::parallel_for(
+      0, tiles, Parallel::grain_for(static_cast<size_t>(M) * K * TILE),
+      [&](size_t tile_begin, size_t tile_end) {
+        float acc[TILE];
+        for (size_t tile = tile_begin; tile < tile_end; tile++) {
+          const int j0 = static_cast<int>(tile) * TILE;
+          const int width = std::min(TILE, N - j0);
+          for (int i = 0; i < M; i++) {
+            const float *a_row = a + static_cast<size_t>(i) * lda;
+            int j = 0;
+            if (width == TILE) {
+              tile_nn<TILE_REGISTERS>(a_row, b, ldb, K, j0, acc);
+              j = TILE;
+            } else {
+              for (; j + LANES <= width; j += LANES) {
+                tile_nn<1>(a_row, b, ldb, K, j0 + j, acc + j);
+              }
+            }
+            for (; j < width; j++) {
+              const W *column = b + j0 + j;
+              float total = 0;
+              for (size_t k = 0; k < static_cast<size_t>(K); k++) {
+                total += a_row[k] * static_cast<float>(column[k * ldb]);
+              }
+              acc[j] = total;
+            }
+            finish(c + static_cast<size_t>(i) * ldc + j0, acc, width, ALPHA,
+                   BETA);
+          }
+        }
+      });
+}
+
+template void TensorOperations<float>::gemm_half<fp16_t>(
+    int, int, int, int, float, float, std::shared_ptr<const Tensor<float>>,
+    int, std::shared_ptr<const Tensor<fp16_t>>, int,
+    std::shared_ptr<Tensor<float>>, int);
+template void TensorOperations<float>::gemm_half<bf16_t>(
+    int, int, int, int, float, float, std::shared_ptr<const Tensor<float>>,
+    int, std::shared_ptr<const Tensor<bf16_t>>, int,
+    std::shared_ptr<Tensor<float>>, int);
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "datastructures/tensor_operations.hpp"
+#include "utility/parallel.hpp"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+// Columns of C a task computes together, so every row of A loaded into
+// registers is used for all of them
+constexpr int COLUMNS = 4;
+
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+// Bytes of K one VNNI instruction consumes
+constexpr int STEP = 64;
+#else
+constexpr int STEP = 16;
+#endif
+
+// The part of K the vector loop covers, the rest is summed in scalar code
+inline int vector_span(int K) { return K - K % STEP; }
+
+// Dot products of a row of A with COLS rows of the transposed B, over the
+// vector part of K. VNNI multiplies unsigned by signed bytes, so a signed A
+// is offset by 128, which the caller takes out again.
+template <int COLS, typename TA>
+void dot_vector(const TA *a, const int8_t *b, size_t ldb, int K,
+                int32_t *out) {
+  const int end = vector_span(K);
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+  __m512i acc[COLS];
+  for (int c = 0; c < COLS; c++) acc[c] = _mm512_setzero_si512();
+  const __m512i offset = _mm512_set1_epi8(static_cast<char>(0x80));
+  for (int k = 0; k < end; k += STEP) {
+    __m512i av = _mm512_loadu_si512(a + k);
+    if constexpr (std::is_same_v<TA, int8_t>) {
+      av = _mm512_xor_si512(av, offset);
+    }
+    for (int c = 0; c < COLS; c++) {
+      acc[c] = _mm512_dpbusd_epi32(acc[c], av,
+                                   _mm512_loadu_si512(b + c * ldb + k));
+    }
+  }
+  for (int c = 0; c < COLS; c++) out[c] = _mm512_reduce_add_epi32(acc[c]);
+#elif defined(__AVX2__)
+  // The bytes are widened to 16 bits, as _mm256_maddubs_epi16 saturates
+  // the sum of two unsigned by signed products and madd does not
+  __m256i acc[COLS];
+  for (int c = 0; c < COLS; c++) acc[c] = _mm256_setzero_si256();
+  for (int k = 0; k < end; k += STEP) {
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + k));
+    __m256i av;
+    if constexpr (std::is_same_v<TA, int8_t>) {
+      av = _mm256_cvtepi8_epi16(bytes);
+    } else {
+      av = _mm256_cvtepu8_epi16(bytes);
+    }
+    for (int c = 0; c < COLS; c++) {
+      __m256i bv = _mm256_cvtepi8_epi16(_mm_loadu_si128(
+          reinterpret_cast<const __m128i *>(b + c * ldb + k)));
+      acc[c] = _mm256_add_epi32(acc[c], _mm256_madd_epi16(av, bv));
+    }
+  }
+  for (int c = 0; c < COLS; c++) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc[c]),
+                                _mm256_extracti128_si256(acc[c], 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+    out[c] = _mm_cvtsi128_si32(sum);
+  }
+#else
+  for (int c = 0; c < COLS; c++) {
+    int32_t sum = 0;
+    for (int k = 0; k < end; k++) {
+      sum += static_cast<int32_t>(a[k]) * b[c * ldb + k];
+    }
+    out[c] = sum;
+  }
+#endif
+}
+
+// Whether dot_vector offsets a signed A by 128
+template <typename TA>
+constexpr bool offsets_a() {
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+  return std::is_same_v<TA, int8_t>;
+#else
+  return false;
+#endif
+}
+
+// Runs C = A * B^T on the threads, handing every finished group of columns
+// of a row to the epilogue as (i, j0, count, accumulators)
+template <typename TA, typename Epilogue>
+void run_gemm_int8(int TB, int M, int N, int K, const Tensor<TA> &A, int lda,
+                   const Tensor<int8_t> &B, int ldb, size_t c_size, int ldc,
+                   const Epilogue &epilogue) {
+  if (M <= 0 || N <= 0) return;
+  size_t b_rows = TB == 1 ? N : K;
+  size_t b_cols = TB == 1 ? K : N;
+  if (A.get_size() < static_cast<size_t>(M - 1) * lda + K ||
+      (K > 0 && B.get_size() < (b_rows - 1) * ldb + b_cols) ||
+      c_size < static_cast<size_t>(M - 1) * ldc + N) {
+    throw std::invalid_argument("GEMM matrices do not match M, N and K");
+  }
+
+  const TA *a = A.get_span().get_data();
+  const int8_t *b = B.get_span().get_data();
+  size_t b_stride = ldb;
+
+  // The kernel reads the columns of B along K, so a K x N B is transposed
+  std::unique_ptr<int8_t[]> transposed;
+  if (TB != 1) {
+    transposed.reset(new int8_t[static_cast<size_t>(N) * K]);
+    for (size_t k = 0; k < static_cast<size_t>(K); k++) {
+      for (size_t j = 0; j < static_cast<size_t>(N); j++) {
+        transposed[j * K + k] = b[k * ldb + j];
+      }
+    }
+    b = transposed.get();
+    b_stride = K;
+  }
+
+  // 128 times the sum of every column over the vector part of K, which the
+  // offset of a signed A adds to its dot products
+  std::unique_ptr<int32_t[]> offset_sums;
+  if constexpr (offsets_a<TA>()) {
+    offset_sums.reset(new int32_t[N]);
+    for (size_t j = 0; j < static_cast<size_t>(N); j++) {
+      int32_t sum = 0;
+      for (int k = 0; k < vector_span(K); k++) sum += b[j * b_stride + k];
+      offset_sums[j] = 128 * sum;
+    }
+  }
+
+  const int groups = (N + COLUMNS - 1) / COLUMNS;
+  Parallel::parallel_for(
+      0, groups, Parallel::grain_for(static_cast<size_t>(M) * K * COLUMNS),
+      [&](size_t group_begin, size_t group_end) {
+        int32_t acc[COLUMNS];
+        for (size_t group = group_begin; group < group_end; group++) {
+          const int j0 = static_cast<int>(group) * COLUMNS;
+          const int count = std::min(COLUMNS, N - j0);
+          const int8_t *b_group = b + j0 * b_stride;
+          for (int i = 0; i < M; i++) {
+            const TA *a_row = a + static_cast<size_t>(i) * lda;
+            if (count == COLUMNS) {
+              dot_vector<COLUMNS>(a_row, b_group, b_stride, K, acc);
+            } else {
+              for (int c = 0; c < count; c++) {
+                dot_vector<1>(a_row, b_group + c * b_stride, b_stride, K,
+                              acc + c);
+              }
+            }
+            for (int c = 0; c < count; c++) {
+              const int8_t *b_row = b_group + c * b_stride;
+              for (int k = vector_span(K); k < K; k++) {
+                acc[c] += static_cast<int32_t>(a_row[k]) * b_row[k];
+              }
+              if constexpr (offsets_a<TA>()) acc[c] -= offset_sums[j0 + c];
+            }
+            epilogue(i, j0, count, acc);
+          }
+        }
+      });
+}
+
+}  // namespace
+
+template <typename T>
+template <typename TA>
+  requires(std::is_same_v<T, int32_t> &&
+           (std::is_same_v<TA, int8_t> || std::is_same_v<TA, uint8_t>))
+void TensorOperations<T>::gemm_int8(int TB, int M, int N, int K,
+                                    std::shared_ptr<const Tensor<TA>> A,
+                                    int lda,
+                                    std::shared_ptr<const Tensor<int8_t>> B,
+                                    int ldb, std::shared_ptr<Tensor<T>> C,
+                                    int ldc) {
+  int32_t *c = C->get_span().get_data();
+  run_gemm_int8(TB, M, N, K, *A, lda, *B, ldb, C->get_size(), ldc,
+                [&](int i, int j0, int count, const int32_t *acc) {
+                  std::copy(acc, acc + count,
+                            c + static_cast<size_t>(i) * ldc + j0);
+                });
+}
+
+template <typename T>
+template <typename TA>
+  requires((std::is_same_v<T, int8_t> || std::is_same_v<T, uint8_t>) &&
+           (std::is_same_v<TA, int8_t> || std::is_same_v<TA, uint8_t>))
+void TensorOperations<T>::gemm_int8(int TB, int M, int N, int K,
+                                    std::shared_ptr<const Tensor<TA>> A,
+                                    int lda,
+                                    std::shared_ptr<const Tensor<int8_t>> B,
+                                    int ldb,
+                                    const Requantization &requantization,
+                                    std::shared_ptr<Tensor<T>> C, int ldc) {
+  const auto &scales = requantization.scales;
+  const auto &bias = requantization.bias;
+  if (scales.size() != 1 && scales.size() != static_cast<size_t>(N)) {
+    throw std::invalid_argument(
+        "Requantization needs one scale or one scale per column");
+  }
+  if (!bias.empty() && bias.size() != static_cast<size_t>(N)) {
+    throw std::invalid_argument(
+        "Requantization needs no bias or one bias per column");
+  }
+
+  const bool per_column = scales.size() != 1;
+  const float lowest = std::numeric_limits<T>::lowest();
+  const float highest = std::numeric_limits<T>::max();
+  T *c = C->get_span().get_data();
+  run_gemm_int8(
+      TB, M, N, K, *A, lda, *B, ldb, C->get_size(), ldc,
+      [&](int i, int j0, int count, const int32_t *acc) {
+        T *c_row = c + static_cast<size_t>(i) * ldc;
+        for (int j = j0; j < j0 + count; j++) {
+          int32_t value = acc[j - j0] + (bias.empty() ? 0 : bias[j]);
+          float scaled = std::nearbyint(
+              static_cast<float>(value) * scales[per_column ? j : 0]);
+          scaled += static_cast<float>(requantization.zero_point);
+          c_row[j] = static_cast<T>(std::clamp(scaled, lowest, highest));
+        }
+      });
+}
+
+#define GEMM_INT8(TA)                                                         \
+  template void TensorOperations<int32_t>::gemm_int8<TA>(                     \
+      int, int, int, int, std::shared_ptr<const Tensor<TA>>, int,             \
+      std::shared_ptr<const Tensor<int8_t>>, int,                             \
+      std::shared_ptr<Tensor<int32_t>>, int);                                 \
+  template void TensorOperations<int8_t>::gemm_int8<TA>(                      \
+      int, int, int, int, std::shared_ptr<const Tensor<TA>>, int,             \
+      std::shared_ptr<const Tensor<int8_t>>, int, const Requantization &,     \
+      std::shared_ptr<Tensor<int8_t>>, int);                                  \
+  template void TensorOperations<uint8_t>::gemm_int8<TA>(                     \
+      int, int, int, int, std::shared_ptr<const Tensor<TA>>, int,             \
+      std::shared_ptr<const Tensor<int8_t>>, int, const Requantization &,     \
+      std::shared_ptr<Tensor<uint8_t>>, int);
+
+GEMM_INT8(int8_t)
+GEMM_INT8(uint8_t)
+#undef GEMM_INT8
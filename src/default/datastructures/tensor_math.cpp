@@ -1,13 +1,24 @@
 #include "datastructures/tensor_operations.hpp"
 
+#include <algorithm>
+#include <stdexcept>
+
+#include "utility/parallel.hpp"
+
 template <typename T>
 void TensorOperations<T>::add(const std::shared_ptr<const Tensor<T>> a,
                               const std::shared_ptr<const Tensor<T>> b,
                               std::shared_ptr<Tensor<T>> c) {
   const auto size = a->get_size();
-  for (size_t i = 0; i < size; i++) {
-    (*c)[i] = (*a)[i] + (*b)[i];
-  }
+  auto a_data = a->get_span();
+  auto b_data = b->get_span();
+  auto c_data = c->get_span();
+  Parallel::parallel_for(0, size, Parallel::grain_for(4),
+                         [&](size_t begin, size_t end) {
+                           for (size_t i = begin; i < end; i++) {
+                             c_data[i] = a_data[i] + b_data[i];
+                           }
+                         });
 }
 
 template <typename T>
@@ -30,39 +41,75 @@ void TensorOperations<T>::multiply(const std::shared_ptr<Tensor<T>> a,
 }
 
 template <typename T>
-bool TensorOperations<T>::equals(const std::shared_ptr<Tensor<T>> a,
-                                 const std::shared_ptr<Tensor<T>> b) {
-  if (a->get_size() != b->get_size() || a->get_shape() != b->get_shape()) {
-    return false;
-  } else {
-    const auto size = a->get_size();
-    for (size_t i = 0; i < size; i++) {
-      if ((*a)[i] != (*b)[i]) {
-        return false;
-      }
+Shape TensorOperations<T>::broadcast_shape(const Shape &a_shape,
+                                           const Shape &b_shape) {
+  const size_t rank = std::max(a_shape.size(), b_shape.size());
+  Shape out_shape(rank);
+  for (size_t i = 0; i < rank; i++) {
+    size_t dim_a = i < a_shape.size() ? a_shape[a_shape.size() - 1 - i] : 1;
+    size_t dim_b = i < b_shape.size() ? b_shape[b_shape.size() - 1 - i] : 1;
+    if (dim_a != dim_b && dim_a != 1 && dim_b != 1) {
+      throw std::invalid_argument("Shapes " + a_shape.to_string() + " and " +
+                                  b_shape.to_string() +
+                                  " can not be broadcast");
     }
-    return true;
+    out_shape[rank - 1 - i] = dim_a == 1 ? dim_b : dim_a;
   }
+  return out_shape;
 }
 
 template <typename T>
-int TensorOperations<T>::arg_max(const std::shared_ptr<const Tensor<T>> a) {
-  const auto size = a->get_size();
-  if (size == 0) {
-    throw std::runtime_error("arg_max called on an empty tensor.");
-  }
+typename TensorOperations<T>::BroadcastLayout
+TensorOperations<T>::broadcast_layout(const Shape &a_shape,
+                                      const Shape &b_shape,
+                                      const Shape &out_shape) {
+  const size_t rank = out_shape.size();
+
+  // The stride of an input along each output dimension, 0 where the input has
+  // size 1 or no such dimension at all
+  auto input_strides = [rank](const Shape &shape) {
+    Shape strides(rank);
+    size_t stride = 1;
+    for (size_t i = 0; i < shape.size(); i++) {
+      size_t dim = shape.size() - 1 - i;
+      strides[rank - 1 - i] = shape[dim] == 1 ? 0 : stride;
+      stride *= shape[dim];
+    }
+    return strides;
+  };
+  const Shape a_strides = input_strides(a_shape);
+  const Shape b_strides = input_strides(b_shape);
 
-  T max_value = (*a)[0];
-  int max_index = 0;
+  BroadcastLayout layout;
+  for (size_t d = 0; d < rank; d++) {
+    if (out_shape[d] == 1) continue;
 
-  for (int i = 1; i < static_cast<int>(size); ++i) {
-    if ((*a)[i] > max_value) {
-      max_value = (*a)[i];
-      max_index = i;
+    // Merge into the previous dimension when both inputs step through the
+    // pair as through a single dimension
+    if (layout.rank > 0) {
+      size_t prev = layout.rank - 1;
+      if (layout.a_stride[prev] == a_strides[d] * out_shape[d] &&
+          layout.b_stride[prev] == b_strides[d] * out_shape[d]) {
+        layout.extent[prev] *= out_shape[d];
+        layout.a_stride[prev] = a_strides[d];
+        layout.b_stride[prev] = b_strides[d];
+        continue;
+      }
     }
+    layout.extent[layout.rank] = out_shape[d];
+    layout.a_stride[layout.rank] = a_strides[d];
+    layout.b_stride[layout.rank] = b_strides[d];
+    layout.rank++;
   }
 
-  return max_index;
+  // A single element still needs one dimension for the inner loop
+  if (layout.rank == 0) {
+    layout.extent[0] = 1;
+    layout.a_stride[0] = 0;
+    layout.b_stride[0] = 0;
+    layout.rank = 1;
+  }
+  return layout;
 }
 
 #define TYPE(DT) _TENSOR_OPERATIONS(DT)
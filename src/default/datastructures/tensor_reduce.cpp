@@ -0,0 +1,486 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "datastructures/tensor_operations.hpp"
+#include "utility/parallel.hpp"
+
+namespace {
+
+// Independent accumulators a contiguous run is reduced into, so the compiler
+// can keep them in vector registers instead of one serial dependency chain
+constexpr size_t REDUCE_LANES = 16;
+
+template <typename T, typename F>
+T reduce_run(const T *in, size_t n, const F &f, T identity) {
+  T lanes[REDUCE_LANES];
+  std::fill(lanes, lanes + REDUCE_LANES, identity);
+
+  size_t i = 0;
+  for (; i + REDUCE_LANES <= n; i += REDUCE_LANES) {
+    for (size_t lane = 0; lane < REDUCE_LANES; lane++) {
+      lanes[lane] = f(lanes[lane], in[i + lane]);
+    }
+  }
+
+  T result = identity;
+  for (size_t lane = 0; lane < REDUCE_LANES; lane++) {
+    result = f(result, lanes[lane]);
+  }
+  for (; i < n; i++) {
+    result = f(result, in[i]);
+  }
+  return result;
+}
+
+// The smallest value of T, which no element compares below
+template <typename T>
+T lowest_value() {
+  if constexpr (std::numeric_limits<T>::has_infinity) {
+    return -std::numeric_limits<T>::infinity();
+  } else {
+    return std::numeric_limits<T>::lowest();
+  }
+}
+
+// The largest value of T, which no element compares above
+template <typename T>
+T highest_value() {
+  if constexpr (std::numeric_limits<T>::has_infinity) {
+    return std::numeric_limits<T>::infinity();
+  } else {
+    return std::numeric_limits<T>::max();
+  }
+}
+
+template <typename T>
+bool is_nan(T x) {
+  if constexpr (std::is_floating_point_v<T>) {
+    return std::isnan(x);
+  } else {
+    return false;
+  }
+}
+
+// Whether x ranks above y in arg_max and top_k, where a NaN ranks above
+// every number like in ONNX and numpy
+template <typename T>
+bool ranks_above(T x, T y) {
+  return x > y || (is_nan(x) && !is_nan(y));
+}
+
+// The larger of a and b by ranks_above, so a NaN is kept once met
+struct RankMaxOp {
+  template <typename T>
+  T operator()(T a, T b) const {
+    return ranks_above(b, a) ? b : a;
+  }
+};
+
+// Whether x is the value found by RankMaxOp, a NaN matching a NaN
+template <typename T>
+bool same_rank(T x, T largest) {
+  return x == largest || (is_nan(x) && is_nan(largest));
+}
+
+size_t normalize_axis(int axis, size_t rank) {
+  int normalized = axis < 0 ? axis + static_cast<int>(rank) : axis;
+  if (normalized < 0 || normalized >= static_cast<int>(rank)) {
+    throw std::invalid_argument("Axis " + std::to_string(axis) +
+                                " is out of range for rank " +
+                                std::to_string(rank));
+  }
+  return static_cast<size_t>(normalized);
+}
+
+// The shape left after reducing one axis, {1} when nothing is left
+Shape reduced_shape(const Shape &shape, size_t axis, size_t kept_size,
+                    bool keep_dims) {
+  Shape result;
+  for (size_t d = 0; d < shape.size(); d++) {
+    if (d != axis) {
+      result.push_back(shape[d]);
+    } else if (keep_dims) {
+      result.push_back(kept_size);
+    }
+  }
+  if (result.size() == 0) result.push_back(1);
+  return result;
+}
+
+}  // namespace
+
+template <typename T>
+template <typename F>
+void TensorOperations<T>::reduce_dimension(const T *in, T *out, size_t outer,
+                                           size_t extent, size_t inner,
+                                           const F &f, T identity) {
+  if (inner == 1) {
+    // Long runs are cut into fixed blocks, so they are split across the
+    // threads the same way whatever the number of threads
+    const size_t blocks = (extent + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+    if (blocks <= 1) {
+      Parallel::parallel_for(0, outer, Parallel::grain_for(extent),
+                             [&](size_t begin, size_t end) {
+                               for (size_t o = begin; o < end; o++) {
+                                 out[o] = reduce_run(in + o * extent, extent,
+                                                     f, identity);
+                               }
+                             });
+      return;
+    }
+
+    std::unique_ptr<T[]> partials(new T[outer * blocks]);
+    Parallel::parallel_for(
+        0, outer * blocks, Parallel::grain_for(REDUCE_BLOCK),
+        [&](size_t begin, size_t end) {
+          for (size_t task = begin; task < end; task++) {
+            size_t start = (task % blocks) * REDUCE_BLOCK;
+            size_t n = std::min(REDUCE_BLOCK, extent - start);
+            partials[task] = reduce_run(
+                in + (task / blocks) * extent + start, n, f, identity);
+          }
+        });
+    for (size_t o = 0; o < outer; o++) {
+      out[o] = reduce_run(partials.get() + o * blocks, blocks, f, identity);
+    }
+    return;
+  }
+
+  // Every output row folds in whole input rows, element by element along the
+  // contiguous inner dimension
+  Parallel::parallel_for(
+      0, outer * inner, Parallel::grain_for(extent),
+      [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end;) {
+          size_t o = i / inner;
+          size_t from = i % inner;
+          size_t to = std::min(inner, from + (end - i));
+          T *dst = out + o * inner;
+          std::fill(dst + from, dst + to, identity);
+          for (size_t r = 0; r < extent; r++) {
+            const T *src = in + (o * extent + r) * inner;
+            for (size_t j = from; j < to; j++) {
+              dst[j] = f(dst[j], src[j]);
+            }
+          }
+          i += to - from;
+        }
+      });
+}
+
+template <typename T>
+template <typename F>
+std::shared_ptr<Tensor<T>> TensorOperations<T>::reduce(
+    const std::shared_ptr<const Tensor<T>> a, const std::vector<int> &axes,
+    bool keep_dims, const F &f, T identity) {
+  const Shape &shape = a->get_shape();
+  const size_t rank = shape.size();
+
+  bool reduced[MAX_TENSOR_RANK] = {};
+  for (size_t d = 0; d < rank; d++) reduced[d] = axes.empty();
+  for (int axis : axes) reduced[normalize_axis(axis, rank)] = true;
+
+  Shape out_shape;
+  for (size_t d = 0; d < rank; d++) {
+    if (!reduced[d]) {
+      out_shape.push_back(shape[d]);
+    } else if (keep_dims) {
+      out_shape.push_back(1);
+    }
+  }
+  if (out_shape.size() == 0) out_shape.push_back(1);
+  auto out = std::make_shared<Tensor<T>>(out_shape, uninitialized);
+  T *dst = out->get_span().get_data();
+
+  if (a->get_size() == 0) {
+    std::fill(dst, dst + out->get_size(), identity);
+    return out;
+  }
+
+  // Neighbouring dimensions that are both reduced or both kept merge into one,
+  // and dimensions of size 1 make no difference either way
+  std::vector<std::pair<size_t, bool>> groups;
+  for (size_t d = 0; d < rank; d++) {
+    if (shape[d] == 1) continue;
+    if (!groups.empty() && groups.back().second == reduced[d]) {
+      groups.back().first *= shape[d];
+    } else {
+      groups.emplace_back(shape[d], reduced[d]);
+    }
+  }
+
+  const T *current = a->get_span().get_data();
+  std::unique_ptr<T[]> buffer;
+  bool reduced_any = false;
+
+  // Reduce the innermost reduced group until none is left, every step leaves
+  // a smaller tensor in the same row-major order
+  while (true) {
+    auto group = std::find_if(groups.rbegin(), groups.rend(),
+                              [](const auto &g) { return g.second; });
+    if (group == groups.rend()) break;
+    size_t g = groups.size() - 1 - (group - groups.rbegin());
+
+    size_t outer = 1;
+    size_t inner = 1;
+    for (size_t i = 0; i < g; i++) outer *= groups[i].first;
+    for (size_t i = g + 1; i < groups.size(); i++) inner *= groups[i].first;
+    bool last_step = std::none_of(groups.begin(), groups.begin() + g,
+                                  [](const auto &g) { return g.second; });
+
+    std::unique_ptr<T[]> next;
+    T *target = dst;
+    if (!last_step) {
+      next.reset(new T[outer * inner]);
+      target = next.get();
+    }
+    reduce_dimension(current, target, outer, groups[g].first, inner, f,
+                     identity);
+    reduced_any = true;
+
+    groups.erase(groups.begin() + g);
+    if (g > 0 && g < groups.size()) {
+      groups[g - 1].first *= groups[g].first;
+      groups.erase(groups.begin() + g);
+    }
+    if (!last_step) {
+      buffer = std::move(next);
+      current = buffer.get();
+    }
+  }
+
+  // Only axes of size 1 were reduced
+  if (!reduced_any) {
+    std::copy(current, current + a->get_size(), dst);
+  }
+  return out;
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> TensorOperations<T>::sum(
+    const std::shared_ptr<const Tensor<T>> a, const std::vector<int> &axes,
+    bool keep_dims) {
+  return reduce(a, axes, keep_dims, AddOp{}, T(0));
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> TensorOperations<T>::mean(
+    const std::shared_ptr<const Tensor<T>> a, const std::vector<int> &axes,
+    bool keep_dims) {
+  auto out = reduce(a, axes, keep_dims, AddOp{}, T(0));
+  const size_t count = a->get_size() / out->get_size();
+  if (count == 0 && !std::is_floating_point_v<T>) return out;
+
+  auto data = out->get_span();
+  for (size_t i = 0; i < out->get_size(); i++) {
+    data[i] = static_cast<T>(data[i] / static_cast<T>(count));
+  }
+  return out;
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> TensorOperations<T>::max(
+    const std::shared_ptr<const Tensor<T>> a, const std::vector<int> &axes,
+    bool keep_dims) {
+  return reduce(a, axes, keep_dims, MaxOp{}, lowest_value<T>());
+}
+
+template <typename T>
+std::shared_ptr<Tensor<T>> TensorOperations<T>::min(
+    const std::shared_ptr<const Tensor<T>> a, const std::vector<int> &axes,
+    bool keep_dims) {
+  return reduce(a, axes, keep_dims, MinOp{}, highest_value<T>());
+}
+
+template <typename T>
+int TensorOperations<T>::arg_max(const std::shared_ptr<const Tensor<T>> a) {
+  const auto size = a->get_size();
+  if (size == 0) {
+    throw std::runtime_error("arg_max called on an empty tensor.");
+  }
+  const T *data = a->get_span().get_data();
+
+  // The largest value of every block, then the first element equal to the
+  // largest of them, which is in the first block holding it
+  const size_t blocks = (size + REDUCE_BLOCK - 1) / REDUCE_BLOCK;
+  std::unique_ptr<T[]> partials(new T[blocks]);
+  Parallel::parallel_for(0, blocks, 1, [&](size_t begin, size_t end) {
+    for (size_t b = begin; b < end; b++) {
+      size_t start = b * REDUCE_BLOCK;
+      partials[b] = reduce_run(data + start,
+                               std::min(REDUCE_BLOCK, size - start),
+                               RankMaxOp{}, lowest_value<T>());
+    }
+  });
+  const T largest =
+      reduce_run(partials.get(), blocks, RankMaxOp{}, lowest_value<T>());
+
+  size_t block = 0;
+  while (block < blocks && !same_rank(partials[block], largest)) block++;
+  size_t i = block * REDUCE_BLOCK;
+  while (i < size && !same_rank(data[i], largest)) i++;
+  return i < size ? static_cast<int>(i) : 0;
+}
+
+template <typename T>
+std::shared_ptr<Tensor<int64_t>> TensorOperations<T>::arg_max(
+    const std::shared_ptr<const Tensor<T>> a, int axis, bool keep_dims) {
+  const Shape &shape = a->get_shape();
+  const size_t dim = normalize_axis(axis, shape.size());
+  const size_t extent = shape[dim];
+  if (extent == 0) {
+    throw std::invalid_argument("arg_max along an empty axis");
+  }
+
+  size_t outer = 1;
+  size_t inner = 1;
+  for (size_t d = 0; d < dim; d++) outer *= shape[d];
+  for (size_t d = dim + 1; d < shape.size(); d++) inner *= shape[d];
+
+  auto out = std::make_shared<Tensor<int64_t>>(
+      reduced_shape(shape, dim, 1, keep_dims), uninitialized);
+  int64_t *indices = out->get_span().get_data();
+  const T *data = a->get_span().get_data();
+
+  if (inner == 1) {
+    // The largest value of a contiguous row is found with the lanes of
+    // reduce_run, then a second pass finds where it first is
+    Parallel::parallel_for(
+        0, outer, Parallel::grain_for(2 * extent),
+        [&](size_t begin, size_t end) {
+          for (size_t o = begin; o < end; o++) {
+            const T *row = data + o * extent;
+            T largest =
+                reduce_run(row, extent, RankMaxOp{}, lowest_value<T>());
+            size_t i = 0;
+            while (i < extent && !same_rank(row[i], largest)) i++;
+            indices[o] = i < extent ? static_cast<int64_t>(i) : 0;
+          }
+        });
+    return out;
+  }
+
+  Parallel::parallel_for(
+      0, outer * inner, Parallel::grain_for(extent),
+      [&](size_t begin, size_t end) {
+        // The largest values so far of the columns of one outer index, no
+        // more than inner of which fall into the chunk at once
+        std::unique_ptr<T[]> best(new T[std::min(inner, end - begin)]);
+        for (size_t i = begin; i < end;) {
+          size_t o = i / inner;
+          size_t from = i % inner;
+          size_t to = std::min(inner, from + (end - i));
+          const T *first = data + o * extent * inner;
+          int64_t *dst = indices + o * inner;
+
+          std::copy(first + from, first + to, best.get());
+          std::fill(dst + from, dst + to, 0);
+          for (size_t r = 1; r < extent; r++) {
+            const T *src = first + r * inner;
+            for (size_t j = from; j < to; j++) {
+              if (ranks_above(src[j], best[j - from])) {
+                best[j - from] = src[j];
+                dst[j] = static_cast<int64_t>(r);
+              }
+            }
+          }
+          i += to - from;
+        }
+      });
+  return out;
+}
+
+template <typename T>
+std::pair<std::shared_ptr<Tensor<T>>, std::shared_ptr<Tensor<int64_t>>>
+TensorOperations<T>::top_k(const std::shared_ptr<const Tensor<T>> a, size_t k,
+                           int axis) {
+  const Shape &shape = a->get_shape();
+  const size_t dim = normalize_axis(axis, shape.size());
+  const size_t extent = shape[dim];
+  if (k > extent) {
+    throw std::invalid_argument("top_k: k = " + std::to_string(k) +
+                                " is larger than the axis of size " +
+                                std::to_string(extent));
+  }
+
+  size_t outer = 1;
+  size_t inner = 1;
+  for (size_t d = 0; d < dim; d++) outer *= shape[d];
+  for (size_t d = dim + 1; d < shape.size(); d++) inner *= shape[d];
+
+  Shape out_shape = reduced_shape(shape, dim, k, true);
+  auto values = std::make_shared<Tensor<T>>(out_shape, uninitialized);
+  auto indices = std::make_shared<Tensor<int64_t>>(out_shape, uninitialized);
+  const T *data = a->get_span().get_data();
+  T *value_data = values->get_span().get_data();
+  int64_t *index_data = indices->get_span().get_data();
+
+  // Every (outer, inner) pair is an independent search along the axis
+  Parallel::parallel_for(
+      0, outer * inner, Parallel::grain_for(extent * 4),
+      [&](size_t begin, size_t end) {
+        std::vector<size_t> order(extent);
+        for (size_t i = begin; i < end; i++) {
+          size_t o = i / inner;
+          size_t j = i % inner;
+          const T *first = data + o * extent * inner + j;
+
+          std::iota(order.begin(), order.end(), 0);
+          // NaNs rank above the numbers and tie with each other, so this is
+          // a strict weak order whatever the values
+          std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                            [&](size_t x, size_t y) {
+                              T vx = first[x * inner];
+                              T vy = first[y * inner];
+                              if (ranks_above(vx, vy)) return true;
+                              if (ranks_above(vy, vx)) return false;
+                              return x < y;
+                            });
+          for (size_t r = 0; r < k; r++) {
+            size_t out_index = (o * k + r) * inner + j;
+            value_data[out_index] = first[order[r] * inner];
+            index_data[out_index] = static_cast<int64_t>(order[r]);
+          }
+        }
+      });
+  return {values, indices};
+}
+
+template <typename T>
+bool TensorOperations<T>::equals(const std::shared_ptr<Tensor<T>> a,
+                                 const std::shared_ptr<Tensor<T>> b) {
+  if (a->get_size() != b->get_size() || a->get_shape() != b->get_shape()) {
+    return false;
+  }
+  const T *a_data = std::as_const(*a).get_span().get_data();
+  const T *b_data = std::as_const(*b).get_span().get_data();
+  const size_t size = a->get_size();
+  return Parallel::find_first(0, size, 2, [&](size_t i) {
+           return a_data[i] != b_data[i];
+         }) == size;
+}
+
+template <typename T>
+bool TensorOperations<T>::all_close(const std::shared_ptr<const Tensor<T>> a,
+                                    const std::shared_ptr<const Tensor<T>> b,
+                                    double rtol, double atol) {
+  if (!(a->get_shape() == b->get_shape())) return false;
+  const T *a_data = a->get_span().get_data();
+  const T *b_data = b->get_span().get_data();
+  const size_t size = a->get_size();
+
+  // Written as a negated comparison so a NaN fails the check
+  return Parallel::find_first(0, size, 6, [&](size_t i) {
+           double x = static_cast<double>(a_data[i]);
+           double y = static_cast<double>(b_data[i]);
+           return !(std::abs(x - y) <= atol + rtol * std::abs(y));
+         }) == size;
+}
+
+#define TYPE(DT) _TENSOR_OPERATIONS(DT)
+#include "types_integer.txt"
+#include "types_real.txt"
+#undef TYPE
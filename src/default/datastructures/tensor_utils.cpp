@@ -1,5 +1,9 @@
 #include "datastructures/tensor_utils.hpp"
 
+#include <utility>
+
+#include "utility/parallel.hpp"
+
 namespace TensorUtils {
 
 template <typename T>
@@ -14,7 +18,11 @@ bool tensors_are_close(Tensor<T> &t1, Tensor<T> &t2, T tolerance) {
     return false;
   }
 
-  for (size_t i = 0; i < t1.get_size(); i++) {
+  const T *a = std::as_const(t1).get_span().get_data();
+  const T *b = std::as_const(t2).get_span().get_data();
+
+  // The difference between a pair of elements and the largest one allowed
+  auto compare = [&](size_t i) {
     // Handle different numeric types properly to avoid ambiguous abs()
     T diff;
     T tolerance_limit;
@@ -22,28 +30,38 @@ bool tensors_are_close(Tensor<T> &t1, Tensor<T> &t2, T tolerance) {
     if constexpr (std::is_unsigned_v<T>) {
       // For unsigned types, use direct subtraction with checks to avoid
       // underflow
-      diff = t1[i] > t2[i] ? t1[i] - t2[i] : t2[i] - t1[i];
+      diff = a[i] > b[i] ? a[i] - b[i] : b[i] - a[i];
 
       tolerance_limit =
-          std::max(static_cast<T>(1), static_cast<T>(tolerance * t2[i]));
+          std::max(static_cast<T>(1), static_cast<T>(tolerance * b[i]));
     } else if constexpr (std::is_floating_point_v<T>) {
-      diff = std::abs(t1[i] - t2[i]);
+      diff = std::abs(a[i] - b[i]);
       tolerance_limit =
-          std::max(static_cast<T>(0.00001), std::abs(tolerance * t2[i]));
+          std::max(static_cast<T>(0.00001), std::abs(tolerance * b[i]));
     } else {
       // Avoid underflow for signed types
-      diff = std::abs(static_cast<long long>(t1[i]) -
-                      static_cast<long long>(t2[i]));
+      diff = std::abs(static_cast<long long>(a[i]) -
+                      static_cast<long long>(b[i]));
       tolerance_limit = std::max(static_cast<T>(0),
-                                 static_cast<T>(std::abs(tolerance * t2[i])));
-    }
-
-    if (diff > tolerance_limit) {
-      std::cerr << "Difference of " << diff << " found at (" << i
-                << ") which is too large." << std::endl;
-      std::cerr << "Tolerance limit is " << tolerance_limit << std::endl;
-      return false;
+                                 static_cast<T>(std::abs(tolerance * b[i])));
     }
+    return std::make_pair(diff, tolerance_limit);
+  };
+
+  // Large tensors are scanned on the thread pool, and the first failing
+  // element is still the one reported
+  const size_t size = t1.get_size();
+  size_t first = Parallel::find_first(0, size, 4, [&](size_t i) {
+    auto [diff, tolerance_limit] = compare(i);
+    return diff > tolerance_limit;
+  });
+
+  if (first < size) {
+    auto [diff, tolerance_limit] = compare(first);
+    std::cerr << "Difference of " << diff << " found at (" << first
+              << ") which is too large." << std::endl;
+    std::cerr << "Tolerance limit is " << tolerance_limit << std::endl;
+    return false;
   }
 
   return true;
@@ -0,0 +1,309 @@
+#include "datastructures/tensor_view.hpp"
+
+#include "datastructures/tensor.hpp"
+#include "utility/parallel.hpp"
+
+template <typename T>
+TensorView<T>::TensorView(std::shared_ptr<T[]> data, size_t offset,
+                          Shape shape, Shape strides)
+    : data(std::move(data)),
+      offset(offset),
+      shape(std::move(shape)),
+      strides(std::move(strides)) {
+  if (this->shape.size() != this->strides.size())
+    throw std::invalid_argument("TensorView: shape and strides differ in rank");
+}
+
+template <typename T>
+T &TensorView<T>::at(const Shape &indices) const {
+  if (indices.size() != shape.size())
+    throw std::invalid_argument("TensorView: wrong number of indices");
+  size_t position = offset;
+  for (size_t dim = 0; dim < shape.size(); dim++) {
+    if (indices[dim] >= shape[dim])
+      throw std::invalid_argument("TensorView: index out of range");
+    position += indices[dim] * strides[dim];
+  }
+  return data[position];
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::transpose(const std::vector<int> &perm) const {
+  size_t rank = shape.size();
+  if (perm.size() != rank)
+    throw std::invalid_argument(
+        "Transpose: perm size must be equal to tensor rank");
+
+  std::vector<bool> seen(rank, false);
+  Shape new_shape(rank);
+  Shape new_strides(rank);
+  for (size_t i = 0; i < rank; i++) {
+    if (perm[i] < 0 || static_cast<size_t>(perm[i]) >= rank || seen[perm[i]])
+      throw std::invalid_argument(
+          "Transpose: invalid or duplicate entry in perm");
+    seen[perm[i]] = true;
+    new_shape[i] = shape[perm[i]];
+    new_strides[i] = strides[perm[i]];
+  }
+
+  return TensorView<T>(data, offset, std::move(new_shape),
+                       std::move(new_strides));
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::broadcast(
+    const Shape &target_shape) const {
+  size_t rank = shape.size();
+  size_t target_rank = target_shape.size();
+  if (target_rank < rank)
+    throw std::invalid_argument("Cannot broadcast tensor to a lower rank");
+
+  // Align the trailing dimensions, the leading new ones repeat everything
+  size_t new_dims = target_rank - rank;
+  Shape new_strides(target_rank);
+  new_strides.fill(0);
+  for (size_t dim = 0; dim < rank; dim++) {
+    size_t target = target_shape[dim + new_dims];
+    if (shape[dim] == target) {
+      new_strides[dim + new_dims] = strides[dim];
+    } else if (shape[dim] != 1) {
+      throw std::invalid_argument("Cannot broadcast tensor to target shape");
+    }
+  }
+
+  return TensorView<T>(data, offset, target_shape, std::move(new_strides));
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::slice(size_t dim, size_t begin,
+                                   size_t end) const {
+  if (dim >= shape.size() || begin > end || end > shape[dim])
+    throw std::invalid_argument("TensorView: slice out of range");
+
+  Shape new_shape = shape;
+  new_shape[dim] = end - begin;
+  return TensorView<T>(data, offset + begin * strides[dim],
+                       std::move(new_shape), strides);
+}
+
+template <typename T>
+TensorView<T> TensorView<T>::select(size_t dim, size_t index) const {
+  if (dim >= shape.size() || index >= shape[dim])
+    throw std::invalid_argument("TensorView: select out of range");
+
+  Shape new_shape(shape.size() - 1);
+  Shape new_strides(shape.size() - 1);
+  for (size_t i = 0, j = 0; i < shape.size(); i++) {
+    if (i == dim) continue;
+    new_shape[j] = shape[i];
+    new_strides[j] = strides[i];
+    j++;
+  }
+  return TensorView<T>(data, offset + index * strides[dim],
+                       std::move(new_shape), std::move(new_strides));
+}
+
+namespace {
+
+// The side of the square tiles the transposing copy works on, a tile of
+// floats then spans a few cache lines in both the source and the destination
+constexpr size_t TRANSPOSE_TILE = 32;
+
+}  // namespace
+
+template <typename T>
+void TensorView<T>::copy_to(Tensor<element_type> &destination) const {
+  copy_into(destination);
+}
+
+template <typename T>
+void TensorView<T>::copy_to(Tensor<float> &destination) const
+  requires(is_half_v<element_type>)
+{
+  copy_into(destination);
+}
+
+template <typename T>
+template <typename U>
+void TensorView<T>::copy_into(Tensor<U> &destination) const {
+  if (destination.get_shape() != shape)
+    throw std::invalid_argument(
+        "TensorView: destination shape does not match the view");
+
+  auto out = destination.get_span();
+  size_t rank = shape.size();
+  if (rank == 0) {
+    out[0] = data[offset];
+    return;
+  }
+  if (get_size() == 0) return;
+
+  // A permutation that moves the contiguous dimension of the source away from
+  // the last one would read a whole cache line per element, so the two
+  // dimensions are copied as square tiles instead. This covers both swapping
+  // the last two axes and NCHW <-> NHWC.
+  if (strides[rank - 1] != 1 && shape[rank - 1] > 1) {
+    for (size_t dim = 0; dim + 1 < rank; dim++) {
+      if (strides[dim] == 1 && shape[dim] > 1) {
+        copy_tiled(out.get_data(), dim);
+        return;
+      }
+    }
+  }
+  copy_rows(out.get_data());
+}
+
+template <typename T>
+template <typename U>
+void TensorView<T>::copy_rows(U *out) const {
+  // Copy row by row along the last dimension, the other indices of a row are
+  // only computed once
+  size_t rank = shape.size();
+  size_t inner = shape[rank - 1];
+  size_t inner_stride = strides[rank - 1];
+  size_t rows = get_size() / inner;
+  const T *source = data.get();
+
+  Parallel::parallel_for(
+      0, rows, Parallel::grain_for(inner), [&](size_t begin, size_t end) {
+        for (size_t row = begin; row < end; row++) {
+          size_t position = offset;
+          size_t rest = row;
+          for (size_t dim = rank - 1; dim-- > 0;) {
+            position += (rest % shape[dim]) * strides[dim];
+            rest /= shape[dim];
+          }
+
+          const T *row_source = source + position;
+          U *row_out = out + row * inner;
+          if (inner_stride == 1) {
+            if constexpr (std::is_same_v<U, element_type>) {
+              std::copy(row_source, row_source + inner, row_out);
+            } else {
+              element_type::to_float(row_source, row_out, inner);
+            }
+          } else {
+            for (size_t i = 0; i < inner; i++) {
+              row_out[i] = row_source[i * inner_stride];
+            }
+          }
+        }
+      });
+}
+
+template <typename T>
+template <typename U>
+void TensorView<T>::copy_tiled(U *out, size_t tile_dim) const {
+  // Every plane spanned by tile_dim and the last dimension is a transposed
+  // matrix, contiguous along tile_dim in the source and along the last
+  // dimension in the destination
+  size_t rank = shape.size();
+  size_t rows = shape[tile_dim];
+  size_t cols = shape[rank - 1];
+  size_t col_stride = strides[rank - 1];
+
+  // The row-major strides of the destination
+  Shape out_strides(rank);
+  out_strides[rank - 1] = 1;
+  for (size_t dim = rank - 1; dim-- > 0;) {
+    out_strides[dim] = out_strides[dim + 1] * shape[dim + 1];
+  }
+  size_t row_out_stride = out_strides[tile_dim];
+
+  size_t planes = get_size() / (rows * cols);
+  size_t row_tiles = (rows + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  size_t col_tiles = (cols + TRANSPOSE_TILE - 1) / TRANSPOSE_TILE;
+  const T *source = data.get();
+
+  Parallel::parallel_for(
+      0, planes * row_tiles,
+      Parallel::grain_for(TRANSPOSE_TILE * cols),
+      [&](size_t begin, size_t end) {
+        for (size_t task = begin; task < end; task++) {
+          // Find the first element of the plane in the source and destination
+          size_t plane = task / row_tiles;
+          size_t row_begin = (task % row_tiles) * TRANSPOSE_TILE;
+          size_t row_end = std::min(row_begin + TRANSPOSE_TILE, rows);
+          size_t in_position = offset;
+          size_t out_position = 0;
+          size_t rest = plane;
+          for (size_t dim = rank - 1; dim-- > 0;) {
+            if (dim == tile_dim) continue;
+            size_t index = rest % shape[dim];
+            rest /= shape[dim];
+            in_position += index * strides[dim];
+            out_position += index * out_strides[dim];
+          }
+
+          const T *plane_source = source + in_position;
+          U *plane_out = out + out_position;
+          for (size_t col_tile = 0; col_tile < col_tiles; col_tile++) {
+            size_t col_begin = col_tile * TRANSPOSE_TILE;
+            size_t col_end = std::min(col_begin + TRANSPOSE_TILE, cols);
+            for (size_t row = row_begin; row < row_end; row++) {
+              const T *row_source = plane_source + row;
+              U *row_out = plane_out + row * row_out_stride;
+              for (size_t col = col_begin; col < col_end; col++) {
+                row_out[col] = row_source[col * col_stride];
+              }
+            }
+          }
+        }
+      });
+}
+
+template <typename T>
+std::shared_ptr<Tensor<typename TensorView<T>::element_type>>
+TensorView<T>::to_tensor() const {
+  auto tensor = std::make_shared<Tensor<element_type>>(shape, uninitialized);
+  copy_to(*tensor);
+  return tensor;
+}
+
+template <typename T>
+bool TensorView<T>::is_contiguous() const {
+  size_t expected = 1;
+  for (size_t dim = shape.size(); dim-- > 0;) {
+    if (shape[dim] != 1 && strides[dim] != expected) return false;
+    expected *= shape[dim];
+  }
+  return true;
+}
+
+template <typename T>
+T *TensorView<T>::get_data() const {
+  return data.get() + offset;
+}
+
+template <typename T>
+const std::shared_ptr<T[]> &TensorView<T>::get_buffer() const {
+  return data;
+}
+
+template <typename T>
+size_t TensorView<T>::get_offset() const {
+  return offset;
+}
+
+template <typename T>
+const Shape &TensorView<T>::get_shape() const {
+  return shape;
+}
+
+template <typename T>
+const Shape &TensorView<T>::get_strides() const {
+  return strides;
+}
+
+template <typename T>
+size_t TensorView<T>::get_size() const {
+  size_t size = 1;
+  for (size_t dim : shape) size *= dim;
+  return size;
+}
+
+#define TYPE(DT) _TENSOR_VIEW(DT)
+#include "types_integer.txt"
+#include "types_real.txt"
+#include "types_half.txt"
+#undef TYPE
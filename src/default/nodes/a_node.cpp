@@ -0,0 +1,54 @@
+#include "nodes/a_node.hpp"
+
+TensorTable::TensorTable(size_t num_slots) : tensors(num_slots) {}
+
+void TensorTable::reset(size_t num_slots) {
+  tensors.assign(num_slots, GeneralDataTypes());
+}
+
+size_t TensorTable::size() const { return tensors.size(); }
+
+bool TensorTable::contains(size_t slot) const {
+  return std::visit([](const auto &tensor) { return tensor != nullptr; },
+                    tensors[slot]);
+}
+
+GeneralDataTypes &TensorTable::operator[](size_t slot) { return tensors[slot]; }
+
+const GeneralDataTypes &TensorTable::operator[](size_t slot) const {
+  return tensors[slot];
+}
+
+void TensorTable::erase(size_t slot) { tensors[slot] = GeneralDataTypes(); }
+
+void Node::forward(std::unordered_map<std::string, GeneralDataTypes> &iomap) {
+  std::vector<std::string> names = getInputs();
+  size_t num_inputs = names.size();
+  for (auto &output : getOutputs()) {
+    names.push_back(std::move(output));
+  }
+
+  // Every input and output gets its own slot in a temporary table
+  TensorTable table(names.size());
+  std::vector<size_t> input_slots(num_inputs);
+  std::vector<size_t> output_slots(names.size() - num_inputs);
+  for (size_t slot = 0; slot < names.size(); slot++) {
+    auto it = iomap.find(names[slot]);
+    if (it != iomap.end()) {
+      table[slot] = it->second;
+    }
+    if (slot < num_inputs) {
+      input_slots[slot] = slot;
+    } else {
+      output_slots[slot - num_inputs] = slot;
+    }
+  }
+
+  forward(table, input_slots, output_slots);
+
+  for (size_t slot = num_inputs; slot < names.size(); slot++) {
+    if (table.contains(slot)) {
+      iomap[names[slot]] = table[slot];
+    }
+  }
+}
@@ -69,14 +69,14 @@ AvgPoolNode::AvgPoolNode(const nlohmann::json& node) {
   }
 }
 
-void AvgPoolNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes>& iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("AvgPoolNode: Input tensor X not found in iomap");
+void AvgPoolNode::forward(TensorTable &table,
+                          const std::vector<size_t> &inputs,
+                          const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("AvgPoolNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes& x_tensor = x_it->second;
+  const GeneralDataTypes& x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto& x_ptr) {
@@ -87,7 +87,7 @@ void AvgPoolNode::forward(
           throw std::runtime_error(
               "AvgPoolNode: Unsupported data type for tensor X");
         } else {
-          array_mml<size_t> x_shape = x_ptr->get_shape();
+          Shape x_shape = x_ptr->get_shape();
           size_t total_rank = x_shape.size();
 
           if (total_rank < 3) {
@@ -98,7 +98,7 @@ void AvgPoolNode::forward(
           NodeUtils::compute_pool_attributes(auto_pad, kernel_shape, strides,
                                              pads, dilations);
 
-          array_mml<size_t> output_shape = NodeUtils::compute_pool_output_shape(
+          Shape output_shape = NodeUtils::compute_pool_output_shape(
               x_shape, auto_pad, ceil_mode, dilations, kernel_shape, pads,
               strides);
 
@@ -106,22 +106,22 @@ void AvgPoolNode::forward(
               x_shape, auto_pad, ceil_mode, dilations, kernel_shape, pads,
               strides);
 
-          auto y_ptr = std::make_shared<Tensor<ValueType>>(output_shape);
+          auto y_ptr =
+              std::make_shared<Tensor<ValueType>>(output_shape, uninitialized);
 
           // Perform pooling operation
           TensorOperations<ValueType>::sliding_window(
               x_shape, output_shape, kernel_shape, strides, dilations, pad_pair,
               [this, x_ptr, y_ptr](
-                  const std::vector<std::vector<size_t>>& window_in_idx,
-                  const std::vector<size_t>& out_idx) -> void {
+                  const std::vector<Shape>& window_in_idx,
+                  const Shape& out_idx) -> void {
                 if (window_in_idx.empty()) {
                   throw std::runtime_error("AvgPoolNode: Empty window values");
                 }
 
                 ValueType sum = 0;
                 for (const auto& in_idx : window_in_idx) {
-                  array_mml<size_t> curr_idx(in_idx);
-                  sum += (*x_ptr)[curr_idx];
+                  sum += (*x_ptr)[in_idx];
                 }
 
                 int kernel_volume = 1;
@@ -133,12 +133,10 @@ void AvgPoolNode::forward(
                                       ? kernel_volume
                                       : static_cast<int>(window_in_idx.size());
 
-                array_mml<size_t> out_idx_array(out_idx);
-                (*y_ptr)[out_idx_array] =
-                    sum / static_cast<ValueType>(denominator);
+                (*y_ptr)[out_idx] = sum / static_cast<ValueType>(denominator);
               });
 
-          iomap[Y] = y_ptr;
+          table[outputs.at(0)] = y_ptr;
         }
       },
       x_tensor);
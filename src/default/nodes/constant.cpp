@@ -66,9 +66,10 @@ ConstantNode::ConstantNode(const nlohmann::json &node) {
   }
 }
 
-void ConstantNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  iomap[output] = value;
+void ConstantNode::forward(TensorTable &table,
+                           const std::vector<size_t> &inputs,
+                           const std::vector<size_t> &outputs) {
+  table[outputs.at(0)] = value;
 }
 
 std::vector<std::string> ConstantNode::getInputs() { return {}; }
@@ -1,5 +1,9 @@
 #include "nodes/conv.hpp"
 
+#include <utility>
+
+#include "utility/parallel.hpp"
+
 ConvNode::ConvNode(const std::string &X, const std::string &W,
                    const std::string &Y, const array_mml<size_t> &dilations,
                    const array_mml<size_t> &padding,
@@ -89,20 +93,19 @@ ConvNode::ConvNode(const nlohmann::json &node) {
   }
 }
 
-void ConvNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("ConvNode: Input tensor X not found in iomap");
+void ConvNode::forward(TensorTable &table,
+                       const std::vector<size_t> &inputs,
+                       const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("ConvNode: Input tensor X not found in table");
   }
 
-  auto w_it = iomap.find(W);
-  if (w_it == iomap.end()) {
-    throw std::runtime_error("ConvNode: Input tensor W not found in iomap");
+  if (!table.contains(inputs.at(1))) {
+    throw std::runtime_error("ConvNode: Input tensor W not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
-  const GeneralDataTypes &w_tensor = w_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
+  const GeneralDataTypes &w_tensor = table[inputs.at(1)];
 
   std::visit(
       [&](const auto &x_ptr, const auto &w_ptr) {
@@ -111,80 +114,125 @@ void ConvNode::forward(
         using ValueTypeW =
             typename std::decay_t<decltype(w_ptr)>::element_type::value_type;
 
-        if constexpr (!is_in_variant_v<ValueTypeX, T> ||
-                      !std::is_same_v<ValueTypeX, ValueTypeW>) {
+        // Weights stored as 16-bit floats are widened in registers by the
+        // GEMM as they are read, and are never copied
+        constexpr bool half_weights =
+            std::is_same_v<ValueTypeX, float> && is_half_v<ValueTypeW>;
+
+        if constexpr (!half_weights &&
+                      (!is_in_variant_v<ValueTypeX, T> ||
+                       !std::is_same_v<ValueTypeX, ValueTypeW>)) {
           throw std::runtime_error(
               "ConvNode: Unsupported data type for tensor data");
         } else {
-          if (x_ptr->get_shape().size() < 1) {
+          if (x_ptr->get_shape().size() != 4) {
             throw std::runtime_error(
-                "Input tensor must have 4 dimensions: "
+                "ConvNode: Input tensor X must have 4 dimensions: "
+                "(Batch x Channels x Height x Width).");
+          }
+          if (w_ptr->get_shape().size() != 4) {
+            throw std::runtime_error(
+                "ConvNode: Weight tensor W must have 4 dimensions: "
                 "(Features x Channels x Height x Width).");
           }
 
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
+            auto y_ptr = std::make_shared<Tensor<ValueTypeX>>(
+                x_ptr->get_shape(), uninitialized);
             // No need to fill with zeros as the convolution std::function will
             // overwrite the values
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor)) {
             throw std::runtime_error(
                 "ConvNode: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor);
 
           // infer and update attributes first
           update_parameters(x_ptr->get_shape(), w_ptr->get_shape());
 
-          // Create a std::copy of the input
-          auto input_copy = x_ptr->copy();
-
-          auto im2col_output_shape = array_mml<size_t>(
-              {get_in_channels() * get_kernel_height() * get_kernel_width(),
-               get_batch_size() * get_out_height() * get_out_width()});
-
-          auto im2col_output =
-              std::make_shared<Tensor<ValueTypeX>>(im2col_output_shape);
-
-          im2col(input_copy, im2col_output);
-
-          // Flatten the weight tensor to prepare for GEMM
           size_t flattened_size =
               get_in_channels() * get_kernel_height() * get_kernel_width();
-          w_ptr->reshape({get_out_channels(), flattened_size});
-
-          // Prepare the result tensor
-          array_mml<size_t> result_shape(
-              {w_ptr->get_shape()[0], im2col_output->get_shape()[1]});
-          auto result_ptr = std::make_shared<Tensor<ValueTypeX>>(result_shape);
-
-          TensorOperations<ValueTypeX>::gemm(
-              0, 0, w_ptr->get_shape()[0], im2col_output->get_shape()[1],
-              w_ptr->get_shape()[1], 1.0f, 0.0f, w_ptr, w_ptr->get_shape()[1],
-              im2col_output, im2col_output->get_shape()[1], result_ptr,
-              result_ptr->get_shape()[1]);
-
+          size_t out_plane = get_out_height() * get_out_width();
+          size_t positions = get_batch_size() * out_plane;
+          std::shared_ptr<Tensor<ValueTypeX>> result_ptr;
+
+          if constexpr (half_weights) {
+            // The 16-bit GEMM reads W as the transposed right operand, so the
+            // patches are laid out as rows and every row of the product holds
+            // the output channels of one position
+            auto patches = std::make_shared<Tensor<float>>(
+                Shape{positions, flattened_size}, uninitialized);
+            im2col(x_ptr, patches, true);
+
+            result_ptr = std::make_shared<Tensor<float>>(
+                Shape{positions, get_out_channels()}, uninitialized);
+            TensorOperations<float>::gemm_half<ValueTypeW>(
+                1, positions, get_out_channels(), flattened_size, 1.0f, 0.0f,
+                patches, flattened_size, w_ptr, flattened_size, result_ptr,
+                get_out_channels());
+
+            // Move the output channels of every image in front of its
+            // positions
+            result_ptr->reshape(
+                {get_batch_size(), out_plane, get_out_channels()});
+            auto planar = std::make_shared<Tensor<float>>(
+                Shape{get_batch_size(), get_out_channels(), out_plane},
+                uninitialized);
+            result_ptr->view().transpose({0, 2, 1}).copy_to(*planar);
+            result_ptr = planar;
+          } else {
+            auto im2col_output = std::make_shared<Tensor<ValueTypeX>>(
+                Shape{flattened_size, positions}, uninitialized);
+
+            im2col(x_ptr, im2col_output);
+
+            // Flatten the weight tensor to prepare for GEMM. The weights are
+            // shared between inferences and nodes, so W is only read and
+            // itself left untouched.
+            auto w_flat = std::as_const(*w_ptr).reshaped(
+                {get_out_channels(), flattened_size});
+
+            // Prepare the result tensor
+            Shape result_shape = {w_flat->get_shape()[0],
+                                  im2col_output->get_shape()[1]};
+            result_ptr = std::make_shared<Tensor<ValueTypeX>>(result_shape,
+                                                              uninitialized);
+
+            TensorOperations<ValueTypeX>::gemm(
+                0, 0, w_flat->get_shape()[0], im2col_output->get_shape()[1],
+                w_flat->get_shape()[1], 1.0f, 0.0f, w_flat,
+                w_flat->get_shape()[1], im2col_output,
+                im2col_output->get_shape()[1], result_ptr,
+                result_ptr->get_shape()[1]);
+
+            // The columns of the images follow each other, so with a batch
+            // the images are moved in front of the output channels
+            if (get_batch_size() > 1) {
+              result_ptr->reshape(
+                  {get_out_channels(), get_batch_size(), out_plane});
+              auto batched = std::make_shared<Tensor<ValueTypeX>>(
+                  Shape{get_batch_size(), get_out_channels(), out_plane},
+                  uninitialized);
+              result_ptr->view().transpose({1, 0, 2}).copy_to(*batched);
+              result_ptr = batched;
+            }
+          }
           result_ptr->reshape({get_batch_size(), get_out_channels(),
                                get_out_height(), get_out_width()});
 
           // Provided a bias, add it to the result tensor across each output
           // feature
           if (B.has_value()) {
-            auto b_it = iomap.find(B.value());
-            if (b_it == iomap.end()) {
+            if (!table.contains(inputs.at(2))) {
               throw std::runtime_error(
-                  "ConvNode: Input tensor B not found in iomap");
+                  "ConvNode: Input tensor B not found in table");
             }
-            auto b_ptr =
-                std::get<std::shared_ptr<Tensor<ValueTypeX>>>(b_it->second);
-
-            add_bias(result_ptr, b_ptr);
+            add_bias(result_ptr, table[inputs.at(2)]);
           }
 
           // Write over the content of the output with the result of the
@@ -206,91 +254,103 @@ std::vector<std::string> ConvNode::getInputs() {
 std::vector<std::string> ConvNode::getOutputs() { return {Y}; }
 
 void ConvNode::im2col(const TensorT &input_variant,
-                      const TensorT &output_variant) {
+                      const TensorT &output_variant, bool transposed) {
   std::visit(
-      [this](auto &input, auto &output) {
-        // Iterate over each image in the batch
+      [this, transposed](auto &input, auto &output) {
+        using ValueType =
+            typename std::decay_t<decltype(*output)>::value_type;
+
+        // The indices are computed below, so the elements are accessed
+        // without checks
+        auto in = std::as_const(*input).get_span();
+        auto out = output->get_span();
+
+        // Every image of the batch owns its own block of columns, and every
+        // element of the im2col matrix is written, padding included.
+        // Transposed, a patch is a row instead and the roles swap.
+        size_t out_plane = get_out_height() * get_out_width();
+        size_t patch_size =
+            get_in_channels() * get_kernel_height() * get_kernel_width();
+        size_t columns = get_batch_size() * out_plane;
+        size_t row_stride = transposed ? 1 : columns;
+        size_t col_stride = transposed ? patch_size : 1;
+
         for (size_t n = 0; n < get_batch_size(); ++n) {
-          for (size_t h = 0; h < get_out_height(); ++h) {
-            for (size_t w = 0; w < get_out_width();
-                 ++w) {  // Traverse into each batch
-
-              size_t col_index =
-                  h * get_out_width() + w;  // Column index in im2col matrix
-
-              for (size_t c = 0; c < get_in_channels();
-                   ++c) {  // If the input has multiple channels, iterate over
-                           // each one
-
-                // Here we loop over the kernel's height and width, simulating
-                // how the kernel moves across the input tensor. For each
-                // position of the kernel, the corresponding input values are
-                // extracted and stored in the output tensor. If the kernel
-                // extends beyond the boundaries of the input (due to padding or
-                // stride), zero padding is added instead of the input values.
-                for (size_t kh = 0; kh < get_kernel_height(); ++kh) {
-                  for (size_t kw = 0; kw < get_kernel_width(); ++kw) {
-                    size_t input_h =
-                        h * get_stride_height() - get_padding_top() + kh;
-                    size_t input_w =
-                        w * get_stride_width() - get_padding_left() + kw;
-
-                    if (input_h < 0 ||
-                        input_h >= get_in_height() + get_padding_bottom() ||
-                        input_w < 0 ||
-                        input_w >= get_in_width() + get_padding_right()) {
-                      (*output)[col_index] = 0;  // Padding
-                    } else {
-                      size_t row_index =
-                          c * get_kernel_height() * get_kernel_width() +
-                          kh * get_kernel_width() + kw;
-
-                      size_t output_index =
-                          row_index * (get_out_height() * get_out_width()) +
-                          col_index;
-
-                      size_t input_index =
-                          n * (get_in_channels() * get_in_height() *
-                               get_in_width()) +
-                          c * (get_in_height() * get_in_width()) +
-                          input_h * get_in_width() + input_w;
-
-                      // Check if input index is valid
-                      if (input_index >= 0 &&
-                          input_index < get_in_channels() * get_in_height() *
-                                            get_in_width()) {
-                        (*output)[output_index] = (*input)[input_index];
+          // Every output position writes its own column of the im2col
+          // matrix, so the output rows are split across the threads
+          Parallel::parallel_for(
+              0, get_out_height(),
+              Parallel::grain_for(get_out_width() * get_in_channels() *
+                                  get_kernel_height() * get_kernel_width()),
+              [&](size_t h_begin, size_t h_end) {
+                for (size_t h = h_begin; h < h_end; ++h) {
+                  for (size_t w = 0; w < get_out_width(); ++w) {
+                    size_t col_index = n * out_plane + h * get_out_width() + w;
+
+                    for (size_t c = 0; c < get_in_channels(); ++c) {
+                      // The kernel is moved across the input, positions in
+                      // the padding wrap around to large values and read as
+                      // zero
+                      for (size_t kh = 0; kh < get_kernel_height(); ++kh) {
+                        size_t input_h =
+                            h * get_stride_height() + kh - get_padding_top();
+                        for (size_t kw = 0; kw < get_kernel_width(); ++kw) {
+                          size_t input_w =
+                              w * get_stride_width() + kw - get_padding_left();
+                          size_t row_index =
+                              (c * get_kernel_height() + kh) *
+                                  get_kernel_width() +
+                              kw;
+
+                          ValueType value = 0;
+                          if (input_h < get_in_height() &&
+                              input_w < get_in_width()) {
+                            value = in(n, c, input_h, input_w);
+                          }
+                          out[row_index * row_stride +
+                              col_index * col_stride] = value;
+                        }
                       }
                     }
                   }
                 }
-              }
-            }
-          }
+              });
         }
       },
       input_variant, output_variant);
 }
 
 void ConvNode::add_bias(const TensorT &result_variant,
-                        const TensorT &bias_variant) {
+                        const GeneralDataTypes &bias_variant) {
   std::visit(
       [this](auto &result, auto &bias) {
-        for (size_t b = 0; b < get_batch_size(); b++) {
-          for (size_t i = 0; i < get_out_channels(); ++i) {
-            for (size_t h = 0; h < get_out_height(); ++h) {
-              for (size_t w = 0; w < get_out_width(); ++w) {
-                size_t index =
-                    ((b * get_out_channels() + i) * get_out_height() + h) *
-                        get_out_width() +
-                    w;
-
-                // Each value in bias std::vector is added to one entire out
-                // feature at a time
-                (*result)[index] += (*bias)[i];
-              }
-            }
-          }
+        using ValueType =
+            typename std::decay_t<decltype(result)>::element_type::value_type;
+        using ValueTypeB =
+            typename std::decay_t<decltype(bias)>::element_type::value_type;
+
+        // Viewed as {C, 1, 1} the bias is constant along every output plane,
+        // which the broadcast runs as one scalar per inner loop
+        auto add_planes = [&](const auto &values) {
+          auto bias_planes =
+              std::as_const(*values).reshaped({get_out_channels(), 1, 1});
+          TensorOperations<ValueType>::broadcast(result, bias_planes, AddOp{},
+                                                 result);
+        };
+
+        if constexpr (std::is_same_v<ValueType, ValueTypeB>) {
+          add_planes(bias);
+        } else if constexpr (std::is_same_v<ValueType, float> &&
+                             is_half_v<ValueTypeB>) {
+          // A 16-bit bias holds one value per output channel, so it is
+          // widened into a small float tensor first
+          auto widened =
+              std::make_shared<Tensor<float>>(bias->get_shape(), uninitialized);
+          std::as_const(*bias).view().copy_to(*widened);
+          add_planes(widened);
+        } else {
+          throw std::runtime_error(
+              "ConvNode: Bias tensor B has a different type than Y");
         }
       },
       result_variant, bias_variant);
@@ -336,14 +396,26 @@ size_t ConvNode::get_out_width() {
          1;
 }
 
-void ConvNode::update_parameters(const array_mml<size_t> &input_shape,
-                                 const array_mml<size_t> &weight_shape) {
-  kernel_height = weight_shape[2];
-  kernel_width = weight_shape[3];
-  batch_size = input_shape[0];
-  in_channels = input_shape[1];
-
-  in_height = input_shape[2];
-  in_width = input_shape[3];
-  out_channels = weight_shape[0];
+void ConvNode::update_parameters(const Shape &input_shape,
+                                 const Shape &weight_shape) {
+  kernel_height = weight_shape.at(2);
+  kernel_width = weight_shape.at(3);
+  batch_size = input_shape.at(0);
+  in_channels = input_shape.at(1);
+
+  in_height = input_shape.at(2);
+  in_width = input_shape.at(3);
+  out_channels = weight_shape.at(0);
+
+  // The sizes of the output are unsigned, so a mismatch would wrap around
+  if (weight_shape.at(1) != in_channels) {
+    throw std::runtime_error("ConvNode: W has " +
+                             std::to_string(weight_shape.at(1)) +
+                             " channels but X has " +
+                             std::to_string(in_channels));
+  }
+  if (in_height + get_padding_top() + get_padding_bottom() < kernel_height ||
+      in_width + get_padding_left() + get_padding_right() < kernel_width) {
+    throw std::runtime_error("ConvNode: The kernel is larger than the input");
+  }
 }
\ No newline at end of file
@@ -38,15 +38,15 @@ DropoutNode::DropoutNode(const nlohmann::json &node) {
   }
 }
 
-void DropoutNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto data_it = iomap.find(data);
-  if (data_it == iomap.end()) {
+void DropoutNode::forward(TensorTable &table,
+                          const std::vector<size_t> &inputs,
+                          const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
     throw std::runtime_error(
-        "ReshapeNode: Input tensor data not found in iomap");
+        "ReshapeNode: Input tensor data not found in table");
   }
 
-  const GeneralDataTypes &data_tensor = data_it->second;
+  const GeneralDataTypes &data_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &data_ptr) {
@@ -58,23 +58,22 @@ void DropoutNode::forward(
           throw std::runtime_error(
               "DropoutNode: Unsupported data type for tensor data");
         } else {
-          auto output_it = iomap.find(output);
-          if (output_it == iomap.end()) {
-            // Create a new output tensor by copying the input tensor
-            auto output_ptr = data_ptr->copy();
+          GeneralDataTypes &output_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
+            // Create an output tensor with the shape of the input tensor
+            auto output_ptr = std::make_shared<Tensor<ValueType>>(
+                data_ptr->get_shape(), uninitialized);
             // No need to fill with zeros as the dropout std::function will
             // overwrite the values
-            iomap[output] = output_ptr;
-            output_it = iomap.find(output);
+            output_tensor = output_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueType>>>(
-                         output_it->second)) {
+                         std::shared_ptr<Tensor<ValueType>>>(output_tensor)) {
             throw std::runtime_error(
                 "DropoutNode: Output tensor has incorrect type");
           }
 
           auto output_ptr =
-              std::get<std::shared_ptr<Tensor<ValueType>>>(output_it->second);
+              std::get<std::shared_ptr<Tensor<ValueType>>>(output_tensor);
 
           if (data_ptr->get_shape().size() < 1) {
             throw std::runtime_error("Tensor data must be at least 1D.");
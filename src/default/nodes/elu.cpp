@@ -22,14 +22,14 @@ ELUNode::ELUNode(const nlohmann::json &node) {
   }
 }
 
-void ELUNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("ELUNode: Input tensor X not found in iomap");
+void ELUNode::forward(TensorTable &table,
+                      const std::vector<size_t> &inputs,
+                      const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("ELUNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &x_ptr) {
@@ -40,27 +40,21 @@ void ELUNode::forward(
           throw std::runtime_error(
               "ELUNode: Unsupported data type for tensor X");
         } else {
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            auto y_ptr = std::make_shared<Tensor<ValueTypeX>>(
+                x_ptr->get_shape(), uninitialized);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor)) {
             throw std::runtime_error(
                 "ELUNode: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor);
 
-          TensorOperations<ValueTypeX>::elementwise(
-              x_ptr,
-              [this](ValueTypeX val) -> ValueTypeX {
-                return val < 0 ? alpha * (std::exp(val) - 1) : val;
-              },
-              y_ptr);
+          TensorOperations<ValueTypeX>::elementwise(x_ptr, EluOp{alpha}, y_ptr);
         }
       },
       x_tensor);
@@ -29,14 +29,14 @@ GeluNode::GeluNode(const nlohmann::json &node) {
   }
 }
 
-void GeluNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("GELUNode: Input tensor X not found in iomap");
+void GeluNode::forward(TensorTable &table,
+                       const std::vector<size_t> &inputs,
+                       const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("GELUNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &x_ptr) {
@@ -47,40 +47,25 @@ void GeluNode::forward(
           throw std::runtime_error(
               "GELUNode: Unsupported data type for tensor X");
         } else {
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            auto y_ptr = std::make_shared<Tensor<ValueTypeX>>(
+                x_ptr->get_shape(), uninitialized);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor)) {
             throw std::runtime_error(
                 "GELUNode: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor);
 
           if (approximate == "none") {
-            TensorOperations<ValueTypeX>::elementwise(
-                x_ptr,
-                [](ValueTypeX val) -> ValueTypeX {
-                  return static_cast<ValueTypeX>(
-                      0.5f * val * (1.0f + std::erf(val / std::sqrt(2.0f))));
-                },
-                y_ptr);
+            TensorOperations<ValueTypeX>::elementwise(x_ptr, GeluOp{}, y_ptr);
           } else {
-            TensorOperations<ValueTypeX>::elementwise(
-                x_ptr,
-                [](ValueTypeX val) -> ValueTypeX {
-                  return static_cast<ValueTypeX>(
-                      0.5f * val *
-                      (1.0f +
-                       std::tanh(std::sqrt(2.0f / M_PI) *
-                                 (val + 0.044715f * std::pow(val, 3.0f)))));
-                },
-                y_ptr);
+            TensorOperations<ValueTypeX>::elementwise(x_ptr, GeluTanhOp{},
+                                                      y_ptr);
           }
         }
       },
@@ -44,20 +44,19 @@ GemmNode::GemmNode(const nlohmann::json &node) {
   }
 }
 
-void GemmNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto a_it = iomap.find(A);
-  if (a_it == iomap.end()) {
-    throw std::runtime_error("GemmNode: Input tensor A not found in iomap");
+void GemmNode::forward(TensorTable &table,
+                       const std::vector<size_t> &inputs,
+                       const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("GemmNode: Input tensor A not found in table");
   }
 
-  auto b_it = iomap.find(B);
-  if (b_it == iomap.end()) {
-    throw std::runtime_error("GemmNode: Output tensor Y not found in iomap");
+  if (!table.contains(inputs.at(1))) {
+    throw std::runtime_error("GemmNode: Output tensor Y not found in table");
   }
 
-  const GeneralDataTypes &a_tensor = a_it->second;
-  const GeneralDataTypes &b_tensor = b_it->second;
+  const GeneralDataTypes &a_tensor = table[inputs.at(0)];
+  const GeneralDataTypes &b_tensor = table[inputs.at(1)];
 
   std::visit(
       [&](const auto &a_ptr, const auto &b_ptr) {
@@ -66,70 +65,118 @@ void GemmNode::forward(
         using ValueTypeB =
             std::decay_t<decltype(b_ptr)>::element_type::value_type;
 
-        if constexpr (!is_in_variant_v<ValueTypeA, T> ||
-                      !std::is_same_v<ValueTypeA, ValueTypeB>) {
-          throw std::runtime_error(
-              "GemmNode: Unsupported data type for tensor A");
-        } else {
+        if constexpr (std::is_same_v<ValueTypeA, float> &&
+                      is_half_v<ValueTypeB>) {
           if (!a_ptr->is_matrix() || !b_ptr->is_matrix()) {
             throw std::runtime_error(
                 "GemmNode: Input tensors must be 2D matrices");
           }
 
-          auto new_a_ptr = a_ptr->copy();
-          auto new_b_ptr = b_ptr->copy();
+          // 16-bit weights are read in place by the kernel, transposed or
+          // not, so they are never copied or widened in memory
+          std::shared_ptr<Tensor<float>> new_a_ptr = a_ptr;
           if (transA == 1) {
             new_a_ptr = a_ptr->transpose();
           }
-          if (transB == 1) {
-            new_b_ptr = b_ptr->transpose();
+
+          size_t M = new_a_ptr->get_shape()[0];
+          size_t K_a = new_a_ptr->get_shape()[1];
+          const Shape &b_shape = b_ptr->get_shape();
+          size_t K_b = transB == 1 ? b_shape[1] : b_shape[0];
+          size_t N = transB == 1 ? b_shape[0] : b_shape[1];
+
+          if (K_a != K_b) {
+            throw std::runtime_error(
+                "GemmNode: Inner dimensions of A and B must match");
+          }
+
+          auto new_c_ptr = prepareOutput<float>(table, inputs, outputs, M, N);
+          TensorOperations<float>::gemm_half<ValueTypeB>(
+              transB == 1 ? 1 : 0, M, N, K_a, alpha, outputBeta(), new_a_ptr,
+              K_a, b_ptr, b_shape[1], new_c_ptr, N);
+
+          table[outputs.at(0)] = new_c_ptr;
+        } else if constexpr (!is_in_variant_v<ValueTypeA, T> ||
+                             !std::is_same_v<ValueTypeA, ValueTypeB>) {
+          throw std::runtime_error(
+              "GemmNode: Unsupported data type for tensor A");
+        } else {
+          if (!a_ptr->is_matrix() || !b_ptr->is_matrix()) {
+            throw std::runtime_error(
+                "GemmNode: Input tensors must be 2D matrices");
           }
 
-          array_mml<size_t> a_shape = new_a_ptr->get_shape();
-          array_mml<size_t> b_shape = new_b_ptr->get_shape();
+          // The inputs are only read, and the kernels read transposed ones
+          // in place, so neither is copied
+          const Shape &a_shape = a_ptr->get_shape();
+          const Shape &b_shape = b_ptr->get_shape();
 
-          size_t M = a_shape[0];
-          size_t K_a = a_shape[1];
-          size_t K_b = b_shape[0];
-          size_t N = b_shape[1];
+          size_t M = transA == 1 ? a_shape[1] : a_shape[0];
+          size_t K_a = transA == 1 ? a_shape[0] : a_shape[1];
+          size_t K_b = transB == 1 ? b_shape[1] : b_shape[0];
+          size_t N = transB == 1 ? b_shape[0] : b_shape[1];
 
           if (K_a != K_b) {
             throw std::runtime_error(
                 "GemmNode: Inner dimensions of A and B must match");
           }
 
-          std::shared_ptr<Tensor<ValueTypeA>> new_c_ptr;
-          if (C.has_value()) {
-            auto c_it = iomap.find(C.value());
-            if (c_it == iomap.end()) {
-              throw std::runtime_error(
-                  "GemmNode: Output tensor C not found in iomap");
-            }
-            auto raw_c_ptr =
-                std::get<std::shared_ptr<Tensor<ValueTypeA>>>(c_it->second)
-                    ->copy();
-            new_c_ptr = raw_c_ptr->broadcast_reshape({M, N});
-          } else {
-            new_c_ptr =
-                std::make_shared<Tensor<ValueTypeA>>(array_mml<size_t>{M, N});
-            new_c_ptr->fill(static_cast<ValueTypeA>(0));
-          }
+          auto new_c_ptr = prepareOutput<ValueTypeA>(table, inputs, outputs,
+                                                     M, N);
 
-          size_t lda = K_a;
-          size_t ldb = N;
+          // The strides are those of A and B as they are stored
+          size_t lda = a_shape[1];
+          size_t ldb = b_shape[1];
           size_t ldc = N;
 
           TensorOperations<ValueTypeA>::gemm(
-              0, 0, M, N, K_a, static_cast<ValueTypeA>(alpha),
-              static_cast<ValueTypeA>(beta), new_a_ptr, lda, new_b_ptr, ldb,
-              new_c_ptr, ldc);
+              transA == 1 ? 1 : 0, transB == 1 ? 1 : 0, M, N, K_a,
+              static_cast<ValueTypeA>(alpha),
+              static_cast<ValueTypeA>(outputBeta()),
+              a_ptr, lda, b_ptr, ldb, new_c_ptr, ldc);
 
-          iomap[Y] = new_c_ptr;
+          table[outputs.at(0)] = new_c_ptr;
         }
       },
       a_tensor, b_tensor);
 }
 
+template <typename ValueType>
+std::shared_ptr<Tensor<ValueType>> GemmNode::prepareOutput(
+    TensorTable &table, const std::vector<size_t> &inputs,
+    const std::vector<size_t> &outputs, size_t M, size_t N) {
+  // C is broadcast into the output through a zero stride view, so neither a
+  // repeated copy of C nor a new output is allocated. Without C the output is
+  // left uninitialised, GEMM overwrites it with a beta of 0.
+  auto new_c_ptr = outputTensor<ValueType>(table, outputs.at(0), Shape{M, N});
+  if (C.has_value()) {
+    if (!table.contains(inputs.at(2))) {
+      throw std::runtime_error("GemmNode: Output tensor C not found in table");
+    }
+    std::visit(
+        [&](const auto &raw_c_ptr) {
+          using ValueTypeC = typename std::decay_t<
+              decltype(raw_c_ptr)>::element_type::value_type;
+          // A 16-bit C of a float output is widened as it is copied
+          if constexpr (std::is_same_v<ValueTypeC, ValueType> ||
+                        (std::is_same_v<ValueType, float> &&
+                         is_half_v<ValueTypeC>)) {
+            std::as_const(*raw_c_ptr)
+                .view()
+                .broadcast(Shape{M, N})
+                .copy_to(*new_c_ptr);
+          } else {
+            throw std::runtime_error(
+                "GemmNode: Tensor C has a different type than Y");
+          }
+        },
+        table[inputs.at(2)]);
+  }
+  return new_c_ptr;
+}
+
+float GemmNode::outputBeta() const { return C.has_value() ? beta : 0.0f; }
+
 std::vector<std::string> GemmNode::getInputs() {
   if (C.has_value()) {
     return {A, B, C.value()};
@@ -23,15 +23,15 @@ LeakyReLUNode::LeakyReLUNode(const nlohmann::json &node) {
   }
 }
 
-void LeakyReLUNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
+void LeakyReLUNode::forward(TensorTable &table,
+                            const std::vector<size_t> &inputs,
+                            const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
     throw std::runtime_error(
-        "LeakyReLUNode: Input tensor X not found in iomap");
+        "LeakyReLUNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &x_ptr) {
@@ -42,27 +42,22 @@ void LeakyReLUNode::forward(
           throw std::runtime_error(
               "LeakyReLUNode: Unsupported data type for tensor X");
         } else {
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            auto y_ptr = std::make_shared<Tensor<ValueTypeX>>(
+                x_ptr->get_shape(), uninitialized);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor)) {
             throw std::runtime_error(
                 "LeakyReLUNode: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor);
 
-          TensorOperations<ValueTypeX>::elementwise(
-              x_ptr,
-              [this](ValueTypeX val) -> ValueTypeX {
-                return val < 0 ? alpha * val : val;
-              },
-              y_ptr);
+          TensorOperations<ValueTypeX>::elementwise(x_ptr, LeakyReluOp{alpha},
+                                                    y_ptr);
         }
       },
       x_tensor);
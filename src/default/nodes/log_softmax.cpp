@@ -1,5 +1,8 @@
 #include "nodes/log_softmax.hpp"
 
+#include "utility/parallel.hpp"
+#include "utility/simd_math.hpp"
+
 LogSoftMaxNode::LogSoftMaxNode(const std::string &X, const std::string &Y,
                                size_t axis)
     : X(X), Y(Y), axis(axis) {}
@@ -23,15 +26,15 @@ LogSoftMaxNode::LogSoftMaxNode(const nlohmann::json &node) {
   }
 }
 
-void LogSoftMaxNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
+void LogSoftMaxNode::forward(TensorTable &table,
+                             const std::vector<size_t> &inputs,
+                             const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
     throw std::runtime_error(
-        "LogSoftMaxNode: Input tensor X not found in iomap");
+        "LogSoftMaxNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &x_ptr) {
@@ -42,57 +45,80 @@ void LogSoftMaxNode::forward(
           throw std::runtime_error(
               "LogSoftMaxNode: Unsupported data type for tensor X");
         } else {
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            auto y_ptr = std::make_shared<Tensor<ValueTypeX>>(
+                x_ptr->get_shape(), uninitialized);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor)) {
             throw std::runtime_error(
                 "LogSoftMaxNode: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor);
 
           // If axis is negative
           if (((int)axis) < 0) axis += x_ptr->get_shape().size();
 
           if (axis >= x_ptr->get_shape().size())
             throw std::runtime_error("Invalid axis: " + std::to_string(axis));
+          if (!x_ptr->is_matrix() || axis != 1) {
+            throw std::runtime_error(
+                "LogSoftMaxNode: Only the last axis of a 2D tensor is "
+                "supported");
+          }
 
           // Currently this only supports input tensors that are 2D, this is the
           // most common shape. Currently there is no general solution until we
           // can slice the tensor and retreive axi from the tensor
 
-          auto input_copy = x_ptr->copy();
-
-          // For each batch, in the input
-          for (size_t b = 0; b < input_copy->get_shape()[0]; b++) {
-            // Find the maximum value in the row for numerical stability
-            ValueTypeX max_val = -std::numeric_limits<ValueTypeX>::infinity();
-            for (size_t c = 0; c < input_copy->get_shape()[axis]; c++) {
-              max_val = std::max(max_val, (*input_copy)[{b, c}]);
-            }
-
-            // Exponentiate and std::accumulate the sum
-            ValueTypeX sum = 0;
-            std::vector<ValueTypeX> exp_values(input_copy->get_shape()[axis]);
-            for (size_t c = 0; c < input_copy->get_shape()[axis]; c++) {
-              ValueTypeX value = (*input_copy)[{b, c}] - max_val;
-              exp_values[c] = std::exp(value);
-              sum += exp_values[c];
-            }
-
-            for (size_t c = 0; c < input_copy->get_shape()[axis]; c++) {
-              // Apply soft max and perform std::log on the result
-              (*input_copy)[{b, c}] = std::log(exp_values[c] / sum);
-            }
+          if (!(y_ptr->get_shape() == x_ptr->get_shape())) {
+            *y_ptr = Tensor<ValueTypeX>(x_ptr->get_shape(), uninitialized);
           }
 
-          *y_ptr = *input_copy;
+          const size_t rows = x_ptr->get_shape()[0];
+          const size_t cols = x_ptr->get_shape()[axis];
+          auto in = std::as_const(*x_ptr).get_span();
+          auto out = y_ptr->get_span();
+
+          // Rough number of operations per element of a row
+          constexpr size_t LOG_SOFTMAX_COST = 8;
+          Parallel::parallel_for(
+              0, rows, Parallel::grain_for(cols * LOG_SOFTMAX_COST),
+              [&](size_t begin, size_t end) {
+                std::vector<ValueTypeX> shifted(cols);
+                std::vector<ValueTypeX> exp_values(cols);
+                for (size_t b = begin; b < end; b++) {
+                  // Subtract the maximum value of the row for numerical
+                  // stability
+                  ValueTypeX max_val =
+                      -std::numeric_limits<ValueTypeX>::infinity();
+                  for (size_t c = 0; c < cols; c++) {
+                    max_val = std::max(max_val, in(b, c));
+                  }
+                  for (size_t c = 0; c < cols; c++) {
+                    shifted[c] = in(b, c) - max_val;
+                  }
+
+                  if constexpr (std::is_same_v<ValueTypeX, float>) {
+                    SimdMath::exp(shifted.data(), exp_values.data(), cols);
+                  } else {
+                    for (size_t c = 0; c < cols; c++) {
+                      exp_values[c] = std::exp(shifted[c]);
+                    }
+                  }
+                  ValueTypeX sum = std::accumulate(
+                      exp_values.begin(), exp_values.end(), ValueTypeX(0));
+
+                  // log(e^x / sum) = x - log(sum), one std::log per row
+                  ValueTypeX log_sum = std::log(sum);
+                  for (size_t c = 0; c < cols; c++) {
+                    out(b, c) = shifted[c] - log_sum;
+                  }
+                }
+              });
         }
       },
       x_tensor);
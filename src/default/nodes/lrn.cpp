@@ -40,14 +40,14 @@ LRNNode_mml::LRNNode_mml(const nlohmann::json &node) {
   }
 }
 
-void LRNNode_mml::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("LRNNode_mml: Input tensor X not found in iomap");
+void LRNNode_mml::forward(TensorTable &table,
+                          const std::vector<size_t> &inputs,
+                          const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("LRNNode_mml: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &x_ptr) {
@@ -58,47 +58,61 @@ void LRNNode_mml::forward(
           throw std::runtime_error(
               "LRNNode_mml: Unsupported data type for tensor X");
         } else {
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            auto y_ptr = std::make_shared<Tensor<ValueTypeX>>(
+                x_ptr->get_shape(), uninitialized);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor)) {
             throw std::runtime_error(
                 "LRNNode_mml: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueTypeX>>>(y_tensor);
 
-          array_mml<size_t> shape = x_ptr->get_shape();
+          const Shape &shape = x_ptr->get_shape();
+          if (shape.size() != 4) {
+            throw std::runtime_error(
+                "LRNNode_mml: Input tensor X must have 4 dimensions");
+          }
+          if (y_ptr->get_shape() != shape) {
+            throw std::runtime_error(
+                "LRNNode_mml: Output tensor Y has incorrect shape");
+          }
+
+          auto x = x_ptr->get_span();
+          auto y = y_ptr->get_span();
+          size_t plane_size = shape[2] * shape[3];
+          std::vector<ValueTypeX> square_sum(plane_size);
 
           /// Each batch element
           for (size_t n = 0; n < shape[0]; n++) {
             /// Each channel
             for (size_t c = 0; c < shape[1]; c++) {
-              /// Each row
-              for (size_t h = 0; h < shape[2]; h++) {
-                /// Each column
-                for (size_t w = 0; w < shape[3]; w++) {
-                  /// Region
-                  size_t start = std::max(0UL, c - (size - 1) / 2);
-                  size_t end = std::min(shape[1] - 1,
-                                        c + (size - 1) / 2 + ((size - 1) % 2));
-
-                  /// Calculate square_sum
-                  ValueTypeX square_sum = 0;
-                  for (size_t i = start; i <= end; i++) {
-                    square_sum +=
-                        (*x_ptr)[{n, i, h, w}] * (*x_ptr)[{n, i, h, w}];
-                  }
-                  (*y_ptr)[{n, c, h, w}] =
-                      (*x_ptr)[{n, c, h, w}] /
-                      std::pow((bias + alpha / size * square_sum), beta);
+              /// Region
+              size_t start = std::max(0UL, c - (size - 1) / 2);
+              size_t end = std::min(shape[1] - 1,
+                                    c + (size - 1) / 2 + ((size - 1) % 2));
+
+              /// Calculate square_sum over the region for every position of
+              /// the plane at once
+              std::fill(square_sum.begin(), square_sum.end(), 0);
+              for (size_t i = start; i <= end; i++) {
+                const ValueTypeX *x_region = &x(n, i);
+                for (size_t p = 0; p < plane_size; p++) {
+                  square_sum[p] += x_region[p] * x_region[p];
                 }
               }
+
+              const ValueTypeX *x_plane = &x(n, c);
+              ValueTypeX *y_plane = &y(n, c);
+              for (size_t p = 0; p < plane_size; p++) {
+                y_plane[p] =
+                    x_plane[p] /
+                    std::pow((bias + alpha / size * square_sum[p]), beta);
+              }
             }
           }
         }
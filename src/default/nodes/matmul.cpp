@@ -14,20 +14,19 @@ MatMulNode::MatMulNode(const nlohmann::json &node) {
   }
 }
 
-void MatMulNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto a_it = iomap.find(A);
-  if (a_it == iomap.end()) {
-    throw std::runtime_error("MatMul: Input tensor A not found in iomap");
+void MatMulNode::forward(TensorTable &table,
+                         const std::vector<size_t> &inputs,
+                         const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("MatMul: Input tensor A not found in table");
   }
 
-  auto b_it = iomap.find(B);
-  if (b_it == iomap.end()) {
-    throw std::runtime_error("MatMul: Input tensor B not found in iomap");
+  if (!table.contains(inputs.at(1))) {
+    throw std::runtime_error("MatMul: Input tensor B not found in table");
   }
 
-  const GeneralDataTypes &a_tensor = a_it->second;
-  const GeneralDataTypes &b_tensor = b_it->second;
+  const GeneralDataTypes &a_tensor = table[inputs.at(0)];
+  const GeneralDataTypes &b_tensor = table[inputs.at(1)];
 
   std::visit(
       [&](const auto &a_ptr, const auto &b_ptr) {
@@ -46,11 +45,12 @@ void MatMulNode::forward(
                 "MatMul: Input tensors must be 2D matrices");
           }
 
-          auto new_a_ptr = a_ptr->copy();
-          auto new_b_ptr = b_ptr->copy();
+          // The inputs are only read, so they are used without copying
+          std::shared_ptr<Tensor<ValueTypeA>> new_a_ptr = a_ptr;
+          std::shared_ptr<Tensor<ValueTypeA>> new_b_ptr = b_ptr;
 
-          array_mml<size_t> a_shape = new_a_ptr->get_shape();
-          array_mml<size_t> b_shape = new_b_ptr->get_shape();
+          Shape a_shape = new_a_ptr->get_shape();
+          Shape b_shape = new_b_ptr->get_shape();
 
           size_t M = a_shape[0];
           size_t K_a = a_shape[1];
@@ -66,18 +66,15 @@ void MatMulNode::forward(
           size_t ldb = N;
           size_t ldc = N;
 
-          std::shared_ptr<Tensor<ValueTypeA>> new_c_ptr;
-          auto c_it = iomap.find(Y);
-          auto raw_c_ptr =
-              std::get<std::shared_ptr<Tensor<ValueTypeA>>>(c_it->second)
-                  ->copy();
-          new_c_ptr = raw_c_ptr->broadcast_reshape({M, N});
+          // With beta 0 the previous content of the output is not read
+          auto new_c_ptr =
+              outputTensor<ValueTypeA>(table, outputs.at(0), Shape{M, N});
 
           TensorOperations<ValueTypeA>::gemm(0, 0, M, N, K_a, 1.0, 0.0,
                                              new_a_ptr, lda, new_b_ptr, ldb,
                                              new_c_ptr, ldc);
 
-          iomap[Y] = new_c_ptr;
+          table[outputs.at(0)] = new_c_ptr;
         }
       },
       a_tensor, b_tensor);
@@ -76,14 +76,14 @@ MaxPoolNode::MaxPoolNode(const nlohmann::json& node) {
   }
 }
 
-void MaxPoolNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes>& iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("MaxPoolNode: Input tensor X not found in iomap");
+void MaxPoolNode::forward(TensorTable &table,
+                          const std::vector<size_t> &inputs,
+                          const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("MaxPoolNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes& x_tensor = x_it->second;
+  const GeneralDataTypes& x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto& x_ptr) {
@@ -94,7 +94,7 @@ void MaxPoolNode::forward(
           throw std::runtime_error(
               "MaxPoolNode: Unsupported data type for tensor X");
         } else {
-          array_mml<size_t> x_shape = x_ptr->get_shape();
+          Shape x_shape = x_ptr->get_shape();
           size_t total_rank = x_shape.size();
 
           if (total_rank < 3) {
@@ -105,7 +105,7 @@ void MaxPoolNode::forward(
           NodeUtils::compute_pool_attributes(auto_pad, kernel_shape, strides,
                                              pads, dilations);
 
-          array_mml<size_t> output_shape = NodeUtils::compute_pool_output_shape(
+          Shape output_shape = NodeUtils::compute_pool_output_shape(
               x_shape, auto_pad, ceil_mode, dilations, kernel_shape, pads,
               strides);
 
@@ -113,20 +113,24 @@ void MaxPoolNode::forward(
               x_shape, auto_pad, ceil_mode, dilations, kernel_shape, pads,
               strides);
 
-          auto y_ptr = std::make_shared<Tensor<ValueType>>(output_shape);
+          // Every output position gets its own window, so the outputs are
+          // fully written
+          auto y_ptr =
+              std::make_shared<Tensor<ValueType>>(output_shape, uninitialized);
 
           std::optional<std::shared_ptr<Tensor<int64_t>>> indices_ptr =
               std::nullopt;
           if (indices.has_value()) {
-            indices_ptr = std::make_shared<Tensor<int64_t>>(output_shape);
+            indices_ptr =
+                std::make_shared<Tensor<int64_t>>(output_shape, uninitialized);
           }
 
           // Perform pooling operation
           TensorOperations<ValueType>::sliding_window(
               x_shape, output_shape, kernel_shape, strides, dilations, pad_pair,
               [this, x_ptr, y_ptr, indices_ptr, x_shape, total_rank](
-                  const std::vector<std::vector<size_t>>& window_in_idx,
-                  const std::vector<size_t>& out_idx) -> void {
+                  const std::vector<Shape>& window_in_idx,
+                  const Shape& out_idx) -> void {
                 if (window_in_idx.empty()) {
                   throw std::runtime_error("MaxPoolNode: Empty window values");
                 }
@@ -135,8 +139,7 @@ void MaxPoolNode::forward(
                 int64_t max_idx = -1;
 
                 for (const auto& in_idx : window_in_idx) {
-                  array_mml<size_t> curr_idx(in_idx);
-                  ValueType curr_val = (*x_ptr)[curr_idx];
+                  ValueType curr_val = (*x_ptr)[in_idx];
 
                   if (curr_val > max_val) {
                     max_val = curr_val;
@@ -162,16 +165,15 @@ void MaxPoolNode::forward(
                   }
                 }
 
-                array_mml<size_t> out_idx_array(out_idx);
-                (*y_ptr)[out_idx_array] = max_val;
+                (*y_ptr)[out_idx] = max_val;
                 if (indices_ptr.has_value()) {
-                  (*indices_ptr.value())[out_idx_array] = max_idx;
+                  (*indices_ptr.value())[out_idx] = max_idx;
                 }
               });
 
-          iomap[Y] = y_ptr;
+          table[outputs.at(0)] = y_ptr;
           if (indices.has_value()) {
-            iomap[indices.value()] = indices_ptr.value();
+            table[outputs.at(1)] = indices_ptr.value();
           }
         }
       },
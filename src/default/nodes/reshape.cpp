@@ -27,22 +27,21 @@ reshapeNode::reshapeNode(const nlohmann::json &node) {
   }
 }
 
-void reshapeNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto data_it = iomap.find(data);
-  if (data_it == iomap.end()) {
+void reshapeNode::forward(TensorTable &table,
+                          const std::vector<size_t> &inputs,
+                          const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
     throw std::runtime_error(
-        "ReshapeNode: Input tensor data not found in iomap");
+        "ReshapeNode: Input tensor data not found in table");
   }
 
-  auto shape_it = iomap.find(shape);
-  if (shape_it == iomap.end()) {
+  if (!table.contains(inputs.at(1))) {
     throw std::runtime_error(
-        "ReshapeNode: Input tensor shape not found in iomap");
+        "ReshapeNode: Input tensor shape not found in table");
   }
 
-  const GeneralDataTypes &data_tensor = data_it->second;
-  const GeneralDataTypes &shape_tensor = shape_it->second;
+  const GeneralDataTypes &data_tensor = table[inputs.at(0)];
+  const GeneralDataTypes &shape_tensor = table[inputs.at(1)];
 
   std::visit(
       [&](const auto &data_ptr, const auto &shape_ptr) {
@@ -56,23 +55,21 @@ void reshapeNode::forward(
           throw std::runtime_error(
               "ReshapeNode: Unsupported data type for tensor data");
         } else {
-          auto reshaped_it = iomap.find(reshaped);
-          if (reshaped_it == iomap.end()) {
+          GeneralDataTypes &reshaped_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create a new output tensor by copying the input tensor
             auto new_reshaped_ptr = data_ptr->copy();
             // No need to fill with zeros as the reshape std::function will
             // overwrite the values
-            iomap[reshaped] = new_reshaped_ptr;
-            reshaped_it = iomap.find(reshaped);
+            reshaped_tensor = new_reshaped_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueType>>>(
-                         reshaped_it->second)) {
+                         std::shared_ptr<Tensor<ValueType>>>(reshaped_tensor)) {
             throw std::runtime_error(
                 "ReshapeNode: Output tensor has incorrect type");
           }
 
           auto reshaped_ptr =
-              std::get<std::shared_ptr<Tensor<ValueType>>>(reshaped_it->second);
+              std::get<std::shared_ptr<Tensor<ValueType>>>(reshaped_tensor);
 
           // Determine the size of the shape tensor (number of dimensions for
           // the new shape)
@@ -83,7 +80,7 @@ void reshapeNode::forward(
 
           // Create an array to store the new shape values (initialized with
           // same size as shape tensor)
-          array_mml<size_t> new_shape(shape_size);
+          Shape new_shape(shape_size);
 
           // Variables for handling inferred dimension (-1) and computing the
           // total number of elements
@@ -12,14 +12,14 @@ TanHNode::TanHNode(const nlohmann::json &node) {
   }
 }
 
-void TanHNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto x_it = iomap.find(X);
-  if (x_it == iomap.end()) {
-    throw std::runtime_error("TanHNode: Input tensor X not found in iomap");
+void TanHNode::forward(TensorTable &table,
+                       const std::vector<size_t> &inputs,
+                       const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("TanHNode: Input tensor X not found in table");
   }
 
-  const GeneralDataTypes &x_tensor = x_it->second;
+  const GeneralDataTypes &x_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &x_ptr) {
@@ -31,26 +31,23 @@ void TanHNode::forward(
           throw std::runtime_error(
               "TanHNode: Unsupported data type for tensor X");
         } else {
-          auto y_it = iomap.find(Y);
-          if (y_it == iomap.end()) {
+          GeneralDataTypes &y_tensor = table[outputs.at(0)];
+          if (!table.contains(outputs.at(0))) {
             // Create output tensor if it doesn't exist
-            auto y_ptr = x_ptr->copy();
-            // No need to fill with zeros as the elementwise std::function will
+            auto y_ptr = std::make_shared<Tensor<ValueType>>(
+                x_ptr->get_shape(), uninitialized);
+            // No need to fill with zeros as the elementwise functor will
             // overwrite the values
-            iomap[Y] = y_ptr;
-            y_it = iomap.find(Y);
+            y_tensor = y_ptr;
           } else if (!std::holds_alternative<
-                         std::shared_ptr<Tensor<ValueType>>>(y_it->second)) {
+                         std::shared_ptr<Tensor<ValueType>>>(y_tensor)) {
             throw std::runtime_error(
                 "TanHNode: Output tensor Y has incorrect type");
           }
 
-          auto y_ptr =
-              std::get<std::shared_ptr<Tensor<ValueType>>>(y_it->second);
+          auto y_ptr = std::get<std::shared_ptr<Tensor<ValueType>>>(y_tensor);
 
-          TensorOperations<ValueType>::elementwise(
-              x_ptr, [](ValueType x) -> ValueType { return std::tanh(x); },
-              y_ptr);
+          TensorOperations<ValueType>::elementwise(x_ptr, TanhOp{}, y_ptr);
         }
       },
       x_tensor);
@@ -26,14 +26,14 @@ TransposeNode::TransposeNode(const nlohmann::json &node) {
   }
 }
 
-void TransposeNode::forward(
-    std::unordered_map<std::string, GeneralDataTypes> &iomap) {
-  auto a_it = iomap.find(A);
-  if (a_it == iomap.end()) {
-    throw std::runtime_error("Transpose: Input tensor A not found in iomap");
+void TransposeNode::forward(TensorTable &table,
+                            const std::vector<size_t> &inputs,
+                            const std::vector<size_t> &outputs) {
+  if (!table.contains(inputs.at(0))) {
+    throw std::runtime_error("Transpose: Input tensor A not found in table");
   }
 
-  const GeneralDataTypes &a_tensor = a_it->second;
+  const GeneralDataTypes &a_tensor = table[inputs.at(0)];
 
   std::visit(
       [&](const auto &a_ptr) {
@@ -43,17 +43,15 @@ void TransposeNode::forward(
         if constexpr (!is_in_variant_v<ValueTypeA, T>) {
           throw std::runtime_error(
               "Transpose: Unsupported data type for tensor A");
+        } else {
+          // Permute the strides of a view and copy it once into the output
+          auto transposed_view =
+              std::as_const(*a_ptr).view().transpose(perm);
+          auto transposed_tensor = outputTensor<ValueTypeA>(
+              table, outputs.at(0), transposed_view.get_shape());
+          transposed_view.copy_to(*transposed_tensor);
+          table[outputs.at(0)] = transposed_tensor;
         }
-
-        auto new_a_ptr = a_ptr->copy();
-
-        std::shared_ptr<Tensor<ValueTypeA>> new_c_ptr;
-        auto c_it = iomap.find(Y);
-        auto raw_c_ptr =
-            std::get<std::shared_ptr<Tensor<ValueTypeA>>>(c_it->second)->copy();
-
-        auto transposed_tensor = a_ptr->transpose(perm);
-        iomap[Y] = transposed_tensor;
       },
       a_tensor);
 }
@@ -0,0 +1,275 @@
+#include "utility/allocator.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Blocks up to this size are kept in the cache of the thread that freed them
+constexpr size_t THREAD_CACHE_MAX_BYTES = size_t(1) << 18;
+// The number of blocks per class a thread keeps before sharing them
+constexpr size_t THREAD_CACHE_BLOCKS = 16;
+
+void *system_allocate(size_t bytes, size_t alignment) {
+  void *ptr = nullptr;
+  if (posix_memalign(&ptr, std::max(alignment, sizeof(void *)), bytes) != 0) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+std::shared_ptr<Allocator> &default_allocator() {
+  static std::shared_ptr<Allocator> allocator =
+      std::make_shared<PoolAllocator>();
+  return allocator;
+}
+
+std::mutex default_allocator_mutex;
+
+// Bumped by set_default, so that every thread refreshes its cached default
+std::atomic<size_t> default_generation = 1;
+
+// The default allocator as a thread last saw it
+struct DefaultCache {
+  size_t generation = 0;
+  std::shared_ptr<Allocator> allocator;
+
+  ~DefaultCache();
+};
+
+// Set once the cached default of the thread is destroyed
+thread_local bool default_cache_destroyed = false;
+
+DefaultCache::~DefaultCache() { default_cache_destroyed = true; }
+
+// Set once the cache of the thread is destroyed, blocks freed after that by
+// the destructors of other thread locals go straight to the shared lists
+thread_local bool thread_cache_destroyed = false;
+
+}  // namespace
+
+void Allocator::set_default(std::shared_ptr<Allocator> allocator) {
+  std::lock_guard<std::mutex> lock(default_allocator_mutex);
+  default_allocator() = std::move(allocator);
+  default_generation.fetch_add(1, std::memory_order_release);
+}
+
+const std::shared_ptr<Allocator> &Allocator::get_default() {
+  if (default_cache_destroyed) {
+    // Only destructors of other thread locals get here, as the thread exits,
+    // their buffers are given to the system allocator which is never freed
+    static const auto *late_allocator = new std::shared_ptr<Allocator>(
+        std::make_shared<SystemAllocator>());
+    return *late_allocator;
+  }
+
+  thread_local DefaultCache cache;
+  if (cache.generation !=
+      default_generation.load(std::memory_order_acquire)) {
+    std::lock_guard<std::mutex> lock(default_allocator_mutex);
+    cache.allocator = default_allocator();
+    cache.generation = default_generation.load(std::memory_order_relaxed);
+  }
+  return cache.allocator;
+}
+
+void *SystemAllocator::allocate(size_t bytes, size_t alignment) {
+  void *ptr = system_allocate(bytes, alignment);
+  misses.fetch_add(1, std::memory_order_relaxed);
+  bytes_in_use.fetch_add(bytes, std::memory_order_relaxed);
+  return ptr;
+}
+
+void SystemAllocator::deallocate(void *ptr, size_t bytes) {
+  bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+  free(ptr);
+}
+
+AllocatorStats SystemAllocator::get_stats() const {
+  AllocatorStats stats;
+  stats.misses = misses.load(std::memory_order_relaxed);
+  stats.bytes_in_use = bytes_in_use.load(std::memory_order_relaxed);
+  return stats;
+}
+
+/**
+ * @brief The blocks a thread keeps for one PoolAllocator, the thread switches
+ * its cache over when it uses another pool.
+ */
+struct PoolThreadCache {
+  PoolAllocator *pool = nullptr;
+  std::weak_ptr<PoolAllocator> owner;
+  std::vector<std::vector<void *>> blocks;
+
+  ~PoolThreadCache() {
+    flush();
+    thread_cache_destroyed = true;
+  }
+
+  // Hands the blocks to the shared lists, or frees them if the pool is gone
+  void flush() {
+    std::shared_ptr<PoolAllocator> alive = owner.lock();
+    for (size_t index = 0; index < blocks.size(); index++) {
+      for (void *ptr : blocks[index]) {
+        if (alive) {
+          alive->release(index, ptr);
+        } else {
+          free(ptr);
+        }
+      }
+      blocks[index].clear();
+    }
+  }
+
+  // Switches the cache over to a pool
+  void bind(PoolAllocator *pool) {
+    if (this->pool == pool) return;
+    flush();
+    this->pool = pool;
+    owner = pool->weak_from_this();
+  }
+};
+
+namespace {
+
+PoolThreadCache *thread_cache() {
+  if (thread_cache_destroyed) return nullptr;
+  thread_local PoolThreadCache cache;
+  return &cache;
+}
+
+}  // namespace
+
+PoolAllocator::PoolAllocator() : classes(class_index(MAX_BLOCK_BYTES) + 1) {}
+
+PoolAllocator::~PoolAllocator() {
+  // Blocks in the caches of other threads are freed when those threads exit
+  PoolThreadCache *cache = thread_cache();
+  if (cache != nullptr && cache->pool == this) {
+    cache->owner.reset();
+    cache->flush();
+    cache->pool = nullptr;
+  }
+  trim();
+}
+
+void *PoolAllocator::allocate(size_t bytes, size_t alignment) {
+  if (bytes > MAX_BLOCK_BYTES) {
+    misses.fetch_add(1, std::memory_order_relaxed);
+    bytes_in_use.fetch_add(bytes, std::memory_order_relaxed);
+    return system_allocate(bytes, alignment);
+  }
+
+  size_t index = class_index(bytes);
+  size_t block_bytes = class_bytes(index);
+  bytes_in_use.fetch_add(block_bytes, std::memory_order_relaxed);
+
+  // Pooled blocks are aligned to BLOCK_ALIGNMENT, a block that needs more
+  // comes from the system but still gets the size of its class to be reused
+  void *ptr = nullptr;
+  if (alignment <= BLOCK_ALIGNMENT) {
+    PoolThreadCache *cache = thread_cache();
+    if (cache != nullptr && cache->pool == this &&
+        !cache->blocks[index].empty()) {
+      ptr = cache->blocks[index].back();
+      cache->blocks[index].pop_back();
+    } else {
+      SizeClass &size_class = classes[index];
+      std::lock_guard<std::mutex> lock(size_class.mutex);
+      if (!size_class.blocks.empty()) {
+        ptr = size_class.blocks.back();
+        size_class.blocks.pop_back();
+      }
+    }
+  }
+
+  if (ptr != nullptr) {
+    hits.fetch_add(1, std::memory_order_relaxed);
+    bytes_cached.fetch_sub(block_bytes, std::memory_order_relaxed);
+    return ptr;
+  }
+
+  misses.fetch_add(1, std::memory_order_relaxed);
+  try {
+    return system_allocate(block_bytes, std::max(alignment, BLOCK_ALIGNMENT));
+  } catch (...) {
+    bytes_in_use.fetch_sub(block_bytes, std::memory_order_relaxed);
+    throw;
+  }
+}
+
+void PoolAllocator::deallocate(void *ptr, size_t bytes) {
+  if (ptr == nullptr) return;
+  if (bytes > MAX_BLOCK_BYTES) {
+    bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+    free(ptr);
+    return;
+  }
+
+  size_t index = class_index(bytes);
+  size_t block_bytes = class_bytes(index);
+  bytes_in_use.fetch_sub(block_bytes, std::memory_order_relaxed);
+  bytes_cached.fetch_add(block_bytes, std::memory_order_relaxed);
+
+  PoolThreadCache *cache = thread_cache();
+  if (cache != nullptr && block_bytes <= THREAD_CACHE_MAX_BYTES) {
+    cache->bind(this);
+    if (cache->blocks.size() != classes.size()) {
+      cache->blocks.resize(classes.size());
+    }
+    if (cache->blocks[index].size() < THREAD_CACHE_BLOCKS) {
+      cache->blocks[index].push_back(ptr);
+      return;
+    }
+  }
+  release(index, ptr);
+}
+
+AllocatorStats PoolAllocator::get_stats() const {
+  AllocatorStats stats;
+  stats.hits = hits.load(std::memory_order_relaxed);
+  stats.misses = misses.load(std::memory_order_relaxed);
+  stats.bytes_in_use = bytes_in_use.load(std::memory_order_relaxed);
+  stats.bytes_cached = bytes_cached.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void PoolAllocator::trim() {
+  for (size_t index = 0; index < classes.size(); index++) {
+    std::vector<void *> blocks;
+    {
+      std::lock_guard<std::mutex> lock(classes[index].mutex);
+      blocks.swap(classes[index].blocks);
+    }
+    bytes_cached.fetch_sub(blocks.size() * class_bytes(index),
+                           std::memory_order_relaxed);
+    for (void *ptr : blocks) {
+      free(ptr);
+    }
+  }
+}
+
+size_t PoolAllocator::class_index(size_t bytes) {
+  if (bytes <= MIN_BLOCK_BYTES) return 0;
+
+  // Four classes split every power of two, the two bits below the highest
+  // one pick the class within it
+  size_t highest_bit = std::bit_width(bytes - 1) - 1;
+  size_t quarter = ((bytes - 1) >> (highest_bit - 2)) & 3;
+  return (highest_bit - std::bit_width(MIN_BLOCK_BYTES - 1)) * 4 + quarter + 1;
+}
+
+size_t PoolAllocator::class_bytes(size_t index) {
+  if (index == 0) return MIN_BLOCK_BYTES;
+
+  size_t highest_bit = (index - 1) / 4 + std::bit_width(MIN_BLOCK_BYTES - 1);
+  size_t quarter = (index - 1) % 4;
+  return (5 + quarter) << (highest_bit - 2);
+}
+
+void PoolAllocator::release(size_t index, void *ptr) {
+  std::lock_guard<std::mutex> lock(classes[index].mutex);
+  classes[index].blocks.push_back(ptr);
+}
@@ -0,0 +1,65 @@
+#include "utility/cpu_features.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+std::atomic<int> CpuFeatures::isa{-1};
+
+CpuFeatures::Isa CpuFeatures::get_supported() {
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__GNUC__) || defined(__clang__))
+  // Also checks that the OS saves the wider registers on a context switch
+  static const Isa supported = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Isa::AVX512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+      return Isa::AVX2;
+    }
+    return Isa::SCALAR;
+  }();
+  return supported;
+#else
+  return Isa::SCALAR;
+#endif
+}
+
+CpuFeatures::Isa CpuFeatures::get_isa() {
+  int current = isa.load(std::memory_order_relaxed);
+  if (current < 0) {
+    const Isa supported = get_supported();
+    const char *env = std::getenv("MML_ISA");
+    const Isa wanted =
+        env && *env ? std::min(from_string(env), supported) : supported;
+    // A concurrent set_isa wins over the default
+    isa.compare_exchange_strong(current, static_cast<int>(wanted));
+    current = isa.load(std::memory_order_relaxed);
+  }
+  return static_cast<Isa>(current);
+}
+
+void CpuFeatures::set_isa(Isa isa) {
+  if (isa > get_supported()) {
+    throw std::invalid_argument("The CPU does not support " + to_string(isa) +
+                                ", only up to " + to_string(get_supported()));
+  }
+  CpuFeatures::isa.store(static_cast<int>(isa), std::memory_order_relaxed);
+}
+
+std::string CpuFeatures::to_string(Isa isa) {
+  switch (isa) {
+    case Isa::AVX512:
+      return "avx512";
+    case Isa::AVX2:
+      return "avx2";
+    default:
+      return "scalar";
+  }
+}
+
+CpuFeatures::Isa CpuFeatures::from_string(const std::string &name) {
+  if (name == "avx512") return Isa::AVX512;
+  if (name == "avx2") return Isa::AVX2;
+  if (name == "scalar") return Isa::SCALAR;
+  throw std::invalid_argument("Unknown instruction set: " + name);
+}
@@ -0,0 +1,43 @@
+#include "utility/gemm_partition.hpp"
+
+GemmPartition::Grid GemmPartition::grid(int M, int N, int K, int row_step,
+                                        int col_step) {
+  Grid g = {1, 1, 1};
+  const size_t threads = Parallel::get_num_threads();
+  if (threads == 1 || M <= 0 || N <= 0 || K <= 0) return g;
+
+  const size_t cost = static_cast<size_t>(M) * N * K;
+  const size_t wanted = std::min(std::max<size_t>(cost / MIN_BLOCK_COST, 1),
+                                 threads * BLOCKS_PER_THREAD);
+  const size_t row_units = (M + row_step - 1) / row_step;
+  const size_t col_units = (N + col_step - 1) / col_step;
+
+  // Rows are split first, as the blocks of a row then share the rows of A
+  // and write whole lines of C
+  g.row_parts = static_cast<int>(std::min(row_units, wanted));
+  g.col_parts = static_cast<int>(
+      std::min(col_units, (wanted + g.row_parts - 1) / g.row_parts));
+
+  // Only a grid that leaves threads idle is worth the buffers of a split K
+  const size_t blocks = static_cast<size_t>(g.row_parts) * g.col_parts;
+  if (blocks < threads && K >= 2 * MIN_K_PART) {
+    const size_t k_parts =
+        std::min({(threads + blocks - 1) / blocks, wanted / blocks,
+                  static_cast<size_t>(K / MIN_K_PART)});
+    g.k_parts = static_cast<int>(std::max<size_t>(k_parts, 1));
+  }
+  return g;
+}
+
+void GemmPartition::part(int size, int step, int parts, int i, int &begin,
+                         int &end) {
+  // The units are spread evenly, the first parts get one more if they do
+  // not divide
+  const int units = (size + step - 1) / step;
+  const int base = units / parts;
+  const int extra = units % parts;
+  const int first = i * base + std::min(i, extra);
+  const int count = base + (i < extra ? 1 : 0);
+  begin = std::min(first * step, size);
+  end = std::min((first + count) * step, size);
+}
@@ -0,0 +1,23 @@
+#include "utility/logger.hpp"
+
+#include <iostream>
+// IWYU pragma: no_include <__ostream/basic_ostream.h>
+#include <ostream>  // IWYU pragma: keep
+
+std::atomic<LogLevel> Logger::level = LogLevel::Error;
+std::mutex Logger::mutex;
+
+void Logger::set_level(LogLevel level) {
+  Logger::level.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::get_level() {
+  return level.load(std::memory_order_relaxed);
+}
+
+void Logger::write(LogLevel level, const std::string &message) {
+  // No std::endl, flushing on every line is what makes logging slow
+  std::lock_guard<std::mutex> lock(mutex);
+  std::ostream &stream = level == LogLevel::Error ? std::cerr : std::cout;
+  stream << message << '\n';
+}
@@ -0,0 +1,112 @@
+#include "utility/parallel.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "utility/logger.hpp"
+
+namespace {
+
+// Helper reading MML_NUM_THREADS, the number of hardware threads if it is
+// not set or malformed
+size_t num_threads_from_env() {
+  const size_t hardware =
+      std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  const char *env = std::getenv("MML_NUM_THREADS");
+  if (!env || !*env) return hardware;
+
+  size_t value = 0;
+  const char *end = env + std::strlen(env);
+  auto [last, error] = std::from_chars(env, end, value);
+  if (error != std::errc() || last != end || value == 0) {
+    Logger::log<LogLevel::Error>("MML_NUM_THREADS=", env,
+                                 " is not a positive number, using ",
+                                 hardware, " threads");
+    return hardware;
+  }
+  return value;
+}
+
+// Helper reading MML_PIN_THREADS, where anything but 0 pins the workers
+bool pin_threads_from_env() {
+  const char *env = std::getenv("MML_PIN_THREADS");
+  return env && std::string(env) != "0";
+}
+
+}  // namespace
+
+std::mutex Parallel::mutex;
+std::shared_ptr<ThreadPool> Parallel::pool;
+std::atomic<size_t> Parallel::num_threads = 0;
+bool Parallel::pin_threads = pin_threads_from_env();
+
+void Parallel::set_num_threads(size_t num_threads) {
+  std::lock_guard<std::mutex> lock(mutex);
+  Parallel::num_threads.store(std::max<size_t>(num_threads, 1),
+                              std::memory_order_relaxed);
+  pool.reset();
+}
+
+size_t Parallel::get_num_threads() {
+  size_t threads = num_threads.load(std::memory_order_relaxed);
+  if (threads == 0) {
+    // A concurrent set_num_threads wins over the default
+    size_t unset = 0;
+    threads = num_threads_from_env();
+    if (!num_threads.compare_exchange_strong(unset, threads)) threads = unset;
+  }
+  return threads;
+}
+
+void Parallel::set_pin_threads(bool pin_threads) {
+  std::lock_guard<std::mutex> lock(mutex);
+  Parallel::pin_threads = pin_threads;
+  pool.reset();
+}
+
+bool Parallel::get_pin_threads() {
+  std::lock_guard<std::mutex> lock(mutex);
+  return pin_threads;
+}
+
+void Parallel::parallel_for(size_t begin, size_t end, size_t grain,
+                            const std::function<void(size_t, size_t)> &body) {
+  if (end <= begin) {
+    return;
+  }
+
+  // Small loops are not worth waking up any worker
+  std::shared_ptr<ThreadPool> current_pool;
+  if (end - begin > std::max<size_t>(grain, 1)) {
+    current_pool = get_pool();
+  }
+
+  if (current_pool) {
+    current_pool->parallel_for(begin, end, grain, body);
+  } else {
+    body(begin, end);
+  }
+}
+
+size_t Parallel::grain_for(size_t cost_per_iteration) {
+  return std::max<size_t>(
+      1, MIN_CHUNK_COST / std::max<size_t>(cost_per_iteration, 1));
+}
+
+std::shared_ptr<ThreadPool> Parallel::get_pool() {
+  // A single thread needs no pool, and no lock to find that out
+  if (get_num_threads() <= 1) return nullptr;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  // The calling thread takes part, so the pool has one thread less. The
+  // count is read again, as set_num_threads might have changed it.
+  size_t threads = num_threads.load(std::memory_order_relaxed);
+  if (!pool && threads > 1) {
+    pool = std::make_shared<ThreadPool>(threads - 1, pin_threads);
+  }
+  return pool;
+}
@@ -0,0 +1,406 @@
+#include "utility/simd_math.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// -1 until the tier is read from the environment on first use
+std::atomic<int> SimdMath::accuracy{-1};
+
+void SimdMath::set_accuracy(MathAccuracy accuracy) {
+  SimdMath::accuracy.store(static_cast<int>(accuracy));
+}
+
+MathAccuracy SimdMath::get_accuracy() {
+  int current = accuracy.load();
+  if (current < 0) {
+    const char *env = std::getenv("MML_MATH_ACCURACY");
+    current = static_cast<int>(env && std::string(env) == "exact"
+                                   ? MathAccuracy::EXACT
+                                   : MathAccuracy::FAST);
+    accuracy.store(current);
+  }
+  return static_cast<MathAccuracy>(current);
+}
+
+namespace {
+
+// The kernels below are written once against a small set of vector
+// operations, implemented for plain floats, AVX2 and AVX-512. The float one
+// also handles the elements left over after the last full register.
+
+struct ScalarOps {
+  using V = float;
+  using M = bool;
+  static constexpr size_t WIDTH = 1;
+
+  static V set1(float x) { return x; }
+  static V load(const float *p) { return *p; }
+  static void store(float *p, V v) { *p = v; }
+  static V add(V a, V b) { return a + b; }
+  static V sub(V a, V b) { return a - b; }
+  static V mul(V a, V b) { return a * b; }
+  static V div(V a, V b) { return a / b; }
+  static V fma(V a, V b, V c) {
+#if defined(__FMA__)
+    return std::fma(a, b, c);
+#else
+    return a * b + c;
+#endif
+  }
+  static V min(V a, V b) { return a < b ? a : b; }
+  static V max(V a, V b) { return a > b ? a : b; }
+  static V abs(V a) { return std::fabs(a); }
+  static V round(V a) { return std::nearbyint(a); }
+  static M lt(V a, V b) { return a < b; }
+  static M gt(V a, V b) { return a > b; }
+  static M eq(V a, V b) { return a == b; }
+  static M isnan(V a) { return a != a; }
+  static V select(M m, V a, V b) { return m ? a : b; }
+
+  // 2^n for an integral n in [-126, 127]
+  static V pow2(V n) {
+    return std::bit_cast<float>((static_cast<int32_t>(n) + 127) << 23);
+  }
+  // The exponent e of a normal x = m * 2^e with m in [0.5, 1)
+  static V exponent(V x) {
+    return static_cast<float>(
+        static_cast<int32_t>((std::bit_cast<uint32_t>(x) >> 23) & 0xff) - 126);
+  }
+  // The m of a normal x = m * 2^e with m in [0.5, 1)
+  static V mantissa(V x) {
+    return std::bit_cast<float>(
+        (std::bit_cast<uint32_t>(x) & 0x807fffffu) | 0x3f000000u);
+  }
+};
+
+#if defined(__AVX512F__)
+struct Avx512Ops {
+  using V = __m512;
+  using M = __mmask16;
+  static constexpr size_t WIDTH = 16;
+
+  static V set1(float x) { return _mm512_set1_ps(x); }
+  static V load(const float *p) { return _mm512_loadu_ps(p); }
+  static void store(float *p, V v) { _mm512_storeu_ps(p, v); }
+  static V add(V a, V b) { return _mm512_add_ps(a, b); }
+  static V sub(V a, V b) { return _mm512_sub_ps(a, b); }
+  static V mul(V a, V b) { return _mm512_mul_ps(a, b); }
+  static V div(V a, V b) { return _mm512_div_ps(a, b); }
+  static V fma(V a, V b, V c) { return _mm512_fmadd_ps(a, b, c); }
+  static V min(V a, V b) { return _mm512_min_ps(a, b); }
+  static V max(V a, V b) { return _mm512_max_ps(a, b); }
+  static V abs(V a) {
+    return _mm512_castsi512_ps(_mm512_and_si512(
+        _mm512_castps_si512(a), _mm512_set1_epi32(0x7fffffff)));
+  }
+  static V round(V a) {
+    return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEAREST_INT |
+                                       _MM_FROUND_NO_EXC);
+  }
+  static M lt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+  static M gt(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ); }
+  static M eq(V a, V b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+  static M isnan(V a) { return _mm512_cmp_ps_mask(a, a, _CMP_UNORD_Q); }
+  static V select(M m, V a, V b) { return _mm512_mask_blend_ps(m, b, a); }
+
+  static V pow2(V n) {
+    __m512i bits = _mm512_add_epi32(_mm512_cvtps_epi32(n),
+                                    _mm512_set1_epi32(127));
+    return _mm512_castsi512_ps(_mm512_slli_epi32(bits, 23));
+  }
+  static V exponent(V x) {
+    __m512i bits = _mm512_srli_epi32(_mm512_castps_si512(x), 23);
+    bits = _mm512_and_si512(bits, _mm512_set1_epi32(0xff));
+    return _mm512_cvtepi32_ps(
+        _mm512_sub_epi32(bits, _mm512_set1_epi32(126)));
+  }
+  static V mantissa(V x) {
+    __m512i bits = _mm512_and_si512(_mm512_castps_si512(x),
+                                    _mm512_set1_epi32(0x807fffff));
+    return _mm512_castsi512_ps(
+        _mm512_or_si512(bits, _mm512_set1_epi32(0x3f000000)));
+  }
+};
+using VectorOps = Avx512Ops;
+#elif defined(__AVX2__)
+struct Avx2Ops {
+  using V = __m256;
+  using M = __m256;
+  static constexpr size_t WIDTH = 8;
+
+  static V set1(float x) { return _mm256_set1_ps(x); }
+  static V load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, V v) { _mm256_storeu_ps(p, v); }
+  static V add(V a, V b) { return _mm256_add_ps(a, b); }
+  static V sub(V a, V b) { return _mm256_sub_ps(a, b); }
+  static V mul(V a, V b) { return _mm256_mul_ps(a, b); }
+  static V div(V a, V b) { return _mm256_div_ps(a, b); }
+  static V fma(V a, V b, V c) {
+#if defined(__FMA__)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+  }
+  static V min(V a, V b) { return _mm256_min_ps(a, b); }
+  static V max(V a, V b) { return _mm256_max_ps(a, b); }
+  static V abs(V a) {
+    return _mm256_and_ps(
+        a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff)));
+  }
+  static V round(V a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static M lt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static M gt(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+  static M eq(V a, V b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+  static M isnan(V a) { return _mm256_cmp_ps(a, a, _CMP_UNORD_Q); }
+  static V select(M m, V a, V b) { return _mm256_blendv_ps(b, a, m); }
+
+  static V pow2(V n) {
+    __m256i bits = _mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                    _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(bits, 23));
+  }
+  static V exponent(V x) {
+    __m256i bits = _mm256_srli_epi32(_mm256_castps_si256(x), 23);
+    bits = _mm256_and_si256(bits, _mm256_set1_epi32(0xff));
+    return _mm256_cvtepi32_ps(
+        _mm256_sub_epi32(bits, _mm256_set1_epi32(126)));
+  }
+  static V mantissa(V x) {
+    __m256i bits = _mm256_and_si256(_mm256_castps_si256(x),
+                                    _mm256_set1_epi32(0x807fffff));
+    return _mm256_castsi256_ps(
+        _mm256_or_si256(bits, _mm256_set1_epi32(0x3f000000)));
+  }
+};
+using VectorOps = Avx2Ops;
+#else
+using VectorOps = ScalarOps;
+#endif
+
+constexpr float INF = std::numeric_limits<float>::infinity();
+constexpr float NaN = std::numeric_limits<float>::quiet_NaN();
+
+// Cody-Waite split of ln(2), the high part is exact in a few bits
+constexpr float LN2_HI = 0.693359375f;
+constexpr float LN2_LO = -2.12194440e-4f;
+
+// e^x as 2^n * e^r, with |r| <= ln(2) / 2 and a degree 7 polynomial for e^r
+// (the Cephes expf coefficients)
+template <typename S>
+typename S::V exp_v(typename S::V x) {
+  using V = typename S::V;
+  // Below ln(FLT_MIN) the result would be subnormal, above ln(FLT_MAX) it
+  // would overflow
+  constexpr float LO = -87.3365447f;
+  constexpr float HI = 88.7228394f;
+
+  V xc = S::min(S::max(x, S::set1(LO)), S::set1(HI));
+  V n = S::round(S::mul(xc, S::set1(1.44269504088896341f)));
+  V r = S::fma(n, S::set1(-LN2_HI), xc);
+  r = S::fma(n, S::set1(-LN2_LO), r);
+
+  V p = S::set1(1.9875691500e-4f);
+  p = S::fma(p, r, S::set1(1.3981999507e-3f));
+  p = S::fma(p, r, S::set1(8.3334519073e-3f));
+  p = S::fma(p, r, S::set1(4.1665795894e-2f));
+  p = S::fma(p, r, S::set1(1.6666665459e-1f));
+  p = S::fma(p, r, S::set1(5.0000001201e-1f));
+  V y = S::add(S::fma(p, S::mul(r, r), r), S::set1(1.0f));
+
+  // n reaches 128 just below HI, which 2^n alone can not represent
+  V n_low = S::min(n, S::set1(127.0f));
+  y = S::mul(S::mul(y, S::pow2(n_low)), S::pow2(S::sub(n, n_low)));
+
+  y = S::select(S::lt(x, S::set1(LO)), S::set1(0.0f), y);
+  y = S::select(S::gt(x, S::set1(HI)), S::set1(INF), y);
+  return S::select(S::isnan(x), x, y);
+}
+
+// ln(x) as e * ln(2) + ln(m), with m in [sqrt(2) / 2, sqrt(2)) and a degree 9
+// polynomial for ln(m) (the Cephes logf coefficients)
+template <typename S>
+typename S::V log_v(typename S::V x) {
+  using V = typename S::V;
+
+  // Subnormals are scaled up by 2^23 so the exponent bits are meaningful
+  auto subnormal = S::lt(x, S::set1(std::numeric_limits<float>::min()));
+  V xs = S::select(subnormal, S::mul(x, S::set1(8388608.0f)), x);
+  V e = S::exponent(xs);
+  e = S::select(subnormal, S::sub(e, S::set1(23.0f)), e);
+  V m = S::mantissa(xs);
+
+  auto below = S::lt(m, S::set1(0.707106781186547524f));
+  m = S::sub(S::select(below, S::add(m, m), m), S::set1(1.0f));
+  e = S::select(below, S::sub(e, S::set1(1.0f)), e);
+
+  V z = S::mul(m, m);
+  V p = S::set1(7.0376836292e-2f);
+  p = S::fma(p, m, S::set1(-1.1514610310e-1f));
+  p = S::fma(p, m, S::set1(1.1676998740e-1f));
+  p = S::fma(p, m, S::set1(-1.2420140846e-1f));
+  p = S::fma(p, m, S::set1(1.4249322787e-1f));
+  p = S::fma(p, m, S::set1(-1.6668057665e-1f));
+  p = S::fma(p, m, S::set1(2.0000714765e-1f));
+  p = S::fma(p, m, S::set1(-2.4999993993e-1f));
+  p = S::fma(p, m, S::set1(3.3333331174e-1f));
+
+  V y = S::mul(S::mul(p, m), z);
+  y = S::fma(e, S::set1(LN2_LO), y);
+  y = S::fma(z, S::set1(-0.5f), y);
+  y = S::add(m, y);
+  y = S::fma(e, S::set1(LN2_HI), y);
+
+  y = S::select(S::eq(x, S::set1(0.0f)), S::set1(-INF), y);
+  y = S::select(S::lt(x, S::set1(0.0f)), S::set1(NaN), y);
+  y = S::select(S::eq(x, S::set1(INF)), x, y);
+  return S::select(S::isnan(x), x, y);
+}
+
+// tanh(x) from a polynomial below 0.625, where 1 - 2 / (e^2|x| + 1) would
+// cancel, and from exp_v above (the Cephes tanhf coefficients)
+template <typename S>
+typename S::V tanh_v(typename S::V x) {
+  using V = typename S::V;
+  V ax = S::abs(x);
+
+  V z = S::mul(x, x);
+  V p = S::set1(-5.70498872745e-3f);
+  p = S::fma(p, z, S::set1(2.06390887954e-2f));
+  p = S::fma(p, z, S::set1(-5.37397155531e-2f));
+  p = S::fma(p, z, S::set1(1.33314422036e-1f));
+  p = S::fma(p, z, S::set1(-3.33332819422e-1f));
+  V small = S::fma(S::mul(p, z), x, x);
+
+  V e = exp_v<S>(S::add(ax, ax));
+  V large = S::sub(S::set1(1.0f),
+                   S::div(S::set1(2.0f), S::add(e, S::set1(1.0f))));
+  large = S::select(S::lt(x, S::set1(0.0f)),
+                    S::sub(S::set1(0.0f), large), large);
+
+  V y = S::select(S::lt(ax, S::set1(0.625f)), small, large);
+  return S::select(S::isnan(x), x, y);
+}
+
+template <typename S>
+typename S::V sigmoid_v(typename S::V x) {
+  // e^-x overflows to infinity for very negative x, which still gives 0
+  typename S::V e = exp_v<S>(S::sub(S::set1(0.0f), x));
+  return S::div(S::set1(1.0f), S::add(S::set1(1.0f), e));
+}
+
+// erf(x) as x * P(x^2) / Q(x^2) on [-4, 4], where it already rounds to +-1
+// outside
+template <typename S>
+typename S::V erf_v(typename S::V x) {
+  using V = typename S::V;
+  V xc = S::min(S::max(x, S::set1(-4.0f)), S::set1(4.0f));
+  V z = S::mul(xc, xc);
+
+  V p = S::set1(-2.72614225801306e-10f);
+  p = S::fma(p, z, S::set1(2.77068142495902e-08f));
+  p = S::fma(p, z, S::set1(-2.10102402082508e-06f));
+  p = S::fma(p, z, S::set1(-5.69250639462346e-05f));
+  p = S::fma(p, z, S::set1(-7.34990630326855e-04f));
+  p = S::fma(p, z, S::set1(-2.95459980854025e-03f));
+  p = S::fma(p, z, S::set1(-1.60960333262415e-02f));
+  p = S::mul(p, xc);
+
+  V q = S::set1(-1.45660718464996e-05f);
+  q = S::fma(q, z, S::set1(-2.13374055278905e-04f));
+  q = S::fma(q, z, S::set1(-1.68282697438203e-03f));
+  q = S::fma(q, z, S::set1(-7.37332916720468e-03f));
+  q = S::fma(q, z, S::set1(-1.42647390514189e-02f));
+
+  return S::select(S::isnan(x), x, S::div(p, q));
+}
+
+// Wraps a kernel so it can be passed to run as a type
+#define SIMD_MATH_KERNEL(NAME)                                      \
+  struct NAME##_kernel {                                            \
+    template <typename S>                                           \
+    static typename S::V eval(typename S::V x) {                    \
+      return NAME##_v<S>(x);                                        \
+    }                                                               \
+  };
+
+SIMD_MATH_KERNEL(exp)
+SIMD_MATH_KERNEL(log)
+SIMD_MATH_KERNEL(tanh)
+SIMD_MATH_KERNEL(sigmoid)
+SIMD_MATH_KERNEL(erf)
+
+#undef SIMD_MATH_KERNEL
+
+// Runs a kernel over full registers, then over the leftover elements one at
+// a time
+template <typename K>
+void run(const float *in, float *out, size_t n) {
+  size_t i = 0;
+  for (; i + VectorOps::WIDTH <= n; i += VectorOps::WIDTH) {
+    VectorOps::store(out + i,
+                     K::template eval<VectorOps>(VectorOps::load(in + i)));
+  }
+  for (; i < n; ++i) {
+    out[i] = K::template eval<ScalarOps>(in[i]);
+  }
+}
+
+template <typename F>
+void run_exact(const float *in, float *out, size_t n, F f) {
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = f(in[i]);
+  }
+}
+
+}  // namespace
+
+void SimdMath::exp(const float *in, float *out, size_t n) {
+  if (get_accuracy() == MathAccuracy::EXACT) {
+    run_exact(in, out, n, [](float x) { return std::exp(x); });
+  } else {
+    run<exp_kernel>(in, out, n);
+  }
+}
+
+void SimdMath::log(const float *in, float *out, size_t n) {
+  if (get_accuracy() == MathAccuracy::EXACT) {
+    run_exact(in, out, n, [](float x) { return std::log(x); });
+  } else {
+    run<log_kernel>(in, out, n);
+  }
+}
+
+void SimdMath::tanh(const float *in, float *out, size_t n) {
+  if (get_accuracy() == MathAccuracy::EXACT) {
+    run_exact(in, out, n, [](float x) { return std::tanh(x); });
+  } else {
+    run<tanh_kernel>(in, out, n);
+  }
+}
+
+void SimdMath::sigmoid(const float *in, float *out, size_t n) {
+  if (get_accuracy() == MathAccuracy::EXACT) {
+    run_exact(in, out, n, [](float x) { return 1 / (1 + std::exp(-x)); });
+  } else {
+    run<sigmoid_kernel>(in, out, n);
+  }
+}
+
+void SimdMath::erf(const float *in, float *out, size_t n) {
+  if (get_accuracy() == MathAccuracy::EXACT) {
+    run_exact(in, out, n, [](float x) { return std::erf(x); });
+  } else {
+    run<erf_kernel>(in, out, n);
+  }
+}
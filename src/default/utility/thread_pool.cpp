@@ -0,0 +1,221 @@
+#include "utility/thread_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+#ifdef __linux__
+// Helper listing the cores the process may run on, in increasing order
+std::vector<int> allowed_cores() {
+  std::vector<int> cores;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) == 0) {
+    for (int core = 0; core < CPU_SETSIZE; core++) {
+      if (CPU_ISSET(core, &cpu_set)) cores.push_back(core);
+    }
+  }
+  return cores;
+}
+#endif
+
+
+// The pool and queue index of the worker running on this thread, if any
+thread_local const ThreadPool *current_pool = nullptr;
+thread_local size_t current_index = 0;
+
+// Shared between a parallel_for call and its helper tasks, which might only
+// start after the call has returned
+struct ParallelForState {
+  const std::function<void(size_t, size_t)> *body;
+  size_t begin;
+  size_t end;
+  size_t chunk_size;
+  size_t num_chunks;
+  std::atomic<size_t> next_chunk = 0;
+  std::atomic<size_t> finished_chunks = 0;
+  std::mutex mutex;
+  std::condition_variable condition;
+  std::exception_ptr error;
+
+  // Runs chunks until none are left, the body is only touched while the
+  // caller is still waiting for the claimed chunk
+  void run_chunks() {
+    size_t chunk;
+    while ((chunk = next_chunk.fetch_add(1)) < num_chunks) {
+      size_t chunk_begin = begin + chunk * chunk_size;
+      size_t chunk_end = std::min(end, chunk_begin + chunk_size);
+      try {
+        (*body)(chunk_begin, chunk_end);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+      if (finished_chunks.fetch_add(1) + 1 == num_chunks) {
+        std::lock_guard<std::mutex> lock(mutex);
+        condition.notify_all();
+      }
+    }
+  }
+};
+}  // namespace
+
+ThreadPool::ThreadPool(size_t num_threads, bool pin_threads) {
+  if (num_threads == 0) {
+    throw std::invalid_argument("ThreadPool needs at least one thread.");
+  }
+
+  queues.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    queues.push_back(std::make_unique<WorkerQueue>());
+  }
+
+#ifdef __linux__
+  // A core outside the affinity mask of the process, as set by taskset or a
+  // container, would make the pinning fail or leave the allowed cores idle
+  const std::vector<int> cores =
+      pin_threads ? allowed_cores() : std::vector<int>();
+#endif
+
+  workers.reserve(num_threads);
+  for (size_t i = 0; i < num_threads; i++) {
+    workers.emplace_back(&ThreadPool::worker_loop, this, i);
+#ifdef __linux__
+    if (!cores.empty()) {
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(cores[(i + 1) % cores.size()], &cpu_set);
+      pthread_setaffinity_np(workers.back().native_handle(), sizeof(cpu_set),
+                             &cpu_set);
+    }
+#endif
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  condition.notify_all();
+  for (auto &worker : workers) {
+    worker.join();
+  }
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task) {
+  std::packaged_task<void()> packaged(std::move(task));
+  std::future<void> future = packaged.get_future();
+
+  // Workers keep their own tasks close, others are spread round robin
+  size_t index = current_pool == this
+                     ? current_index
+                     : next_queue.fetch_add(1) % queues.size();
+  {
+    std::lock_guard<std::mutex> lock(queues[index]->mutex);
+    queues[index]->tasks.push_back(std::move(packaged));
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    pending++;
+  }
+  condition.notify_one();
+  return future;
+}
+
+void ThreadPool::parallel_for(
+    size_t begin, size_t end, size_t grain,
+    const std::function<void(size_t, size_t)> &body) {
+  if (end <= begin) {
+    return;
+  }
+
+  // Aim for a few chunks per thread so that stealing can even out the load,
+  // but never go below the grain
+  size_t num_threads = workers.size() + 1;
+  size_t chunk_size = std::max<size_t>(
+      std::max<size_t>(grain, 1),
+      (end - begin + 4 * num_threads - 1) / (4 * num_threads));
+  size_t num_chunks = (end - begin + chunk_size - 1) / chunk_size;
+
+  if (num_chunks == 1) {
+    body(begin, end);
+    return;
+  }
+
+  auto state = std::make_shared<ParallelForState>();
+  state->body = &body;
+  state->begin = begin;
+  state->end = end;
+  state->chunk_size = chunk_size;
+  state->num_chunks = num_chunks;
+
+  size_t num_helpers = std::min(workers.size(), num_chunks - 1);
+  for (size_t i = 0; i < num_helpers; i++) {
+    submit([state] { state->run_chunks(); });
+  }
+
+  state->run_chunks();
+
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->condition.wait(
+      lock, [&] { return state->finished_chunks == state->num_chunks; });
+  if (state->error) {
+    std::rethrow_exception(state->error);
+  }
+}
+
+size_t ThreadPool::get_num_threads() const { return workers.size(); }
+
+void ThreadPool::worker_loop(size_t index) {
+  current_pool = this;
+  current_index = index;
+
+  while (true) {
+    std::packaged_task<void()> task;
+    if (try_pop(index, task)) {
+      task();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this] { return stopping || pending > 0; });
+    if (stopping && pending == 0) {
+      return;
+    }
+  }
+}
+
+bool ThreadPool::try_pop(size_t index, std::packaged_task<void()> &task) {
+  // Newest task of the own queue first, it is the most likely to be in cache
+  {
+    WorkerQueue &own = *queues[index];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      pending--;
+      return true;
+    }
+  }
+
+  // Otherwise steal the oldest task of another worker
+  for (size_t offset = 1; offset < queues.size(); offset++) {
+    WorkerQueue &victim = *queues[(index + offset) % queues.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      pending--;
+      return true;
+    }
+  }
+  return false;
+}
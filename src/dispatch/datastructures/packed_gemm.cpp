@@ -0,0 +1,59 @@
+#include "datastructures/packed_gemm.hpp"
+
+#include "datastructures/packed_gemm_kernel.hpp"
+
+// This file is built for the baseline of the target, so it has the scalar
+// kernel. The vector ones are in packed_gemm_avx2.cpp and
+// packed_gemm_avx512.cpp.
+#if defined(__AVX2__)
+#error "The dispatch build must not be compiled for AVX2 or newer"
+#endif
+
+template <>
+PackedGemmKernel<float> packed_gemm_kernel<float, KERNEL_ISA>() {
+  return this_packed_gemm_kernel<float>();
+}
+
+template <>
+PackedGemmKernel<double> packed_gemm_kernel<double, KERNEL_ISA>() {
+  return this_packed_gemm_kernel<double>();
+}
+
+namespace {
+
+// The kernel of the instruction set CpuFeatures selects, which is always
+// the scalar one on other targets than x86
+template <typename T>
+PackedGemmKernel<T> selected_kernel() {
+  static const PackedGemmKernel<T> kernels[] = {
+      packed_gemm_kernel<T, CpuFeatures::Isa::SCALAR>(),
+#if defined(__x86_64__) || defined(__i386__)
+      packed_gemm_kernel<T, CpuFeatures::Isa::AVX2>(),
+      packed_gemm_kernel<T, CpuFeatures::Isa::AVX512>(),
+#endif
+  };
+  return kernels[static_cast<int>(CpuFeatures::get_isa())];
+}
+
+}  // namespace
+
+template <typename T>
+void PackedGemm<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
+                         const T *A, size_t lda, const T *B, size_t ldb,
+                         T BETA, T *C, size_t ldc) {
+  selected_kernel<T>().gemm(TA, TB, M, N, K, ALPHA, A, lda, B, ldb, BETA, C,
+                            ldc, Allocator::get_default().get());
+}
+
+template <typename T>
+int PackedGemm<T>::tile_rows() {
+  return selected_kernel<T>().tile_rows;
+}
+
+template <typename T>
+int PackedGemm<T>::tile_cols() {
+  return selected_kernel<T>().tile_cols;
+}
+
+template class PackedGemm<float>;
+template class PackedGemm<double>;
@@ -0,0 +1,17 @@
+#include "datastructures/packed_gemm_kernel.hpp"
+
+// Added by src/dispatch/CMakeLists.txt, which compiles only this file with
+// -mavx512f
+#if !defined(__AVX512F__)
+#error "packed_gemm_avx512.cpp must be compiled with -mavx512f"
+#endif
+
+template <>
+PackedGemmKernel<float> packed_gemm_kernel<float, KERNEL_ISA>() {
+  return this_packed_gemm_kernel<float>();
+}
+
+template <>
+PackedGemmKernel<double> packed_gemm_kernel<double, KERNEL_ISA>() {
+  return this_packed_gemm_kernel<double>();
+}
@@ -1,67 +1,92 @@
 #include <cblas.h>
 #include <openblas_config.h>
 
-#include <thread>
+#include <atomic>
 
 #include "datastructures/tensor_operations.hpp"
+#include "utility/gemm_partition.hpp"
+#include "utility/parallel.hpp"
 
 template <typename T>
 void TensorOperations<T>::gemm(int TA, int TB, int M, int N, int K, T ALPHA,
                                T BETA, std::shared_ptr<Tensor<T>> A, int lda,
                                std::shared_ptr<Tensor<T>> B, int ldb,
                                std::shared_ptr<Tensor<T>> C, int ldc) {
-  if (TA == 1 || TB == 1) {
+  // The pointers go to BLAS unchecked, so the bounds are checked once up
+  // front, on the matrices as they are stored
+  const size_t a_rows = TA == 1 ? K : M;
+  const size_t a_cols = TA == 1 ? M : K;
+  const size_t b_rows = TB == 1 ? N : K;
+  const size_t b_cols = TB == 1 ? K : N;
+  if (M <= 0 || N <= 0) return;
+  // BLAS takes a row stride shorter than a row as an error
+  if (ldc < N || (K > 0 && (lda < static_cast<int>(a_cols) ||
+                            ldb < static_cast<int>(b_cols)))) {
     throw std::invalid_argument(
-        "BLAS GEMM only supports non-transposed A/B in this wrapper.");
+        "GEMM leading dimensions are shorter than the rows of the matrices");
   }
-
-  int num_threads = std::thread::hardware_concurrency();
-  openblas_set_num_threads(num_threads);
-
-  // Build raw pointer buffers from your Tensor<T> objects
-  std::vector<T> a_raw(M * K);
-  std::vector<T> b_raw(K * N);
-  std::vector<T> c_raw(M * N);
-
-  // Flatten A: M x K
-  for (int i = 0; i < M; ++i) {
-    for (int k = 0; k < K; ++k) {
-      a_raw[i * K + k] = (*A)[i * lda + k];
-    }
+  if (C->get_size() < static_cast<size_t>(M - 1) * ldc + N ||
+      (K > 0 && (A->get_size() < (a_rows - 1) * lda + a_cols ||
+                 B->get_size() < (b_rows - 1) * ldb + b_cols))) {
+    throw std::invalid_argument("GEMM matrices do not match M, N and K");
   }
 
-  // Flatten B: K x N
-  for (int k = 0; k < K; ++k) {
-    for (int j = 0; j < N; ++j) {
-      b_raw[k * N + j] = (*B)[k * ldb + j];
-    }
-  }
+  // BLAS reads A and B and writes C in place, so nothing is copied. A and B
+  // are only read, so a buffer they share with a copy is not made unique.
+  const T *a = std::as_const(*A).get_span().get_data();
+  const T *b = std::as_const(*B).get_span().get_data();
+  T *c = C->get_span().get_data();
 
-  // Optional: fill c_raw with values from C if BETA ≠ 0
-  if (BETA != T(0)) {
-    for (int i = 0; i < M; ++i) {
-      for (int j = 0; j < N; ++j) {
-        c_raw[i * N + j] = (*C)[i * ldc + j];
+  if constexpr (std::is_same<T, float>::value ||
+                std::is_same<T, double>::value) {
+    if (K > 0) {
+      // OpenBLAS keeps its own threads, it is only told when the count has
+      // changed, which is once at the first call unless set_num_threads is
+      // used
+      static std::atomic<size_t> blas_threads = 0;
+      size_t num_threads = Parallel::get_num_threads();
+      if (blas_threads.exchange(num_threads) != num_threads) {
+        openblas_set_num_threads(static_cast<int>(num_threads));
       }
-    }
-  }
-
-  if constexpr (std::is_same<T, float>::value) {
-    cblas_sgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, ALPHA,
-                a_raw.data(), K, b_raw.data(), N, BETA, c_raw.data(), N);
-  } else if constexpr (std::is_same<T, double>::value) {
-    cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, M, N, K, ALPHA,
-                a_raw.data(), K, b_raw.data(), N, BETA, c_raw.data(), N);
-  } else {
-    throw std::runtime_error("BLAS GEMM only supports float and double types.");
-  }
 
-  // Copy results back into C
-  for (int i = 0; i < M; ++i) {
-    for (int j = 0; j < N; ++j) {
-      (*C)[i * ldc + j] = c_raw[i * N + j];
+      const CBLAS_TRANSPOSE trans_a = TA == 1 ? CblasTrans : CblasNoTrans;
+      const CBLAS_TRANSPOSE trans_b = TB == 1 ? CblasTrans : CblasNoTrans;
+      if constexpr (std::is_same<T, float>::value) {
+        cblas_sgemm(CblasRowMajor, trans_a, trans_b, M, N, K, ALPHA, a, lda,
+                    b, ldb, BETA, c, ldc);
+      } else {
+        cblas_dgemm(CblasRowMajor, trans_a, trans_b, M, N, K, ALPHA, a, lda,
+                    b, ldb, BETA, c, ldc);
+      }
+      return;
     }
   }
+
+  // BLAS has no integer GEMM, and rejects the leading dimensions of an
+  // empty A and B, so the other types and an empty K keep the loops of the
+  // default build
+  const size_t a_row_stride = TA == 1 ? 1 : lda;
+  const size_t a_col_stride = TA == 1 ? lda : 1;
+  const size_t b_row_stride = TB == 1 ? 1 : ldb;
+  const size_t b_col_stride = TB == 1 ? ldb : 1;
+  GemmPartition::run(
+      M, N, K, 1, 1, BETA, c, static_cast<size_t>(ldc),
+      [&](const GemmBlock &block, T beta, T *out, size_t ld_out) {
+        for (int i = block.row_begin; i < block.row_end; i++) {
+          T *c_row = out + i * ld_out;
+          // C is not read for a zero beta, like BLAS does
+          for (int j = block.col_begin; j < block.col_end; j++) {
+            c_row[j] = beta == T(0) ? T(0) : beta * c_row[j];
+          }
+          for (int k = block.k_begin; k < block.k_end; k++) {
+            const T a_ik = a[i * a_row_stride + k * a_col_stride];
+            const T *b_row = b + k * b_row_stride;
+            for (int j = block.col_begin; j < block.col_end; j++) {
+              c_row[j] += ALPHA * a_ik * b_row[j * b_col_stride];
+            }
+          }
+        }
+      });
 }
 
 #define TYPE(DT) _TENSOR_OPERATIONS(DT)
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <modularml>
+
+TEST(test_allocator, test_pool_recycles_blocks) {
+  auto pool = std::make_shared<PoolAllocator>();
+
+  void *first = pool->allocate(1000, 64);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 64, 0);
+  AllocatorStats stats = pool->get_stats();
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_GE(stats.bytes_in_use, 1000);
+  pool->deallocate(first, 1000);
+  EXPECT_EQ(pool->get_stats().bytes_in_use, 0);
+  EXPECT_GE(pool->get_stats().bytes_cached, 1000);
+
+  // A request of the same size class gets the freed block back
+  void *second = pool->allocate(990, 64);
+  EXPECT_EQ(second, first);
+  stats = pool->get_stats();
+  EXPECT_EQ(stats.hits, 1);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.bytes_cached, 0);
+  pool->deallocate(second, 990);
+}
+
+TEST(test_allocator, test_pool_trim_releases_shared_blocks) {
+  auto pool = std::make_shared<PoolAllocator>();
+
+  // Blocks too large for the thread cache go straight to the shared lists
+  size_t bytes = size_t(1) << 20;
+  void *ptr = pool->allocate(bytes, 64);
+  pool->deallocate(ptr, bytes);
+  EXPECT_EQ(pool->get_stats().bytes_cached, bytes);
+
+  pool->trim();
+  EXPECT_EQ(pool->get_stats().bytes_cached, 0);
+  pool->deallocate(pool->allocate(bytes, 64), bytes);
+  EXPECT_EQ(pool->get_stats().misses, 2);
+}
+
+TEST(test_allocator, test_pool_returns_large_blocks_to_the_system) {
+  auto pool = std::make_shared<PoolAllocator>();
+
+  size_t bytes = size_t(1) << 27;
+  pool->deallocate(pool->allocate(bytes, 64), bytes);
+  AllocatorStats stats = pool->get_stats();
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.bytes_cached, 0);
+}
+
+TEST(test_allocator, test_default_follows_set_default) {
+  auto previous = Allocator::get_default();
+  auto pool = std::make_shared<PoolAllocator>();
+
+  Allocator::set_default(pool);
+  EXPECT_EQ(Allocator::get_default(), pool);
+  auto buffer = alloc_aligned_memory<float>(16);
+  EXPECT_GE(pool->get_stats().bytes_in_use, 16 * sizeof(float));
+
+  Allocator::set_default(previous);
+  EXPECT_EQ(Allocator::get_default(), previous);
+}
+
+TEST(test_allocator, test_repeated_inference_does_not_allocate) {
+  auto previous = Allocator::get_default();
+  auto pool = std::make_shared<PoolAllocator>();
+  Allocator::set_default(pool);
+
+  {
+    std::unordered_map<std::string, GeneralDataTypes> weights;
+    Model model({std::make_shared<ReLUNode>("X", "A"),
+                 std::make_shared<TanHNode>("A", "B"),
+                 std::make_shared<AddNode>("A", "B", "Y")},
+                weights, {"X"}, {"Y"});
+    auto infer = [&model]() {
+      auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{64, 64});
+      x->fill(0.5f);
+      model.infer({{"X", x}});
+    };
+
+    // The first inferences fill the pool, the next ones only reuse it
+    infer();
+    infer();
+    size_t misses = pool->get_stats().misses;
+    for (int i = 0; i < 3; i++) {
+      infer();
+    }
+    EXPECT_EQ(pool->get_stats().misses, misses);
+    EXPECT_GT(pool->get_stats().hits, 0);
+  }
+
+  Allocator::set_default(previous);
+}
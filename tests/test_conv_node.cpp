@@ -65,6 +65,118 @@ TEST(conv_node_test, test_forward_simple) {
   EXPECT_FLOAT_EQ(result_ptr->get_data()[3], 28);
 }
 
+TEST(conv_node_test, test_forward_does_not_modify_weights) {
+  auto X = std::make_shared<Tensor<float>>(
+      array_mml<size_t>({1, 1, 3, 3}),
+      array_mml<float>({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f}));
+  auto W = std::make_shared<Tensor<float>>(
+      array_mml<size_t>({1, 1, 2, 2}),
+      array_mml<float>({1.0f, 1.0f, 1.0f, 1.0f}));
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["X"] = X;
+  iomap["W"] = W;
+
+  ConvNode conv("X", "W", "Y", array_mml<size_t>({1, 1}),
+                array_mml<size_t>({0, 0, 0, 0}), array_mml<size_t>({2, 2}),
+                array_mml<size_t>({1, 1}), std::nullopt, 1);
+
+  // Weights are shared between inferences, so running the node twice must
+  // give the same result and leave W as it was
+  for (int i = 0; i < 2; i++) {
+    iomap.erase("Y");
+    conv.forward(iomap);
+
+    auto Y = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+    EXPECT_FLOAT_EQ((*Y)[0], 12);
+    EXPECT_FLOAT_EQ((*Y)[3], 28);
+  }
+  EXPECT_EQ(W->get_shape(), array_mml<size_t>({1, 1, 2, 2}));
+  EXPECT_EQ(X->get_shape(), array_mml<size_t>({1, 1, 3, 3}));
+}
+
+TEST(conv_node_test, test_forward_half_weights_and_bias) {
+  // Two images, the second is twice the first
+  auto X = std::make_shared<Tensor<float>>(
+      array_mml<size_t>({2, 1, 3, 3}),
+      array_mml<float>({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                        2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f, 14.0f, 16.0f,
+                        18.0f}));
+  // A filter of ones and one of halves
+  auto W = std::make_shared<Tensor<fp16_t>>(array_mml<size_t>({2, 1, 2, 2}));
+  for (size_t i = 0; i < 8; i++) (*W)[i] = i < 4 ? 1.0f : 0.5f;
+  auto B = std::make_shared<Tensor<bf16_t>>(array_mml<size_t>({2}));
+  (*B)[0] = 1.0f;
+  (*B)[1] = -1.0f;
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["X"] = X;
+  iomap["W"] = W;
+  iomap["B"] = B;
+
+  ConvNode conv("X", "W", "Y", array_mml<size_t>({1, 1}),
+                array_mml<size_t>({0, 0, 0, 0}), array_mml<size_t>({2, 2}),
+                array_mml<size_t>({1, 1}), "B", 1);
+  conv.forward(iomap);
+
+  auto Y = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  ASSERT_EQ(Y->get_shape(), array_mml<size_t>({2, 2, 2, 2}));
+  float expected[] = {13, 17, 25, 29, 5,  7,  11, 13,
+                      25, 33, 49, 57, 11, 15, 23, 27};
+  for (size_t i = 0; i < 16; i++) {
+    EXPECT_FLOAT_EQ((*Y)[i], expected[i]);
+  }
+}
+
+TEST(conv_node_test, test_forward_rejects_mismatched_shapes) {
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["W"] = std::make_shared<Tensor<float>>(array_mml<size_t>({1, 1, 2, 2}));
+  ConvNode conv("X", "W", "Y", array_mml<size_t>({1, 1}),
+                array_mml<size_t>({0, 0, 0, 0}), array_mml<size_t>({2, 2}),
+                array_mml<size_t>({1, 1}), std::nullopt, 1);
+
+  // X without the batch dimension, and X smaller than the kernel
+  iomap["X"] = std::make_shared<Tensor<float>>(array_mml<size_t>({1, 3, 3}));
+  EXPECT_THROW(conv.forward(iomap), std::runtime_error);
+  iomap.erase("Y");
+  iomap["X"] =
+      std::make_shared<Tensor<float>>(array_mml<size_t>({1, 1, 1, 3}));
+  EXPECT_THROW(conv.forward(iomap), std::runtime_error);
+  iomap.erase("Y");
+  iomap["X"] =
+      std::make_shared<Tensor<float>>(array_mml<size_t>({1, 2, 3, 3}));
+  EXPECT_THROW(conv.forward(iomap), std::runtime_error);
+}
+
+TEST(conv_node_test, test_forward_padded_batch) {
+  // Two images, the second one is the first one doubled
+  auto X = std::make_shared<Tensor<float>>(
+      array_mml<size_t>({2, 1, 3, 3}),
+      array_mml<float>({1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f, 9.0f,
+                        2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f, 14.0f, 16.0f,
+                        18.0f}));
+  auto W = std::make_shared<Tensor<float>>(array_mml<size_t>({1, 1, 3, 3}));
+  W->fill(1.0f);
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["X"] = X;
+  iomap["W"] = W;
+
+  ConvNode conv("X", "W", "Y", array_mml<size_t>({1, 1}),
+                array_mml<size_t>({1, 1, 1, 1}), array_mml<size_t>({3, 3}),
+                array_mml<size_t>({1, 1}), std::nullopt, 1);
+  conv.forward(iomap);
+
+  // Every output sums the neighbourhood of a pixel, the padding reads as zero
+  auto Y = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  ASSERT_EQ(Y->get_shape(), array_mml<size_t>({2, 1, 3, 3}));
+  std::vector<float> expected = {12, 21, 16, 27, 45, 33, 24, 39, 28};
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_FLOAT_EQ((*Y)[i], expected[i]);
+    EXPECT_FLOAT_EQ((*Y)[i + 9], 2 * expected[i]);
+  }
+}
+
 TEST(conv_node_test, test_forward_5x5input_2x2filter) {
   // The purpose of this test is to check that the convolution node is able to
   // handle multiple input and output channels
@@ -0,0 +1,149 @@
+#include <gtest/gtest.h>
+
+#include <modularml>
+
+TEST(test_execution_plan, test_order_and_slots) {
+  // Diamond shaped graph given out of order: X -> a -> (b, c) -> Y
+  auto add = std::make_shared<AddNode>("b", "c", "Y");
+  auto relu_a = std::make_shared<ReLUNode>("X", "a");
+  auto relu_b = std::make_shared<ReLUNode>("a", "b");
+  auto relu_c = std::make_shared<TanHNode>("a", "c");
+
+  ExecutionPlan plan({add, relu_b, relu_a, relu_c}, {}, {"X"}, {"Y"});
+
+  const auto &steps = plan.getSteps();
+  ASSERT_EQ(steps.size(), 4);
+  EXPECT_EQ(steps[0].node, relu_a);
+  EXPECT_EQ(steps[3].node, add);
+
+  // The two branches end up in the same layer
+  EXPECT_EQ(plan.getLayerOffsets(), std::vector<size_t>({0, 1, 3, 4}));
+
+  // Every tensor name resolves to one dense slot
+  EXPECT_EQ(plan.getNumSlots(), 5);
+  EXPECT_EQ(plan.getInputSlots(), std::vector<size_t>({0}));
+  EXPECT_EQ(plan.getSlotName(plan.getOutputSlots()[0]), "Y");
+  EXPECT_EQ(steps[3].inputs[0], plan.findSlot("b").value());
+  EXPECT_EQ(steps[3].inputs[1], plan.findSlot("c").value());
+  EXPECT_EQ(steps[1].inputs[0], steps[0].outputs[0]);
+  EXPECT_FALSE(plan.findSlot("missing").has_value());
+}
+
+TEST(test_execution_plan, test_cycle_throws) {
+  auto relu_a = std::make_shared<ReLUNode>("b", "a");
+  auto relu_b = std::make_shared<ReLUNode>("a", "b");
+
+  EXPECT_THROW(ExecutionPlan({relu_a, relu_b}, {}, {}, {}),
+               std::runtime_error);
+  EXPECT_THROW(ExecutionPlan({}, {}, {}, {}), std::runtime_error);
+}
+
+TEST(test_execution_plan, test_model_reuses_plan) {
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({std::make_shared<ReLUNode>("X", "Y")}, weights, {"X"}, {"Y"});
+  model.compile();
+
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{2},
+                                           array_mml<float>{-1.0f, 2.0f});
+  for (int i = 0; i < 2; i++) {
+    auto outputs = model.infer({{"X", x}});
+    auto y = std::get<std::shared_ptr<Tensor<float>>>(outputs.at("Y"));
+    EXPECT_FLOAT_EQ((*y)[0], 0.0f);
+    EXPECT_FLOAT_EQ((*y)[1], 2.0f);
+  }
+  EXPECT_EQ(model.getPlan().getSteps().size(), 1);
+
+  // Changing the graph invalidates the plan
+  model.addNode(std::make_shared<TanHNode>("Y", "Z"));
+  EXPECT_EQ(model.getPlan().getSteps().size(), 2);
+}
+
+TEST(test_execution_plan, test_model_inter_op_threads) {
+  // Four independent branches in the same layer, joined by two adds
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({std::make_shared<ReLUNode>("X", "a"),
+               std::make_shared<TanHNode>("X", "b"),
+               std::make_shared<SigmoidNode>("X", "c"),
+               std::make_shared<ReLUNode>("X", "d"),
+               std::make_shared<AddNode>("a", "b", "ab"),
+               std::make_shared<AddNode>("c", "d", "cd"),
+               std::make_shared<AddNode>("ab", "cd", "Y")},
+              weights, {"X"}, {"Y"});
+
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{3},
+                                           array_mml<float>{-1.0f, 0.5f, 2.0f});
+  auto expected = std::get<std::shared_ptr<Tensor<float>>>(
+      model.infer({{"X", x}}).at("Y"));
+
+  model.setInterOpThreads(4);
+  EXPECT_EQ(model.getInterOpThreads(), 4);
+  for (int i = 0; i < 3; i++) {
+    auto y = std::get<std::shared_ptr<Tensor<float>>>(
+        model.infer({{"X", x}}).at("Y"));
+    EXPECT_EQ(*y, *expected);
+  }
+
+  model.setInterOpThreads(1);
+  EXPECT_EQ(model.getInterOpThreads(), 1);
+  EXPECT_THROW(model.setInterOpThreads(0), std::invalid_argument);
+}
+
+TEST(test_execution_plan, test_node_forward_on_slots) {
+  auto relu = std::make_shared<ReLUNode>("X", "Y");
+
+  TensorTable table(3);
+  table[2] = std::make_shared<Tensor<float>>(array_mml<size_t>{2},
+                                             array_mml<float>{-1.0f, 2.0f});
+  EXPECT_FALSE(table.contains(0));
+
+  relu->forward(table, {2}, {0});
+  ASSERT_TRUE(table.contains(0));
+  auto y = std::get<std::shared_ptr<Tensor<float>>>(table[0]);
+  EXPECT_FLOAT_EQ((*y)[0], 0.0f);
+  EXPECT_FLOAT_EQ((*y)[1], 2.0f);
+
+  table.erase(0);
+  EXPECT_FALSE(table.contains(0));
+}
+
+TEST(test_execution_plan, test_map_forward_keeps_model_slots) {
+  auto relu = std::make_shared<ReLUNode>("X", "Y");
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({relu}, weights, {"X"}, {"Y"});
+  model.compile();
+
+  // Running the node on its own uses slots of a temporary table
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["X"] = std::make_shared<Tensor<float>>(array_mml<size_t>{1},
+                                               array_mml<float>{-3.0f});
+  relu->forward(iomap);
+  ASSERT_TRUE(iomap.find("Y") != iomap.end());
+
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{2},
+                                           array_mml<float>{-1.0f, 2.0f});
+  auto y = std::get<std::shared_ptr<Tensor<float>>>(
+      model.infer({{"X", x}}).at("Y"));
+  EXPECT_FLOAT_EQ((*y)[1], 2.0f);
+}
+
+TEST(test_execution_plan, test_models_share_a_node) {
+  // The initializer of the second model moves Y to another slot
+  auto relu = std::make_shared<ReLUNode>("X", "Y");
+  std::unordered_map<std::string, GeneralDataTypes> no_weights;
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  weights["W"] = std::make_shared<Tensor<float>>(array_mml<size_t>{1});
+  Model first({relu}, no_weights, {"X"}, {"Y"});
+  Model second({relu}, weights, {"X"}, {"Y"});
+  first.compile();
+  second.compile();
+  EXPECT_NE(first.getPlan().findSlot("Y"), second.getPlan().findSlot("Y"));
+
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{2},
+                                           array_mml<float>{-1.0f, 2.0f});
+  for (Model *model : {&first, &second, &first}) {
+    auto y = std::get<std::shared_ptr<Tensor<float>>>(
+        model->infer({{"X", x}}).at("Y"));
+    EXPECT_FLOAT_EQ((*y)[0], 0.0f);
+    EXPECT_FLOAT_EQ((*y)[1], 2.0f);
+  }
+}
@@ -54,4 +54,118 @@ TEST(GemmNodeTest, ForwardMultiplication) {
   for (int i = 0; i < expected.get_size(); i++) {
     EXPECT_FLOAT_EQ(expected[i], (*result_ptr)[i]);
   }
-}
\ No newline at end of file
+}
+TEST(GemmNodeTest, ForwardHalfWeights) {
+  // A fully connected layer: the weights are N x K and C is a bias of N
+  auto A_ptr = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{1, 3}, array_mml<float>{1, 2, 3});
+  auto B_ptr = std::make_shared<Tensor<fp16_t>>(array_mml<size_t>{2, 3});
+  float weights[] = {0.5f, -1, 2, 4, 0.25f, -0.125f};
+  for (size_t i = 0; i < 6; i++) (*B_ptr)[i] = weights[i];
+  auto C_ptr = std::make_shared<Tensor<float>>(array_mml<size_t>{2},
+                                               array_mml<float>{10, 20});
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["A"] = A_ptr;
+  iomap["B"] = B_ptr;
+  iomap["C"] = C_ptr;
+
+  GemmNode node("A", "B", "Y", "C", 1.0f, 1.0f, 0, 1);
+  node.forward(iomap);
+
+  auto result_ptr = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  ASSERT_EQ(result_ptr->get_shape(), (Shape{1, 2}));
+  // 0.5 - 2 + 6 + 10 and 4 + 0.5 - 0.375 + 20
+  EXPECT_FLOAT_EQ((*result_ptr)[0], 14.5f);
+  EXPECT_FLOAT_EQ((*result_ptr)[1], 24.125f);
+}
+
+TEST(GemmNodeTest, ForwardHalfBias) {
+  // Both the weights and the bias of the layer are stored in 16 bits
+  auto A_ptr = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 3}, array_mml<float>{1, 2, 3, 4, 5, 6});
+  auto B_ptr = std::make_shared<Tensor<bf16_t>>(array_mml<size_t>{2, 3});
+  float weights[] = {1, 0, -1, 0.5f, 0.5f, 0.5f};
+  for (size_t i = 0; i < 6; i++) (*B_ptr)[i] = weights[i];
+  auto C_ptr = std::make_shared<Tensor<fp16_t>>(array_mml<size_t>{2});
+  (*C_ptr)[0] = 0.25f;
+  (*C_ptr)[1] = -8.0f;
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["A"] = A_ptr;
+  iomap["B"] = B_ptr;
+  iomap["C"] = C_ptr;
+
+  GemmNode node("A", "B", "Y", "C", 1.0f, 2.0f, 0, 1);
+  node.forward(iomap);
+
+  auto result_ptr = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  ASSERT_EQ(result_ptr->get_shape(), (Shape{2, 2}));
+  // C is added to every row, scaled by beta
+  EXPECT_FLOAT_EQ((*result_ptr)[0], -1.5f);
+  EXPECT_FLOAT_EQ((*result_ptr)[1], -13.0f);
+  EXPECT_FLOAT_EQ((*result_ptr)[2], -1.5f);
+  EXPECT_FLOAT_EQ((*result_ptr)[3], -8.5f);
+}
+
+TEST(GemmNodeTest, ForwardRejectsMismatchedBias) {
+  auto A_ptr = std::make_shared<Tensor<float>>(array_mml<size_t>{1, 2});
+  auto B_ptr = std::make_shared<Tensor<float>>(array_mml<size_t>{2, 2});
+  auto C_ptr = std::make_shared<Tensor<int32_t>>(array_mml<size_t>{2});
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["A"] = A_ptr;
+  iomap["B"] = B_ptr;
+  iomap["C"] = C_ptr;
+
+  GemmNode node("A", "B", "Y", "C", 1.0f, 1.0f, 0, 0);
+  EXPECT_THROW(node.forward(iomap), std::runtime_error);
+}
+
+TEST(GemmNodeTest, ForwardWithoutCIgnoresBeta) {
+  auto A_ptr = std::make_shared<Tensor<float>>(array_mml<size_t>{1, 2},
+                                               array_mml<float>{1, 2});
+  auto B_ptr = std::make_shared<Tensor<float>>(array_mml<size_t>{2, 2},
+                                               array_mml<float>{3, 4, 5, 6});
+  // The output tensor is reused, and its old values must not be read
+  auto Y_ptr = std::make_shared<Tensor<float>>(array_mml<size_t>{1, 2});
+  Y_ptr->fill(std::numeric_limits<float>::quiet_NaN());
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["A"] = A_ptr;
+  iomap["B"] = B_ptr;
+  iomap["Y"] = Y_ptr;
+
+  GemmNode node("A", "B", "Y", std::nullopt, 1.0f, 1.0f, 0, 0);
+  node.forward(iomap);
+
+  auto result_ptr = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  EXPECT_FLOAT_EQ((*result_ptr)[0], 13.0f);
+  EXPECT_FLOAT_EQ((*result_ptr)[1], 16.0f);
+}
+
+TEST(GemmNodeTest, ForwardTransposedInputs) {
+  // The same product as ForwardMultiplication, with A and B stored
+  // transposed and read in place
+  auto A_ptr = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{3, 2}, array_mml<float>{1, 4, 2, 5, 3, 6});
+  auto B_ptr = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 3}, array_mml<float>{7, 9, 11, 8, 10, 12});
+
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["A"] = A_ptr;
+  iomap["B"] = B_ptr;
+
+  GemmNode node("A", "B", "Y", std::nullopt, 1.0f, 0.0f, 1, 1);
+  node.forward(iomap);
+
+  auto result_ptr = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  ASSERT_EQ(result_ptr->get_shape(), (Shape{2, 2}));
+  const float expected[] = {58.0f, 64.0f, 139.0f, 154.0f};
+  for (int i = 0; i < 4; i++) {
+    EXPECT_FLOAT_EQ(expected[i], (*result_ptr)[i]);
+  }
+  // The inputs are not touched
+  EXPECT_FLOAT_EQ((*A_ptr)[1], 4.0f);
+  EXPECT_FLOAT_EQ((*B_ptr)[1], 9.0f);
+}
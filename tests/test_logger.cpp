@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <modularml>
+
+TEST(test_logger, test_levels) {
+#if MML_MAX_LOG_LEVEL < 2
+  GTEST_SKIP() << "Trace logging is not compiled in";
+#endif
+
+  LogLevel previous_level = Logger::get_level();
+
+  Logger::set_level(LogLevel::Trace);
+  testing::internal::CaptureStdout();
+  Logger::log<LogLevel::Trace>("Layer ", 1, " of ", 2);
+  EXPECT_EQ(testing::internal::GetCapturedStdout(), "Layer 1 of 2\n");
+
+  Logger::set_level(LogLevel::Error);
+  EXPECT_TRUE(Logger::enabled<LogLevel::Error>());
+  EXPECT_FALSE(Logger::enabled<LogLevel::Trace>());
+  testing::internal::CaptureStdout();
+  Logger::log<LogLevel::Trace>("Not written");
+  EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+
+  Logger::set_level(previous_level);
+}
+
+TEST(test_logger, test_model_off_is_quiet) {
+  LogLevel previous_level = Logger::get_level();
+  Logger::set_level(LogLevel::Off);
+
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({std::make_shared<ReLUNode>("X", "Y"),
+               std::make_shared<TanHNode>("Y", "Z")},
+              weights, {"X"}, {"Z"});
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{2},
+                                           array_mml<float>{-1.0f, 2.0f});
+
+  testing::internal::CaptureStdout();
+  testing::internal::CaptureStderr();
+  model.infer({{"X", x}});
+  EXPECT_EQ(testing::internal::GetCapturedStdout(), "");
+
+  // A failing node is still rethrown, only the report is left out
+  EXPECT_THROW(model.infer({}), std::runtime_error);
+  EXPECT_EQ(testing::internal::GetCapturedStderr(), "");
+
+  Logger::set_level(previous_level);
+}
+
+TEST(test_logger, test_node_error_context) {
+#if MML_MAX_LOG_LEVEL < 1
+  GTEST_SKIP() << "Error logging is not compiled in";
+#endif
+
+  LogLevel previous_level = Logger::get_level();
+  Logger::set_level(LogLevel::Error);
+
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({std::make_shared<ReLUNode>("X", "Y")}, weights, {"X"}, {"Y"});
+
+  testing::internal::CaptureStderr();
+  EXPECT_THROW(model.infer({}), std::runtime_error);
+  std::string output = testing::internal::GetCapturedStderr();
+  EXPECT_NE(output.find("Node inputs: X"), std::string::npos);
+  EXPECT_NE(output.find("Node outputs: Y"), std::string::npos);
+
+  Logger::set_level(previous_level);
+}
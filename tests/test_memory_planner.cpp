@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <modularml>
+#include <thread>
+
+TEST(test_memory_planner, test_reuses_dead_tensors) {
+  // Chain X -> a -> b -> c -> Y, where a is dead by the time c is produced
+  ExecutionPlan plan({std::make_shared<ReLUNode>("X", "a"),
+                      std::make_shared<TanHNode>("a", "b"),
+                      std::make_shared<ReLUNode>("b", "c"),
+                      std::make_shared<TanHNode>("c", "Y")},
+                     {}, {"X"}, {"Y"});
+
+  // Graph inputs and outputs are never planned
+  EXPECT_FALSE(plan.getLifetime(plan.findSlot("X").value()).has_value());
+  EXPECT_FALSE(plan.getLifetime(plan.findSlot("Y").value()).has_value());
+  EXPECT_EQ(plan.getReleases(1),
+            std::vector<size_t>({plan.findSlot("a").value()}));
+
+  const size_t bytes = MemoryPlanner::getAlignment() * 4;
+  std::vector<size_t> slot_bytes(plan.getNumSlots(), bytes);
+  MemoryPlanner planner(plan, slot_bytes);
+
+  ASSERT_EQ(planner.getAllocations().size(), 3);
+  EXPECT_EQ(planner.getNaiveBytes(), 3 * bytes);
+  EXPECT_EQ(planner.getPeakBytes(), 2 * bytes);
+
+  std::unordered_map<std::string, size_t> offsets;
+  for (const auto &allocation : planner.getAllocations()) {
+    EXPECT_EQ(allocation.offset % MemoryPlanner::getAlignment(), 0);
+    offsets[plan.getSlotName(allocation.slot)] = allocation.offset;
+  }
+  EXPECT_EQ(offsets["a"], offsets["c"]);
+  EXPECT_NE(offsets["a"], offsets["b"]);
+}
+
+TEST(test_memory_planner, test_model_infers_from_arena) {
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({std::make_shared<ReLUNode>("X", "a"),
+               std::make_shared<TanHNode>("a", "b"),
+               std::make_shared<ReLUNode>("b", "c"),
+               std::make_shared<ReLUNode>("c", "Y")},
+              weights, {"X"}, {"Y"});
+  EXPECT_FALSE(model.getMemoryPlan().has_value());
+
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{2, 2},
+                                           array_mml<float>{-1, 0, 1, 2});
+  auto first = std::get<std::shared_ptr<Tensor<float>>>(
+      model.infer({{"X", x}}).at("Y"));
+  ASSERT_TRUE(model.getMemoryPlan().has_value());
+  EXPECT_LT(model.getMemoryPlan()->getPeakBytes(),
+            model.getMemoryPlan()->getNaiveBytes());
+
+  // The second inference runs from the arena and gives the same result
+  auto second = std::get<std::shared_ptr<Tensor<float>>>(
+      model.infer({{"X", x}}).at("Y"));
+  EXPECT_EQ(*first, *second);
+  EXPECT_FLOAT_EQ((*second)[3], std::tanh(2.0f));
+
+  // New input shapes make the model plan again
+  size_t peak_bytes = model.getMemoryPlan()->getPeakBytes();
+  auto larger = std::make_shared<Tensor<float>>(array_mml<size_t>{64, 64});
+  larger->fill(1.0f);
+  auto y = std::get<std::shared_ptr<Tensor<float>>>(
+      model.infer({{"X", larger}}).at("Y"));
+  EXPECT_EQ(y->get_shape(), array_mml<size_t>({64, 64}));
+  EXPECT_FLOAT_EQ((*y)[4095], std::tanh(1.0f));
+  EXPECT_GT(model.getMemoryPlan()->getPeakBytes(), peak_bytes);
+}
+
+TEST(test_memory_planner, test_concurrent_inferences) {
+  std::unordered_map<std::string, GeneralDataTypes> weights;
+  Model model({std::make_shared<ReLUNode>("X", "a"),
+               std::make_shared<TanHNode>("a", "b"),
+               std::make_shared<ReLUNode>("b", "Y")},
+              weights, {"X"}, {"Y"});
+
+  // Every thread alternates between two input shapes, so the memory plan is
+  // redone while other inferences run from an arena
+  std::vector<std::thread> threads;
+  std::atomic<int> failures = 0;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&model, &failures, t] {
+      for (int i = 0; i < 20; i++) {
+        size_t size = (i + t) % 2 == 0 ? 8 : 32;
+        float value = static_cast<float>(t + 1) / 4;
+        auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+        x->fill(value);
+        auto y = std::get<std::shared_ptr<Tensor<float>>>(
+            model.infer({{"X", x}}).at("Y"));
+        for (size_t j = 0; j < size; j++) {
+          if (std::abs((*y)[j] - std::tanh(value)) > 1e-6f) failures++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_EQ(failures, 0);
+}
@@ -96,6 +96,17 @@ TEST(test_mml_arithmetic, test_elementwise) {
   ASSERT_EQ(*b, *c);
 }
 
+TEST(test_mml_arithmetic, test_elementwise_resizes_output) {
+  const std::shared_ptr<Tensor<float>> a = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 2}, array_mml<float>{1.0f, 2.0f, 3.0f, 4.0f});
+  const std::shared_ptr<Tensor<float>> b =
+      std::make_shared<Tensor<float>>(array_mml<size_t>{1});
+  const std::shared_ptr<Tensor<float>> c = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 2}, array_mml<float>{1.0f, 4.0f, 9.0f, 16.0f});
+  TensorOperations<float>::elementwise(a, square, b);
+  ASSERT_EQ(*b, *c);
+}
+
 TEST(test_mml_arithmetic, test_elementwise_in_place) {
   const std::shared_ptr<Tensor<float>> a = std::make_shared<Tensor<float>>(
       array_mml<size_t>{3, 3},
@@ -125,6 +136,111 @@ TEST(test_mml_arithmetic, test_elementwise_in_place_many_dimensions_4D) {
   ASSERT_EQ(*a, *b);
 }
 
+TEST(test_mml_arithmetic, test_elementwise_chunked_functor) {
+  // Odd sizes leave a tail after the vector registers are filled
+  for (size_t size : {1, 7, 17, 1000, 100003}) {
+    auto a = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+    for (size_t i = 0; i < size; i++) {
+      (*a)[i] = static_cast<float>(i % 13) - 6.5f;
+    }
+    auto relu = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+    auto leaky = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+    TensorOperations<float>::elementwise(a, ReluOp{}, relu);
+    TensorOperations<float>::elementwise(a, LeakyReluOp{0.1f}, leaky);
+
+    for (size_t i = 0; i < size; i++) {
+      float x = (*a)[i];
+      ASSERT_FLOAT_EQ((*relu)[i], x > 0 ? x : 0.0f);
+      ASSERT_FLOAT_EQ((*leaky)[i], x < 0 ? 0.1f * x : x);
+    }
+
+    TensorOperations<float>::elementwise_in_place(a, ReluOp{});
+    ASSERT_EQ(*a, *relu);
+  }
+}
+
+TEST(test_mml_arithmetic, test_elementwise_functor_integer) {
+  const std::shared_ptr<Tensor<int32_t>> a = std::make_shared<Tensor<int32_t>>(
+      array_mml<size_t>{2, 3}, array_mml<int32_t>{-3, 2, 0, -1, 5, -7});
+  const std::shared_ptr<Tensor<int32_t>> b = std::make_shared<Tensor<int32_t>>(
+      array_mml<size_t>{2, 3}, array_mml<int32_t>{0, 2, 0, 0, 5, 0});
+  TensorOperations<int32_t>::elementwise_in_place(a, ReluOp{});
+  ASSERT_EQ(*a, *b);
+}
+
+// Reference broadcast through the checked multi-index access
+template <typename F>
+std::shared_ptr<Tensor<float>> naive_broadcast(const Tensor<float> &a,
+                                               const Tensor<float> &b, F f) {
+  Shape shape =
+      TensorOperations<float>::broadcast_shape(a.get_shape(), b.get_shape());
+  auto c = std::make_shared<Tensor<float>>(shape);
+  Shape index(shape.size());
+  for (size_t flat = 0; flat < c->get_size(); flat++) {
+    size_t remaining = flat;
+    for (size_t d = shape.size(); d-- > 0;) {
+      index[d] = remaining % shape[d];
+      remaining /= shape[d];
+    }
+    auto input_index = [&](const Shape &input_shape) {
+      Shape result(input_shape.size());
+      for (size_t d = 0; d < input_shape.size(); d++) {
+        size_t out_d = d + shape.size() - input_shape.size();
+        result[d] = input_shape[d] == 1 ? 0 : index[out_d];
+      }
+      return result;
+    };
+    (*c)[flat] =
+        f(a[input_index(a.get_shape())], b[input_index(b.get_shape())]);
+  }
+  return c;
+}
+
+TEST(test_mml_arithmetic, test_broadcast_shapes) {
+  const std::vector<std::pair<Shape, Shape>> cases = {
+      {{2, 3, 4}, {2, 3, 4}},     {{2, 3, 4}, {1}},
+      {{1}, {2, 3, 4}},           {{2, 3, 5, 7}, {3, 1, 1}},
+      {{3, 1}, {1, 4}},           {{2, 1, 4}, {3, 1}},
+      {{5, 1, 3, 1}, {1, 2, 1, 6}}, {{4, 6}, {6}}};
+  for (const auto &[a_shape, b_shape] : cases) {
+    auto a = std::make_shared<Tensor<float>>(a_shape);
+    auto b = std::make_shared<Tensor<float>>(b_shape);
+    for (size_t i = 0; i < a->get_size(); i++) (*a)[i] = i * 0.5f + 1;
+    for (size_t i = 0; i < b->get_size(); i++) (*b)[i] = i * 0.25f + 2;
+
+    auto c = std::make_shared<Tensor<float>>(Shape{1});
+    TensorOperations<float>::broadcast(a, b, AddOp{}, c);
+    ASSERT_EQ(*c, *naive_broadcast(*a, *b, AddOp{})) << a_shape << b_shape;
+    TensorOperations<float>::broadcast(a, b, SubOp{}, c);
+    ASSERT_EQ(*c, *naive_broadcast(*a, *b, SubOp{})) << a_shape << b_shape;
+    TensorOperations<float>::broadcast(a, b, DivOp{}, c);
+    ASSERT_EQ(*c, *naive_broadcast(*a, *b, DivOp{})) << a_shape << b_shape;
+    TensorOperations<float>::broadcast(a, b, MaxOp{}, c);
+    ASSERT_EQ(*c, *naive_broadcast(*a, *b, MaxOp{})) << a_shape << b_shape;
+  }
+}
+
+TEST(test_mml_arithmetic, test_broadcast_bias_in_place) {
+  // A bias along the channels of an NCHW tensor, large enough to be split
+  // across the threads in the middle of a plane
+  auto x = std::make_shared<Tensor<float>>(Shape{3, 16, 33, 35});
+  auto bias = std::make_shared<Tensor<float>>(Shape{16, 1, 1});
+  for (size_t i = 0; i < x->get_size(); i++) (*x)[i] = i % 97;
+  for (size_t i = 0; i < bias->get_size(); i++) (*bias)[i] = i * 1000.0f;
+
+  auto expected = naive_broadcast(*x, *bias, MulOp{});
+  TensorOperations<float>::broadcast(x, bias, MulOp{}, x);
+  ASSERT_EQ(*x, *expected);
+}
+
+TEST(test_mml_arithmetic, test_broadcast_incompatible) {
+  auto a = std::make_shared<Tensor<float>>(Shape{2, 3});
+  auto b = std::make_shared<Tensor<float>>(Shape{4});
+  auto c = std::make_shared<Tensor<float>>(Shape{2, 3});
+  EXPECT_THROW(TensorOperations<float>::broadcast(a, b, AddOp{}, c),
+               std::invalid_argument);
+}
+
 TEST(test_mml_arithmetic, test_argmax_1) {
   const std::shared_ptr<Tensor<float>> a = std::make_shared<Tensor<float>>(
       array_mml<size_t>{2, 3},
@@ -157,3 +273,170 @@ TEST(test_mml_arithmetic, test_argmax_4) {
   const int expected_index = 5;
   ASSERT_EQ(TensorOperations<float>::arg_max(a), expected_index);
 }
+
+// Reference reduction walking every input element once
+std::shared_ptr<Tensor<double>> naive_reduce(const Tensor<float> &a,
+                                             const std::vector<int> &axes,
+                                             bool take_max) {
+  const Shape &shape = a.get_shape();
+  Shape out_shape = shape;
+  for (int axis : axes) out_shape[axis] = 1;
+  auto out = std::make_shared<Tensor<double>>(out_shape);
+  for (size_t i = 0; i < out->get_size(); i++) {
+    (*out)[i] = take_max ? -INFINITY : 0;
+  }
+  for (size_t flat = 0; flat < a.get_size(); flat++) {
+    size_t remaining = flat;
+    size_t out_flat = 0;
+    size_t out_stride = 1;
+    for (size_t d = shape.size(); d-- > 0;) {
+      size_t index = remaining % shape[d];
+      remaining /= shape[d];
+      out_flat += (out_shape[d] == 1 ? 0 : index) * out_stride;
+      out_stride *= out_shape[d];
+    }
+    double &dst = (*out)[out_flat];
+    dst = take_max ? std::max(dst, static_cast<double>(a[flat]))
+                   : dst + a[flat];
+  }
+  return out;
+}
+
+TEST(test_mml_arithmetic, test_reduce_axes) {
+  auto a = std::make_shared<Tensor<float>>(Shape{3, 4, 5, 6});
+  for (size_t i = 0; i < a->get_size(); i++) {
+    (*a)[i] = static_cast<float>((i * 37) % 101) - 50;
+  }
+
+  const std::vector<std::vector<int>> cases = {
+      {0}, {1}, {3}, {-1}, {0, 2}, {1, 2}, {1, 3}, {0, 1, 2, 3}};
+  for (const auto &axes : cases) {
+    std::vector<int> positive;
+    for (int axis : axes) positive.push_back(axis < 0 ? axis + 4 : axis);
+    auto sums = naive_reduce(*a, positive, false);
+    auto maxes = naive_reduce(*a, positive, true);
+    const size_t count = a->get_size() / sums->get_size();
+
+    auto sum = TensorOperations<float>::sum(a, axes, true);
+    auto mean = TensorOperations<float>::mean(a, axes, true);
+    auto max = TensorOperations<float>::max(a, axes, true);
+    auto min = TensorOperations<float>::min(a, axes, true);
+    ASSERT_EQ(sum->get_shape(), sums->get_shape());
+    for (size_t i = 0; i < sums->get_size(); i++) {
+      ASSERT_FLOAT_EQ((*sum)[i], (*sums)[i]);
+      ASSERT_FLOAT_EQ((*mean)[i], (*sums)[i] / count);
+      ASSERT_EQ((*max)[i], (*maxes)[i]);
+    }
+
+    // min(a) is -max(-a)
+    auto negated = std::make_shared<Tensor<float>>(*a);
+    TensorOperations<float>::elementwise_in_place(
+        negated, [](float x) { return -x; });
+    auto negated_max = TensorOperations<float>::max(negated, axes, true);
+    for (size_t i = 0; i < min->get_size(); i++) {
+      ASSERT_EQ((*min)[i], -(*negated_max)[i]);
+    }
+  }
+
+  // Without keep_dims the reduced axes are dropped
+  ASSERT_EQ(TensorOperations<float>::sum(a, {1, 3})->get_shape(),
+            (Shape{3, 5}));
+  ASSERT_EQ(TensorOperations<float>::sum(a)->get_shape(), (Shape{1}));
+  EXPECT_THROW(TensorOperations<float>::sum(a, {4}), std::invalid_argument);
+}
+
+TEST(test_mml_arithmetic, test_reduce_large_sum) {
+  // Long enough to be split into several blocks across the threads
+  const size_t size = 1000003;
+  auto a = std::make_shared<Tensor<int64_t>>(Shape{size});
+  for (size_t i = 0; i < size; i++) (*a)[i] = static_cast<int64_t>(i % 1000);
+  int64_t expected = 0;
+  for (size_t i = 0; i < size; i++) expected += (*a)[i];
+
+  ASSERT_EQ((*TensorOperations<int64_t>::sum(a))[0], expected);
+  ASSERT_EQ((*TensorOperations<int64_t>::max(a))[0], 999);
+  ASSERT_EQ((*TensorOperations<int64_t>::mean(a))[0],
+            expected / static_cast<int64_t>(size));
+}
+
+TEST(test_mml_arithmetic, test_argmax_axis) {
+  auto a = std::make_shared<Tensor<float>>(
+      Shape{2, 3, 2}, array_mml<float>{1, 9, 4, 9, 4, 0,   //
+                                       7, 2, 7, 3, 6, 5});
+  auto last = TensorOperations<float>::arg_max(a, -1);
+  ASSERT_EQ(last->get_shape(), (Shape{2, 3}));
+  ASSERT_EQ(*last, Tensor<int64_t>(Shape{2, 3},
+                                   array_mml<int64_t>{1, 1, 0, 0, 0, 0}));
+
+  // Ties resolve to the first index
+  auto middle = TensorOperations<float>::arg_max(a, 1, true);
+  ASSERT_EQ(middle->get_shape(), (Shape{2, 1, 2}));
+  ASSERT_EQ(*middle,
+            Tensor<int64_t>(Shape{2, 1, 2}, array_mml<int64_t>{1, 0, 0, 2}));
+}
+
+TEST(test_mml_arithmetic, test_argmax_large) {
+  const size_t size = 300007;
+  auto a = std::make_shared<Tensor<float>>(Shape{size});
+  for (size_t i = 0; i < size; i++) (*a)[i] = static_cast<float>(i % 5000);
+  (*a)[123456] = 1e6f;
+  (*a)[234567] = 1e6f;
+  ASSERT_EQ(TensorOperations<float>::arg_max(a), 123456);
+}
+
+TEST(test_mml_arithmetic, test_argmax_and_top_k_rank_nan_first) {
+  auto a = std::make_shared<Tensor<float>>(
+      Shape{2, 3}, array_mml<float>{1, NAN, 5,  //
+                                    NAN, 7, NAN});
+  ASSERT_EQ(TensorOperations<float>::arg_max(a), 1);
+  ASSERT_EQ(*TensorOperations<float>::arg_max(a, 1),
+            Tensor<int64_t>(Shape{2}, array_mml<int64_t>{1, 0}));
+  ASSERT_EQ(*TensorOperations<float>::arg_max(a, 0),
+            Tensor<int64_t>(Shape{3}, array_mml<int64_t>{1, 0, 1}));
+
+  auto [values, indices] = TensorOperations<float>::top_k(a, 2);
+  ASSERT_EQ(*indices, Tensor<int64_t>(Shape{2, 2},
+                                      array_mml<int64_t>{1, 2, 0, 2}));
+  EXPECT_TRUE(std::isnan((*values)[2]));
+  EXPECT_EQ((*values)[1], 5);
+}
+
+TEST(test_mml_arithmetic, test_top_k) {
+  auto a = std::make_shared<Tensor<float>>(
+      Shape{2, 5}, array_mml<float>{3, 1, 4, 1, 5,  //
+                                    9, 2, 6, 5, 6});
+  auto [values, indices] = TensorOperations<float>::top_k(a, 3);
+  ASSERT_EQ(*values, Tensor<float>(Shape{2, 3},
+                                   array_mml<float>{5, 4, 3, 9, 6, 6}));
+  ASSERT_EQ(*indices, Tensor<int64_t>(Shape{2, 3},
+                                      array_mml<int64_t>{4, 2, 0, 0, 2, 4}));
+
+  auto [column_values, column_indices] =
+      TensorOperations<float>::top_k(a, 1, 0);
+  ASSERT_EQ(*column_values,
+            Tensor<float>(Shape{1, 5}, array_mml<float>{9, 2, 6, 5, 6}));
+  ASSERT_EQ(*column_indices,
+            Tensor<int64_t>(Shape{1, 5}, array_mml<int64_t>{1, 1, 1, 1, 1}));
+  EXPECT_THROW(TensorOperations<float>::top_k(a, 6), std::invalid_argument);
+}
+
+TEST(test_mml_arithmetic, test_all_close_and_equals) {
+  const size_t size = 200000;
+  auto a = std::make_shared<Tensor<float>>(Shape{size});
+  for (size_t i = 0; i < size; i++) (*a)[i] = static_cast<float>(i);
+  auto b = std::make_shared<Tensor<float>>(*a);
+
+  ASSERT_TRUE(TensorOperations<float>::equals(a, b));
+  ASSERT_TRUE(TensorOperations<float>::all_close(a, b));
+
+  (*b)[size - 3] += 0.5f;
+  ASSERT_FALSE(TensorOperations<float>::equals(a, b));
+  ASSERT_TRUE(TensorOperations<float>::all_close(a, b, 0, 1));
+  ASSERT_FALSE(TensorOperations<float>::all_close(a, b, 0, 0.1));
+
+  (*b)[7] = NAN;
+  ASSERT_FALSE(TensorOperations<float>::all_close(a, b, 1, 1));
+
+  auto reshaped = std::make_shared<Tensor<float>>(Shape{2, size / 2});
+  ASSERT_FALSE(TensorOperations<float>::all_close(a, reshaped));
+}
@@ -47,7 +47,8 @@ TEST(test_mml_gemm, test_transpose) {
   auto d = std::make_shared<Tensor<int>>(array_mml<size_t>{2, 2},
                                          array_mml<int>{14, 32, 32, 77});
 
-  TensorOperations<int>::gemm(0, 1, 2, 2, 3, alpha, beta, a, 3, b, 2, c, 2);
+  // B is read in place, so ldb is the row stride of B as stored
+  TensorOperations<int>::gemm(0, 1, 2, 2, 3, alpha, beta, a, 3, b, 3, c, 2);
   ASSERT_EQ((*c), (*d));
 }
 
@@ -143,3 +144,428 @@ TEST(test_mml_gemm, gemm_1000x1000_float) {
   ASSERT_TRUE(1);  // This test is here to be able to check the time it takes
                    // for different GEMM inplementations
 }
+
+TEST(test_mml_gemm, gemm_multithreaded_matches_single_thread) {
+  // Sizes that do not divide evenly into the chunks of the threads
+  array_mml<float> a_data = ArrayUtils::generate_random_array_mml_real<float>(
+      200 * 150, 200 * 150, 0, 10);
+  array_mml<float> b_data = ArrayUtils::generate_random_array_mml_real<float>(
+      150 * 170, 150 * 170, 0, 10);
+
+  auto a = std::make_shared<Tensor<float>>(array_mml<size_t>{200, 150}, a_data);
+  auto b = std::make_shared<Tensor<float>>(array_mml<size_t>{150, 170}, b_data);
+  auto c_single = std::make_shared<Tensor<float>>(array_mml<size_t>{200, 170});
+  auto c_multi = std::make_shared<Tensor<float>>(array_mml<size_t>{200, 170});
+
+  size_t previous_threads = Parallel::get_num_threads();
+
+  Parallel::set_num_threads(1);
+  TensorOperations<float>::gemm(0, 0, 200, 170, 150, 1, 0, a, 150, b, 170,
+                                c_single, 170);
+
+  Parallel::set_num_threads(4);
+  TensorOperations<float>::gemm(0, 0, 200, 170, 150, 1, 0, a, 150, b, 170,
+                                c_multi, 170);
+
+  Parallel::set_num_threads(previous_threads);
+
+  // Backends like OpenBLAS may sum in a different order with more threads
+  for (size_t i = 0; i < c_single->get_size(); i++) {
+    EXPECT_NEAR((*c_single)[i], (*c_multi)[i], 0.1f);
+  }
+}
+
+TEST(test_mml_gemm, gemm_partition_grid) {
+  size_t previous_threads = Parallel::get_num_threads();
+
+  Parallel::set_num_threads(1);
+  GemmPartition::Grid single = GemmPartition::grid(512, 512, 512, 1, 1);
+  EXPECT_EQ(single.row_parts * single.col_parts * single.k_parts, 1);
+
+  Parallel::set_num_threads(8);
+  // Plenty of rows are only split by rows
+  GemmPartition::Grid square = GemmPartition::grid(512, 512, 512, 1, 1);
+  EXPECT_EQ(square.row_parts, 16);
+  EXPECT_EQ(square.col_parts, 1);
+  EXPECT_EQ(square.k_parts, 1);
+
+  // A batch of one is split by columns, on whole steps
+  GemmPartition::Grid batch = GemmPartition::grid(1, 4096, 9216, 12, 32);
+  EXPECT_EQ(batch.row_parts, 1);
+  EXPECT_EQ(batch.col_parts, 16);
+  EXPECT_EQ(batch.k_parts, 1);
+
+  // A tiny C with a deep K is split by K
+  GemmPartition::Grid deep = GemmPartition::grid(2, 3, 100000, 1, 8);
+  EXPECT_EQ(deep.row_parts * deep.col_parts, 2);
+  EXPECT_EQ(deep.k_parts, 4);
+
+  // Too little work is not split at all
+  GemmPartition::Grid tiny = GemmPartition::grid(4, 4, 4, 1, 1);
+  EXPECT_EQ(tiny.row_parts * tiny.col_parts * tiny.k_parts, 1);
+
+  Parallel::set_num_threads(previous_threads);
+}
+
+TEST(test_mml_gemm, gemm_partitions_match_single_thread) {
+  // A batch of one, split by columns, and a tiny C with a deep K, split by
+  // K with its partial sums added in a fixed order
+  for (auto [M, N, K] : {std::tuple{1, 1000, 300}, std::tuple{2, 3, 100000},
+                         std::tuple{1, 1, 200000}}) {
+    array_mml<float> a_data = ArrayUtils::generate_random_array_mml_real<float>(
+        M * K, M * K, -1, 1);
+    array_mml<float> b_data = ArrayUtils::generate_random_array_mml_real<float>(
+        K * N, K * N, -1, 1);
+    array_mml<float> c_data = ArrayUtils::generate_random_array_mml_real<float>(
+        M * N, M * N, -1, 1);
+    Shape a_shape = {static_cast<size_t>(M), static_cast<size_t>(K)};
+    Shape b_shape = {static_cast<size_t>(K), static_cast<size_t>(N)};
+    Shape c_shape = {static_cast<size_t>(M), static_cast<size_t>(N)};
+
+    auto a = std::make_shared<Tensor<float>>(a_shape, a_data);
+    auto b = std::make_shared<Tensor<float>>(b_shape, b_data);
+    auto c_single = std::make_shared<Tensor<float>>(c_shape, c_data);
+    auto c_multi = std::make_shared<Tensor<float>>(c_shape, c_data);
+
+    size_t previous_threads = Parallel::get_num_threads();
+    Parallel::set_num_threads(1);
+    TensorOperations<float>::gemm(0, 0, M, N, K, 1.5f, 0.5f, a, K, b, N,
+                                  c_single, N);
+    Parallel::set_num_threads(8);
+    TensorOperations<float>::gemm(0, 0, M, N, K, 1.5f, 0.5f, a, K, b, N,
+                                  c_multi, N);
+    Parallel::set_num_threads(previous_threads);
+
+    for (size_t i = 0; i < c_single->get_size(); i++) {
+      ASSERT_NEAR((*c_single)[i], (*c_multi)[i], 1e-5f * K)
+          << M << "x" << N << "x" << K << " at " << i;
+    }
+  }
+}
+
+// Checks ALPHA * op(A) * op(B) + BETA * C against sums of the products in
+// long double, A and B are stored transposed for TA and TB
+template <typename T>
+void expect_gemm_matches_reference(int M, int N, int K, T alpha, T beta,
+                                   int TA = 0, int TB = 0) {
+  array_mml<T> a_data =
+      ArrayUtils::generate_random_array_mml_real<T>(M * K, M * K, -1, 1);
+  array_mml<T> b_data =
+      ArrayUtils::generate_random_array_mml_real<T>(K * N, K * N, -1, 1);
+  array_mml<T> c_data =
+      ArrayUtils::generate_random_array_mml_real<T>(M * N, M * N, -1, 1);
+
+  const size_t a_rows = TA ? K : M, a_cols = TA ? M : K;
+  const size_t b_rows = TB ? N : K, b_cols = TB ? K : N;
+  auto a = std::make_shared<Tensor<T>>(Shape{a_rows, a_cols}, a_data);
+  auto b = std::make_shared<Tensor<T>>(Shape{b_rows, b_cols}, b_data);
+  auto c = std::make_shared<Tensor<T>>(
+      Shape{static_cast<size_t>(M), static_cast<size_t>(N)}, c_data);
+
+  TensorOperations<T>::gemm(TA, TB, M, N, K, alpha, beta, a, a_cols, b,
+                            b_cols, c, N);
+
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      long double sum = 0;
+      for (int k = 0; k < K; k++) {
+        const T a_ik = TA ? a_data[k * M + i] : a_data[i * K + k];
+        const T b_kj = TB ? b_data[j * K + k] : b_data[k * N + j];
+        sum += static_cast<long double>(a_ik) * b_kj;
+      }
+      long double expected = alpha * sum + beta * c_data[i * N + j];
+      ASSERT_NEAR((*c)[i * N + j], static_cast<T>(expected), 1e-5 * K)
+          << M << "x" << N << "x" << K << " at " << i << ", " << j;
+    }
+  }
+}
+
+TEST(test_mml_gemm, gemm_edges_match_reference) {
+  // Fewer rows than a register tile, partial tiles in both directions, a
+  // depth over one packed block, more rows than a block of A and more
+  // columns than a block of B
+  for (float beta : {0.0f, 1.0f, 0.5f}) {
+    expect_gemm_matches_reference<float>(1, 100, 37, 2.0f, beta);
+    expect_gemm_matches_reference<float>(5, 33, 300, 1.0f, beta);
+    expect_gemm_matches_reference<float>(13, 45, 7, 1.0f, beta);
+    expect_gemm_matches_reference<float>(150, 70, 520, -1.5f, beta);
+    expect_gemm_matches_reference<float>(20, 4100, 3, 1.0f, beta);
+  }
+  expect_gemm_matches_reference<double>(1, 37, 11, 1.0, 0.0);
+  expect_gemm_matches_reference<double>(150, 70, 300, 0.5, 2.0);
+}
+
+TEST(test_mml_gemm, gemm_conv_shape_matches_reference) {
+  // The im2col GEMM of a 3x3 convolution with 256 inputs and 384 outputs on a
+  // 13x13 image
+  expect_gemm_matches_reference<float>(384, 169, 2304, 1.0f, 0.0f);
+}
+
+TEST(test_mml_gemm, gemm_transposed_operands_match_reference) {
+  // Rows of a transposed B as dot products for a batch of one, and every
+  // combination through the packing, with edge tiles and a K over one block
+  for (int TA : {0, 1}) {
+    for (int TB : {0, 1}) {
+      SCOPED_TRACE(testing::Message() << "TA " << TA << ", TB " << TB);
+      expect_gemm_matches_reference<float>(1, 1000, 300, 1.0f, 0.0f, TA, TB);
+      expect_gemm_matches_reference<float>(3, 37, 13, 2.0f, 0.5f, TA, TB);
+      expect_gemm_matches_reference<float>(150, 70, 520, -1.5f, 1.0f, TA, TB);
+      expect_gemm_matches_reference<double>(30, 20, 7, 0.5, 2.0, TA, TB);
+    }
+  }
+}
+
+TEST(test_mml_gemm, gemm_honours_leading_dimensions) {
+  // Every matrix is the corner of a wider one, whose other columns are left
+  // alone
+  const int M = 37, N = 45, K = 29;
+  for (int TB : {0, 1}) {
+    const int b_rows = TB ? N : K, b_cols = TB ? K : N;
+    const int lda = K + 3, ldb = b_cols + 2, ldc = N + 5;
+    auto a = std::make_shared<Tensor<float>>(
+        Shape{M, static_cast<size_t>(lda)},
+        ArrayUtils::generate_random_array_mml_real<float>(M * lda, M * lda,
+                                                          -1, 1));
+    auto b = std::make_shared<Tensor<float>>(
+        Shape{static_cast<size_t>(b_rows), static_cast<size_t>(ldb)},
+        ArrayUtils::generate_random_array_mml_real<float>(
+            b_rows * ldb, b_rows * ldb, -1, 1));
+    auto c =
+        std::make_shared<Tensor<float>>(Shape{M, static_cast<size_t>(ldc)});
+    c->fill(7.0f);
+
+    TensorOperations<float>::gemm(0, TB, M, N, K, 1.0f, 0.5f, a, lda, b, ldb,
+                                  c, ldc);
+
+    for (int i = 0; i < M; i++) {
+      for (int j = 0; j < ldc; j++) {
+        float expected = 7.0f;
+        if (j < N) {
+          double sum = 0;
+          for (int k = 0; k < K; k++) {
+            sum += (*a)[i * lda + k] * (*b)[TB ? j * ldb + k : k * ldb + j];
+          }
+          expected = static_cast<float>(sum + 0.5 * 7.0);
+        }
+        ASSERT_NEAR((*c)[i * ldc + j], expected, 1e-4f)
+            << "TB " << TB << " at " << i << ", " << j;
+      }
+    }
+  }
+}
+
+TEST(test_mml_gemm, gemm_transposed_int_matches_plain) {
+  const int M = 5, N = 21, K = 9;
+  auto a = std::make_shared<Tensor<int>>(Shape{M, K});
+  auto a_t = std::make_shared<Tensor<int>>(Shape{K, M});
+  auto b = std::make_shared<Tensor<int>>(Shape{K, N});
+  auto b_t = std::make_shared<Tensor<int>>(Shape{N, K});
+  for (int i = 0; i < M; i++) {
+    for (int k = 0; k < K; k++) {
+      (*a)[i * K + k] = (*a_t)[k * M + i] = (i * 7 + k * 3) % 11 - 5;
+    }
+  }
+  for (int k = 0; k < K; k++) {
+    for (int j = 0; j < N; j++) {
+      (*b)[k * N + j] = (*b_t)[j * K + k] = (k * 5 + j) % 13 - 6;
+    }
+  }
+
+  auto expected = std::make_shared<Tensor<int>>(Shape{M, N});
+  TensorOperations<int>::gemm(0, 0, M, N, K, 2, 0, a, K, b, N, expected, N);
+  for (int TA : {0, 1}) {
+    for (int TB : {0, 1}) {
+      auto c = std::make_shared<Tensor<int>>(Shape{M, N});
+      TensorOperations<int>::gemm(TA, TB, M, N, K, 2, 0, TA ? a_t : a,
+                                  TA ? M : K, TB ? b_t : b, TB ? K : N, c, N);
+      EXPECT_EQ(*c, *expected) << "TA " << TA << ", TB " << TB;
+    }
+  }
+}
+
+TEST(test_mml_gemm, gemm_every_supported_isa_matches_reference) {
+  // Only the dispatch build changes its kernels, the others run theirs for
+  // every instruction set
+  const CpuFeatures::Isa previous = CpuFeatures::get_isa();
+  const int supported = static_cast<int>(CpuFeatures::get_supported());
+  for (int i = 0; i <= supported; i++) {
+    const auto isa = static_cast<CpuFeatures::Isa>(i);
+    SCOPED_TRACE(CpuFeatures::to_string(isa));
+    CpuFeatures::set_isa(isa);
+    EXPECT_EQ(CpuFeatures::get_isa(), isa);
+    expect_gemm_matches_reference<float>(13, 45, 300, 1.0f, 0.5f);
+    expect_gemm_matches_reference<float>(2, 45, 300, 1.0f, 0.5f, 1, 1);
+    expect_gemm_matches_reference<double>(30, 20, 7, -1.5, 0.0, 0, 1);
+  }
+  CpuFeatures::set_isa(previous);
+}
+
+TEST(test_mml_gemm, cpu_features_names_and_limits) {
+  for (auto isa : {CpuFeatures::Isa::SCALAR, CpuFeatures::Isa::AVX2,
+                   CpuFeatures::Isa::AVX512}) {
+    EXPECT_EQ(CpuFeatures::from_string(CpuFeatures::to_string(isa)), isa);
+  }
+  EXPECT_THROW(CpuFeatures::from_string("sse9"), std::invalid_argument);
+  EXPECT_LE(CpuFeatures::get_isa(), CpuFeatures::get_supported());
+  if (CpuFeatures::get_supported() != CpuFeatures::Isa::AVX512) {
+    EXPECT_THROW(CpuFeatures::set_isa(CpuFeatures::Isa::AVX512),
+                 std::invalid_argument);
+  }
+}
+
+// Checks gemm_half against the float GEMM on the widened weights
+template <typename W>
+void expect_gemm_half_matches(int M, int N, int K, bool transposed) {
+  array_mml<float> a_data =
+      ArrayUtils::generate_random_array_mml_real<float>(M * K, M * K, -1, 1);
+  array_mml<float> b_data =
+      ArrayUtils::generate_random_array_mml_real<float>(K * N, K * N, -1, 1);
+  Shape b_shape = transposed ? Shape{static_cast<size_t>(N),
+                                     static_cast<size_t>(K)}
+                             : Shape{static_cast<size_t>(K),
+                                     static_cast<size_t>(N)};
+
+  auto a = std::make_shared<Tensor<float>>(
+      Shape{static_cast<size_t>(M), static_cast<size_t>(K)}, a_data);
+  auto b = std::make_shared<Tensor<W>>(b_shape);
+  auto b_float = std::make_shared<Tensor<float>>(b_shape);
+  for (size_t i = 0; i < b->get_size(); i++) {
+    (*b)[i] = b_data[i];
+    (*b_float)[i] = static_cast<float>((*b)[i]);
+  }
+
+  Shape c_shape = {static_cast<size_t>(M), static_cast<size_t>(N)};
+  auto expected = std::make_shared<Tensor<float>>(c_shape);
+  auto result = std::make_shared<Tensor<float>>(c_shape);
+  expected->fill(1.0f);
+  result->fill(1.0f);
+
+  TensorOperations<float>::gemm(0, transposed ? 1 : 0, M, N, K, 2.0f, 0.5f, a,
+                                K, b_float, transposed ? K : N, expected, N);
+  TensorOperations<float>::gemm_half<W>(transposed ? 1 : 0, M, N, K, 2.0f,
+                                        0.5f, a, K, b, transposed ? K : N,
+                                        result, N);
+
+  for (size_t i = 0; i < result->get_size(); i++) {
+    ASSERT_NEAR((*result)[i], (*expected)[i], 1e-4f * K)
+        << M << "x" << N << "x" << K << " at " << i;
+  }
+}
+
+TEST(test_mml_gemm, gemm_half_matches_float) {
+  for (bool transposed : {false, true}) {
+    // A batch of one, tiles that do not divide N, and more rows
+    expect_gemm_half_matches<fp16_t>(1, 300, 257, transposed);
+    expect_gemm_half_matches<fp16_t>(3, 45, 77, transposed);
+    expect_gemm_half_matches<fp16_t>(17, 7, 5, transposed);
+    expect_gemm_half_matches<bf16_t>(1, 300, 257, transposed);
+    expect_gemm_half_matches<bf16_t>(3, 45, 77, transposed);
+  }
+}
+
+TEST(test_mml_gemm, gemm_half_check_matrix_match) {
+  auto a = std::make_shared<Tensor<float>>(Shape{2, 3});
+  auto b = std::make_shared<Tensor<fp16_t>>(Shape{3, 2});
+  auto c = std::make_shared<Tensor<float>>(Shape{2, 2});
+  ASSERT_THROW(TensorOperations<float>::gemm_half<fp16_t>(0, 2, 4, 3, 1, 0, a,
+                                                          3, b, 2, c, 2),
+               std::invalid_argument);
+}
+
+// Reference int8 GEMM summing every product one at a time
+template <typename TA>
+std::vector<int32_t> naive_gemm_int8(const Tensor<TA> &a,
+                                     const Tensor<int8_t> &b, int M, int N,
+                                     int K, bool transposed) {
+  std::vector<int32_t> c(M * N, 0);
+  for (int i = 0; i < M; i++) {
+    for (int j = 0; j < N; j++) {
+      for (int k = 0; k < K; k++) {
+        int8_t weight = transposed ? b[j * K + k] : b[k * N + j];
+        c[i * N + j] += static_cast<int32_t>(a[i * K + k]) * weight;
+      }
+    }
+  }
+  return c;
+}
+
+template <typename TA>
+void expect_gemm_int8_matches(int M, int N, int K, bool transposed) {
+  auto a = std::make_shared<Tensor<TA>>(
+      Shape{static_cast<size_t>(M), static_cast<size_t>(K)});
+  auto b = std::make_shared<Tensor<int8_t>>(
+      transposed ? Shape{static_cast<size_t>(N), static_cast<size_t>(K)}
+                 : Shape{static_cast<size_t>(K), static_cast<size_t>(N)});
+  // The whole range of both types, including -128 and 255
+  for (size_t i = 0; i < a->get_size(); i++) {
+    (*a)[i] = static_cast<TA>((i * 97 + 13) % 256);
+  }
+  for (size_t i = 0; i < b->get_size(); i++) {
+    (*b)[i] = static_cast<int8_t>((i * 61 + 7) % 256);
+  }
+
+  auto c = std::make_shared<Tensor<int32_t>>(
+      Shape{static_cast<size_t>(M), static_cast<size_t>(N)});
+  TensorOperations<int32_t>::gemm_int8<TA>(transposed ? 1 : 0, M, N, K, a, K,
+                                           b, transposed ? K : N, c, N);
+
+  auto expected = naive_gemm_int8(*a, *b, M, N, K, transposed);
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_EQ((*c)[i], expected[i])
+        << M << "x" << N << "x" << K << " at " << i;
+  }
+}
+
+TEST(test_mml_gemm, gemm_int8_matches_reference) {
+  for (bool transposed : {false, true}) {
+    // K below, at and past the vector widths, N not a multiple of 4
+    expect_gemm_int8_matches<uint8_t>(1, 33, 200, transposed);
+    expect_gemm_int8_matches<uint8_t>(5, 8, 64, transposed);
+    expect_gemm_int8_matches<uint8_t>(3, 6, 5, transposed);
+    expect_gemm_int8_matches<int8_t>(1, 33, 200, transposed);
+    expect_gemm_int8_matches<int8_t>(7, 10, 131, transposed);
+    expect_gemm_int8_matches<int8_t>(3, 6, 5, transposed);
+  }
+}
+
+TEST(test_mml_gemm, gemm_int8_requantization) {
+  const int M = 3;
+  const int N = 5;
+  const int K = 70;
+  auto a = std::make_shared<Tensor<uint8_t>>(Shape{M, K});
+  auto b = std::make_shared<Tensor<int8_t>>(Shape{N, K});
+  for (size_t i = 0; i < a->get_size(); i++) (*a)[i] = (i * 7) % 256;
+  for (size_t i = 0; i < b->get_size(); i++) {
+    (*b)[i] = static_cast<int8_t>((i * 11) % 256);
+  }
+  auto accumulators = naive_gemm_int8(*a, *b, M, N, K, true);
+
+  Requantization per_tensor{{0.001f}, {}, 3};
+  auto c = std::make_shared<Tensor<int8_t>>(Shape{M, N});
+  TensorOperations<int8_t>::gemm_int8<uint8_t>(1, M, N, K, a, K, b, K,
+                                               per_tensor, c, N);
+  for (size_t i = 0; i < c->get_size(); i++) {
+    float expected = std::nearbyint(accumulators[i] * 0.001f) + 3;
+    ASSERT_EQ((*c)[i], std::clamp(expected, -128.0f, 127.0f)) << i;
+  }
+
+  // A scale and a bias per column, saturating into uint8
+  Requantization per_column{{0.01f, 0.002f, 0.1f, 0.0005f, 1.0f},
+                            {100, -200, 0, 5000, 7},
+                            128};
+  auto u = std::make_shared<Tensor<uint8_t>>(Shape{M, N});
+  TensorOperations<uint8_t>::gemm_int8<uint8_t>(1, M, N, K, a, K, b, K,
+                                                per_column, u, N);
+  for (size_t i = 0; i < u->get_size(); i++) {
+    size_t j = i % N;
+    float expected = std::nearbyint((accumulators[i] + per_column.bias[j]) *
+                                    per_column.scales[j]) +
+                     128;
+    ASSERT_EQ((*u)[i], std::clamp(expected, 0.0f, 255.0f)) << i;
+  }
+
+  Requantization wrong_scales{{1.0f, 2.0f}, {}, 0};
+  EXPECT_THROW(TensorOperations<int8_t>::gemm_int8<uint8_t>(
+                   1, M, N, K, a, K, b, K, wrong_scales, c, N),
+               std::invalid_argument);
+}
@@ -629,4 +629,276 @@ TEST(test_mml_tensor, transpose_high_rank_dims) {
       array_mml<size_t>{3, 1, 2}, array_mml<int>{1, 4, 2, 5, 3, 6});
 
   ASSERT_EQ(*transposed, *expected);
-}
\ No newline at end of file
+}
+TEST(test_mml_tensor, shape_at_is_checked) {
+  const Shape shape{2, 3};
+  EXPECT_EQ(shape.at(1), 3);
+  EXPECT_THROW(shape.at(2), std::out_of_range);
+}
+
+TEST(test_mml_tensor, reshaped_shares_data) {
+  auto tensor = std::make_shared<Tensor<int>>(array_mml<size_t>{2, 3},
+                                              array_mml<int>{1, 2, 3, 4, 5, 6});
+
+  auto reshaped = tensor->reshaped({3, 2});
+
+  // The original tensor keeps its shape but shares the buffer
+  EXPECT_EQ(tensor->get_shape(), array_mml<size_t>({2, 3}));
+  EXPECT_EQ(reshaped->get_shape(), array_mml<size_t>({3, 2}));
+  EXPECT_EQ(reshaped->get_data().get(), tensor->get_data().get());
+
+  (*reshaped)[{2, 1}] = 42;
+  EXPECT_EQ(((*tensor)[{1, 2}]), 42);
+
+  EXPECT_THROW(tensor->reshaped({4, 2}), std::invalid_argument);
+}
+
+TEST(test_mml_tensor, const_reshaped_copies_on_write) {
+  auto tensor = std::make_shared<Tensor<int>>(array_mml<size_t>{2, 3},
+                                              array_mml<int>{1, 2, 3, 4, 5, 6});
+
+  auto reshaped = std::as_const(*tensor).reshaped({3, 2});
+  EXPECT_EQ(reshaped->get_shape(), array_mml<size_t>({3, 2}));
+  EXPECT_EQ((std::as_const(*reshaped)[{2, 1}]), 6);
+
+  // Writing to the reshaped tensor leaves the original untouched
+  (*reshaped)[{2, 1}] = 42;
+  EXPECT_EQ(((*tensor)[{1, 2}]), 6);
+  EXPECT_EQ(((*reshaped)[{2, 1}]), 42);
+
+  EXPECT_THROW(std::as_const(*tensor).reshaped({4, 2}), std::invalid_argument);
+}
+
+TEST(test_mml_tensor, span_matches_checked_access) {
+  auto tensor = std::make_shared<Tensor<int>>(
+      array_mml<size_t>{2, 3, 2},
+      array_mml<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+
+  auto span = tensor->get_span();
+  EXPECT_EQ(span.get_rank(), 3);
+  EXPECT_EQ(span.get_size(), 12);
+  EXPECT_EQ(span.get_shape(1), 3);
+  EXPECT_EQ(span.get_stride(0), 6);
+
+  for (size_t i = 0; i < 2; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      for (size_t k = 0; k < 2; k++) {
+        EXPECT_EQ(span(i, j, k), ((*tensor)[{i, j, k}]));
+      }
+    }
+  }
+
+  // Leading indices address the start of a contiguous run
+  EXPECT_EQ(&span(1, 2), &span[10]);
+
+  span(1, 0, 1) = 42;
+  EXPECT_EQ(((*tensor)[{1, 0, 1}]), 42);
+
+  auto sliced = tensor->slice({0});
+  EXPECT_THROW(sliced->get_span(), std::runtime_error);
+}
+
+TEST(test_mml_tensor, view_transpose_shares_data) {
+  auto tensor = std::make_shared<Tensor<int>>(
+      array_mml<size_t>{2, 3, 2},
+      array_mml<int>{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12});
+
+  auto view = tensor->view().transpose({2, 0, 1});
+  EXPECT_EQ(view.get_shape(), (array_mml<size_t>{2, 2, 3}));
+  EXPECT_EQ(view.get_strides(), (array_mml<size_t>{1, 6, 2}));
+  EXPECT_FALSE(view.is_contiguous());
+  EXPECT_EQ(view(1, 0, 2), ((*tensor)[{0, 2, 1}]));
+
+  view(1, 1, 0) = 42;
+  EXPECT_EQ(((*tensor)[{1, 0, 1}]), 42);
+
+  auto expected = tensor->transpose(std::vector<int>{2, 0, 1});
+  EXPECT_EQ(*view.to_tensor(), *expected);
+}
+
+TEST(test_mml_tensor, view_broadcast_has_zero_strides) {
+  // Shape: [3, 1] → Target: [2, 3, 2], the inner dimension is repeated
+  auto tensor = std::make_shared<Tensor<int>>(array_mml<size_t>{3, 1},
+                                              array_mml<int>{1, 2, 3});
+
+  auto view = tensor->view().broadcast({2, 3, 2});
+  EXPECT_EQ(view.get_strides(), (array_mml<size_t>{0, 1, 0}));
+  EXPECT_EQ(view.get_size(), 12);
+
+  auto expected = std::make_shared<Tensor<int>>(
+      array_mml<size_t>{2, 3, 2},
+      array_mml<int>{1, 1, 2, 2, 3, 3, 1, 1, 2, 2, 3, 3});
+  EXPECT_EQ(*view.to_tensor(), *expected);
+  EXPECT_EQ((*tensor->broadcast_reshape({2, 3, 2})), *expected);
+
+  EXPECT_THROW(tensor->view().broadcast({3, 2, 1}), std::invalid_argument);
+}
+
+TEST(test_mml_tensor, slice_shares_data) {
+  auto tensor = std::make_shared<Tensor<int>>(
+      array_mml<size_t>{2, 2, 2}, array_mml<int>{1, 2, 3, 4, 5, 6, 7, 8});
+
+  auto sliced = tensor->slice({1});
+  EXPECT_EQ(sliced->get_data().get(), tensor->get_data().get());
+  (*sliced)[{0, 1}] = 42;
+  EXPECT_EQ(((*tensor)[{1, 0, 1}]), 42);
+
+  auto batch = tensor->view().select(0, 1);
+  EXPECT_EQ(batch.get_data(), &((*tensor)[{1, 0, 0}]));
+  EXPECT_TRUE(batch.is_contiguous());
+  EXPECT_EQ(batch.slice(1, 1, 2)(1, 0), 8);
+}
+
+TEST(test_mml_tensor, copy_shares_data_until_written) {
+  auto tensor = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 2}, array_mml<float>{1.0f, 2.0f, 3.0f, 4.0f});
+  auto copy = tensor->copy();
+  EXPECT_EQ(std::as_const(*copy).get_data().get(),
+            std::as_const(*tensor).get_data().get());
+
+  (*copy)[{0, 1}] = 42.0f;
+  EXPECT_NE(std::as_const(*copy).get_data().get(),
+            std::as_const(*tensor).get_data().get());
+  EXPECT_EQ(((*tensor)[{0, 1}]), 2.0f);
+  EXPECT_EQ(((*copy)[{0, 1}]), 42.0f);
+
+  // Writing to the original leaves the copy untouched as well
+  auto second_copy = tensor->copy();
+  tensor->fill(0.0f);
+  EXPECT_EQ(((*second_copy)[{1, 1}]), 4.0f);
+}
+
+TEST(test_mml_tensor, copy_after_span_copies_data) {
+  auto tensor = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 2}, array_mml<float>{1.0f, 2.0f, 3.0f, 4.0f});
+  auto span = tensor->get_span();
+  auto copy = tensor->copy();
+  EXPECT_NE(std::as_const(*copy).get_data().get(),
+            std::as_const(*tensor).get_data().get());
+
+  // Writes through the span taken earlier only reach the original
+  span.get_data()[1] = 42.0f;
+  EXPECT_EQ(((*tensor)[{0, 1}]), 42.0f);
+  EXPECT_EQ(((*copy)[{0, 1}]), 2.0f);
+}
+
+TEST(test_mml_tensor, copy_of_shared_view_copies_data) {
+  auto tensor = std::make_shared<Tensor<float>>(
+      array_mml<size_t>{2, 2}, array_mml<float>{1.0f, 2.0f, 3.0f, 4.0f});
+  auto reshaped = tensor->reshaped({4});
+  auto copy = tensor->copy();
+  EXPECT_NE(std::as_const(*copy).get_data().get(),
+            std::as_const(*tensor).get_data().get());
+
+  (*reshaped)[1] = 42.0f;
+  EXPECT_EQ(((*tensor)[{0, 1}]), 42.0f);
+  EXPECT_EQ(((*copy)[{0, 1}]), 2.0f);
+}
+
+TEST(test_mml_tensor, shape_is_stored_inline) {
+  Shape shape = {2, 3};
+  shape.push_back(4);
+  EXPECT_EQ(shape.size(), 3);
+  EXPECT_EQ(shape.to_string(), "[2, 3, 4]");
+
+  // Shapes convert to and from array_mml and compare equal to it
+  array_mml<size_t> array = shape;
+  EXPECT_EQ(array, (array_mml<size_t>{2, 3, 4}));
+  EXPECT_EQ(Shape(array), shape);
+  EXPECT_EQ(shape, array);
+
+  Tensor<int> tensor(shape);
+  EXPECT_EQ(tensor.get_shape(), shape);
+  EXPECT_EQ(tensor.get_offsets(), (Shape{12, 4, 1}));
+  Shape indices = {1, 2, 3};
+  tensor[indices] = 7;
+  EXPECT_EQ(tensor[23], 7);
+
+  Shape full(MAX_TENSOR_RANK);
+  EXPECT_THROW(full.push_back(1), std::invalid_argument);
+}
+
+TEST(test_mml_tensor, uninitialized_constructor) {
+  Tensor<float> tensor(Shape{2, 3}, uninitialized);
+  EXPECT_EQ(tensor.get_shape(), (Shape{2, 3}));
+  EXPECT_EQ(tensor.get_offsets(), (Shape{3, 1}));
+  EXPECT_EQ(tensor.get_size(), 6);
+
+  // The elements are only defined once written
+  tensor.fill(1.5f);
+  EXPECT_EQ((tensor[{1, 2}]), 1.5f);
+}
+
+TEST(test_mml_tensor, half_conversions) {
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_EQ(fp16_t(1.0f).bits, 0x3C00);
+  EXPECT_EQ(fp16_t(-2.0f).bits, 0xC000);
+  EXPECT_EQ(fp16_t(65504.0f).bits, 0x7BFF);
+  EXPECT_EQ(fp16_t(65520.0f).bits, 0x7C00);
+  EXPECT_EQ(fp16_t(std::ldexp(1.0f, -24)).bits, 0x0001);
+  EXPECT_EQ(fp16_t(std::ldexp(1.0f, -26)).bits, 0x0000);
+  // 1 + 2^-11 is halfway between two halves and rounds to the even one
+  EXPECT_EQ(fp16_t(1.0f + std::ldexp(1.0f, -11)).bits, 0x3C00);
+  EXPECT_TRUE(std::isnan(static_cast<float>(fp16_t(NAN))));
+  EXPECT_EQ(static_cast<float>(fp16_t(-inf)), -inf);
+
+  EXPECT_EQ(bf16_t(1.0f).bits, 0x3F80);
+  EXPECT_EQ(bf16_t(1.0f + std::ldexp(1.0f, -8)).bits, 0x3F80);
+  EXPECT_EQ(bf16_t(1.0f + 3 * std::ldexp(1.0f, -8)).bits, 0x3F82);
+  EXPECT_TRUE(std::isnan(static_cast<float>(bf16_t(NAN))));
+
+  // Every half that is not NaN survives a round trip through float
+  for (uint32_t bits = 0; bits < 0x10000; bits++) {
+    float value = fp16_t::to_float(static_cast<uint16_t>(bits));
+    if (std::isnan(value)) continue;
+    ASSERT_EQ(fp16_t::from_float(value), bits);
+  }
+
+  // The array conversions, vectorised or not, give the scalar bits
+  const size_t count = 1003;
+  std::vector<float> values(count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = std::ldexp(static_cast<float>(i) * 0.37f - 150.0f,
+                           static_cast<int>(i % 41) - 20);
+  }
+  values[5] = NAN;
+  values[6] = inf;
+  values[7] = 1e6f;
+
+  std::vector<fp16_t> halves(count);
+  std::vector<bf16_t> bf16s(count);
+  std::vector<float> widened(count);
+  fp16_t::from_float(values.data(), halves.data(), count);
+  bf16_t::from_float(values.data(), bf16s.data(), count);
+  for (size_t i = 0; i < count; i++) {
+    if (std::isnan(values[i])) {
+      ASSERT_TRUE(std::isnan(static_cast<float>(halves[i])));
+      ASSERT_TRUE(std::isnan(static_cast<float>(bf16s[i])));
+      continue;
+    }
+    ASSERT_EQ(halves[i].bits, fp16_t::from_float(values[i])) << values[i];
+    ASSERT_EQ(bf16s[i].bits, bf16_t::from_float(values[i])) << values[i];
+  }
+
+  fp16_t::to_float(halves.data(), widened.data(), count);
+  for (size_t i = 0; i < count; i++) {
+    if (std::isnan(values[i])) continue;
+    ASSERT_EQ(widened[i], fp16_t::to_float(halves[i].bits));
+  }
+  bf16_t::to_float(bf16s.data(), widened.data(), count);
+  for (size_t i = 0; i < count; i++) {
+    if (std::isnan(values[i])) continue;
+    ASSERT_EQ(widened[i], bf16_t::to_float(bf16s[i].bits));
+  }
+}
+
+TEST(test_mml_tensor, half_tensor) {
+  Tensor<fp16_t> tensor(Shape{2, 3});
+  EXPECT_EQ(static_cast<float>(tensor[5]), 0.0f);
+  tensor[{1, 2}] = 2.5f;
+  EXPECT_EQ(static_cast<float>(tensor[5]), 2.5f);
+
+  auto transposed = tensor.transpose();
+  EXPECT_EQ(transposed->get_shape(), (Shape{3, 2}));
+  EXPECT_EQ(static_cast<float>((*transposed)[{2, 1}]), 2.5f);
+}
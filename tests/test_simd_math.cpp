@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <modularml>
+
+namespace {
+
+// Distance between a float result and the exact value, in units in the last
+// place of the exact value rounded to float
+double ulp_error(float result, double exact) {
+  float rounded = static_cast<float>(exact);
+  double ulp = std::nextafter(std::fabs(rounded),
+                              std::numeric_limits<float>::infinity()) -
+               static_cast<double>(std::fabs(rounded));
+  return std::fabs(result - exact) / ulp;
+}
+
+// Checks one function of the FAST tier over evenly spaced points in a range.
+// The odd count leaves a tail past the last full vector register.
+template <typename F, typename R>
+void expect_within_ulp(F f, R exact, float lo, float hi, double max_ulp) {
+  const size_t count = 100003;
+  std::vector<float> in(count);
+  std::vector<float> out(count);
+  for (size_t i = 0; i < count; i++) {
+    in[i] = lo + (hi - lo) * static_cast<float>(i) / (count - 1);
+  }
+
+  SimdMath::set_accuracy(MathAccuracy::FAST);
+  f(in.data(), out.data(), count);
+
+  double worst = 0;
+  float worst_at = 0;
+  for (size_t i = 0; i < count; i++) {
+    double error = ulp_error(out[i], exact(static_cast<double>(in[i])));
+    if (error > worst) {
+      worst = error;
+      worst_at = in[i];
+    }
+  }
+  EXPECT_LE(worst, max_ulp) << "at " << worst_at;
+}
+
+}  // namespace
+
+TEST(test_simd_math, test_exp_accuracy) {
+  expect_within_ulp(SimdMath::exp, [](double x) { return std::exp(x); },
+                    -87.0f, 88.5f, 1.1);
+}
+
+TEST(test_simd_math, test_log_accuracy) {
+  auto exact = [](double x) { return std::log(x); };
+  expect_within_ulp(SimdMath::log, exact, 1e-3f, 1e3f, 0.9);
+  expect_within_ulp(SimdMath::log, exact, 1e-30f, 1e30f, 0.9);
+  // Subnormal inputs
+  expect_within_ulp(SimdMath::log, exact, 1e-44f, 1e-38f, 0.9);
+}
+
+TEST(test_simd_math, test_tanh_accuracy) {
+  expect_within_ulp(SimdMath::tanh, [](double x) { return std::tanh(x); },
+                    -10.0f, 10.0f, 1.4);
+}
+
+TEST(test_simd_math, test_sigmoid_accuracy) {
+  expect_within_ulp(SimdMath::sigmoid,
+                    [](double x) { return 1 / (1 + std::exp(-x)); }, -80.0f,
+                    80.0f, 2.5);
+}
+
+TEST(test_simd_math, test_erf_accuracy) {
+  expect_within_ulp(SimdMath::erf, [](double x) { return std::erf(x); }, -5.0f,
+                    5.0f, 7.5);
+}
+
+TEST(test_simd_math, test_special_values) {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  float in[] = {nan, inf, -inf, 0.0f, -1.0f, -200.0f, 200.0f};
+  float out[7];
+
+  SimdMath::set_accuracy(MathAccuracy::FAST);
+
+  SimdMath::exp(in, out, 7);
+  EXPECT_TRUE(std::isnan(out[0]));
+  EXPECT_EQ(out[1], inf);
+  EXPECT_EQ(out[2], 0.0f);
+  EXPECT_EQ(out[3], 1.0f);
+  EXPECT_EQ(out[5], 0.0f);
+  EXPECT_EQ(out[6], inf);
+
+  SimdMath::log(in, out, 7);
+  EXPECT_TRUE(std::isnan(out[0]));
+  EXPECT_EQ(out[1], inf);
+  EXPECT_TRUE(std::isnan(out[2]));
+  EXPECT_EQ(out[3], -inf);
+  EXPECT_TRUE(std::isnan(out[4]));
+
+  SimdMath::tanh(in, out, 7);
+  EXPECT_TRUE(std::isnan(out[0]));
+  EXPECT_EQ(out[1], 1.0f);
+  EXPECT_EQ(out[2], -1.0f);
+  EXPECT_EQ(out[3], 0.0f);
+
+  SimdMath::sigmoid(in, out, 7);
+  EXPECT_EQ(out[1], 1.0f);
+  EXPECT_EQ(out[2], 0.0f);
+  EXPECT_EQ(out[3], 0.5f);
+
+  SimdMath::erf(in, out, 7);
+  EXPECT_EQ(out[1], 1.0f);
+  EXPECT_EQ(out[2], -1.0f);
+  EXPECT_EQ(out[3], 0.0f);
+}
+
+TEST(test_simd_math, test_exact_tier_matches_std) {
+  std::vector<float> in(1000);
+  std::vector<float> out(1000);
+  for (size_t i = 0; i < in.size(); i++) {
+    in[i] = static_cast<float>(i) / 50.0f - 10.0f;
+  }
+
+  SimdMath::set_accuracy(MathAccuracy::EXACT);
+  SimdMath::tanh(in.data(), out.data(), in.size());
+  SimdMath::set_accuracy(MathAccuracy::FAST);
+
+  for (size_t i = 0; i < in.size(); i++) {
+    ASSERT_EQ(out[i], std::tanh(in[i]));
+  }
+}
+
+TEST(test_simd_math, test_activation_functors_use_tier) {
+  const size_t size = 1001;
+  auto x = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+  for (size_t i = 0; i < size; i++) {
+    (*x)[i] = static_cast<float>(i) / 100.0f - 5.0f;
+  }
+  auto fast = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+  auto exact = std::make_shared<Tensor<float>>(array_mml<size_t>{size});
+
+  auto compare = [&](auto op) {
+    SimdMath::set_accuracy(MathAccuracy::FAST);
+    TensorOperations<float>::elementwise(x, op, fast);
+    SimdMath::set_accuracy(MathAccuracy::EXACT);
+    TensorOperations<float>::elementwise(x, op, exact);
+    for (size_t i = 0; i < size; i++) {
+      ASSERT_NEAR((*fast)[i], (*exact)[i], 1e-6f * (1 + std::fabs((*x)[i])));
+      ASSERT_NEAR((*exact)[i], op((*x)[i]), 1e-6f * (1 + std::fabs((*x)[i])));
+    }
+  };
+
+  compare(SigmoidOp{});
+  compare(TanhOp{});
+  compare(SwishOp{});
+  compare(EluOp{0.5f});
+  compare(GeluOp{});
+  compare(GeluTanhOp{});
+  SimdMath::set_accuracy(MathAccuracy::FAST);
+}
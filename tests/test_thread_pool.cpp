@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <modularml>
+
+TEST(test_thread_pool, test_runs_all_tasks) {
+  ThreadPool pool(4);
+  EXPECT_EQ(pool.get_num_threads(), 4);
+
+  std::atomic<int> sum = 0;
+  std::vector<std::future<void>> futures;
+  for (int i = 1; i <= 100; i++) {
+    futures.push_back(pool.submit([&sum, i] { sum += i; }));
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+  EXPECT_EQ(sum, 5050);
+}
+
+TEST(test_thread_pool, test_propagates_exceptions) {
+  ThreadPool pool(2);
+  auto future =
+      pool.submit([] { throw std::runtime_error("Task failed on purpose"); });
+  EXPECT_THROW(future.get(), std::runtime_error);
+
+  // The pool keeps working after a task has thrown
+  auto next = pool.submit([] {});
+  EXPECT_NO_THROW(next.get());
+
+  EXPECT_THROW(ThreadPool(0), std::invalid_argument);
+}
+
+TEST(test_thread_pool, test_parallel_for_covers_range) {
+  ThreadPool pool(3);
+  std::vector<std::atomic<int>> hits(1000);
+  pool.parallel_for(0, hits.size(), 7, [&](size_t begin, size_t end) {
+    EXPECT_LE(end - begin, hits.size());
+    for (size_t i = begin; i < end; i++) {
+      hits[i]++;
+    }
+  });
+  for (const auto &hit : hits) {
+    EXPECT_EQ(hit, 1);
+  }
+
+  EXPECT_THROW(pool.parallel_for(0, 100, 1,
+                                 [](size_t, size_t) {
+                                   throw std::runtime_error("Chunk failed");
+                                 }),
+               std::runtime_error);
+}
+
+TEST(test_thread_pool, test_nested_parallel_for) {
+  // Every task of the pool waits on a parallel_for on the same pool, which
+  // must not deadlock even when all workers are busy
+  ThreadPool pool(2);
+  std::atomic<int> sum = 0;
+  std::vector<std::future<void>> futures;
+  for (int i = 0; i < 4; i++) {
+    futures.push_back(pool.submit([&] {
+      pool.parallel_for(0, 100, 1, [&](size_t begin, size_t end) {
+        sum += static_cast<int>(end - begin);
+      });
+    }));
+  }
+  for (auto &future : futures) {
+    future.get();
+  }
+  EXPECT_EQ(sum, 400);
+}
+
+TEST(test_thread_pool, test_parallel_config) {
+  size_t num_threads = Parallel::get_num_threads();
+  EXPECT_GE(num_threads, 1);
+
+  Parallel::set_num_threads(4);
+  EXPECT_EQ(Parallel::get_num_threads(), 4);
+
+  std::atomic<size_t> sum = 0;
+  Parallel::parallel_for(0, 10000, 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end; i++) {
+      sum += i;
+    }
+  });
+  EXPECT_EQ(sum, 10000 * 9999 / 2);
+
+  Parallel::set_num_threads(num_threads);
+}
@@ -1,5 +1,7 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+
 #include "nodes/transpose.hpp"
 
 TEST(TransposeNode_test, test_forward) {
@@ -116,3 +118,66 @@ TEST(TransposeNode_test, test_forward_3d) {
     EXPECT_EQ((*expected)[i], (*result_ptr)[i]);
   }
 }
+
+TEST(TransposeNode_test, test_forward_tiled_layouts) {
+  // Odd sizes leave partial tiles along both tiled dimensions
+  array_mml<size_t> shapeA({2, 37, 5, 33});
+  auto A_ptr = std::make_shared<Tensor<float>>(shapeA);
+  for (size_t i = 0; i < A_ptr->get_size(); i++) {
+    (*A_ptr)[i] = static_cast<float>(i);
+  }
+
+  for (const std::vector<int>& perm : std::vector<std::vector<int>>{
+           {0, 2, 3, 1}, {0, 3, 1, 2}, {0, 1, 3, 2}, {3, 2, 1, 0}}) {
+    std::unordered_map<std::string, GeneralDataTypes> iomap;
+    iomap["A"] = A_ptr;
+    TransposeNode node("A", "Y", perm);
+    node.forward(iomap);
+    auto result_ptr = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+
+    // Every output index maps back to the input index through perm
+    const Shape& out_shape = result_ptr->get_shape();
+    Shape out_idx(4);
+    Shape in_idx(4);
+    for (size_t i = 0; i < result_ptr->get_size(); i++) {
+      size_t rest = i;
+      for (size_t dim = 4; dim-- > 0;) {
+        out_idx[dim] = rest % out_shape[dim];
+        rest /= out_shape[dim];
+      }
+      for (size_t dim = 0; dim < 4; dim++) {
+        in_idx[perm[dim]] = out_idx[dim];
+      }
+      ASSERT_EQ((*result_ptr)[i], (*A_ptr)[in_idx]);
+    }
+  }
+}
+
+TEST(TransposeNode_test, test_throughput) {
+  // NCHW -> NHWC of a typical activation, the throughput counts the bytes
+  // read and written
+  auto A_ptr =
+      std::make_shared<Tensor<float>>(array_mml<size_t>({1, 64, 128, 128}));
+  A_ptr->fill(1.0f);
+  std::unordered_map<std::string, GeneralDataTypes> iomap;
+  iomap["A"] = A_ptr;
+  TransposeNode node("A", "Y", {0, 2, 3, 1});
+  node.forward(iomap);
+
+  const int runs = 10;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < runs; i++) {
+    node.forward(iomap);
+  }
+  std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  double bytes = 2.0 * runs * A_ptr->get_size() * sizeof(float);
+  double gb_per_s = bytes / elapsed.count() / 1e9;
+  RecordProperty("GBps", std::to_string(gb_per_s));
+  std::cout << "Transpose NCHW -> NHWC: " << gb_per_s << " GB/s" << std::endl;
+
+  auto result_ptr = std::get<std::shared_ptr<Tensor<float>>>(iomap["Y"]);
+  EXPECT_EQ(result_ptr->get_shape(), array_mml<size_t>({1, 128, 128, 64}));
+  EXPECT_GT(gb_per_s, 0.0);
+}